@@ -23,7 +23,9 @@ uniform vec3 u_cameraPosition;
 #define PI 3.14159265358979323846
 
 vec3 getNormal() {
-    vec3 n = texture(u_normalTex, i_texCoord).xyz * 2.0f - 1.0f;
+    // z is rebuilt from x and y, so two-channel ( BC5 ) normal maps work as well
+    vec2 xy = texture(u_normalTex, i_texCoord).xy * 2.0f - 1.0f;
+    vec3 n  = vec3(xy, sqrt(max(1.0f - dot(xy, xy), 0.0f)));
     return normalize(i_TBN * n);
 }
 
@@ -1,6 +1,8 @@
 #version 460
 
-layout(location = 0) in vec3 a_position;
+// Vertex : float position/normal/UV/weights/tangent
+// CompactVertex : unorm16 position + tangent sign in w, snorm16 octahedral normal/tangent ( in .xy ), unorm8 weights
+layout(location = 0) in vec4 a_position;
 layout(location = 1) in vec3 a_normal;
 layout(location = 2) in vec2 a_texCoord;
 layout(location = 3) in uvec4 a_joints;
@@ -19,7 +21,28 @@ uniform mat4 u_bones[JOINTS_COUNT];
 
 uniform bool u_isAnimated;
 
+uniform bool u_compactVertices;
+uniform vec3 u_positionOffset;
+uniform vec3 u_positionScale;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 v = vec3(e, 1.0f - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0f);
+    v.xy += vec2(v.x >= 0.0f ? -t : t, v.y >= 0.0f ? -t : t);
+    return normalize(v);
+}
+
 void main() {
+    vec3 position = a_position.xyz;
+    vec3 normal   = a_normal;
+    vec4 tangent  = a_tangent;
+
+    if (u_compactVertices) {
+        position = u_positionOffset + a_position.xyz * u_positionScale;
+        normal   = decodeOctahedral(a_normal.xy);
+        tangent  = vec4(decodeOctahedral(a_tangent.xy), a_position.w * 2.0f - 1.0f);
+    }
+
     vec3 T = vec3(0.0f);
     vec3 N = vec3(0.0f);
     vec3 B = vec3(0.0f);
@@ -32,27 +55,27 @@ void main() {
             u_bones[a_joints.z] * a_weights.z +
             u_bones[a_joints.w] * a_weights.w;
 
-        vec4 skinned_position = skin_matrix * vec4(a_position, 1.0f);
+        vec4 skinned_position = skin_matrix * vec4(position, 1.0f);
         world_pos = u_model * skinned_position;
 
         mat3 skin = mat3(skin_matrix);
-        vec3 skinned_normal  = normalize(skin * a_normal);
-        vec3 skinned_tangent = normalize(skin * a_tangent.xyz);
+        vec3 skinned_normal  = normalize(skin * normal);
+        vec3 skinned_tangent = normalize(skin * tangent.xyz);
 
         mat3 normal_matrix = transpose(inverse(mat3(u_model)));
 
         T = normalize(normal_matrix * skinned_tangent.xyz);
         N = normalize(normal_matrix * skinned_normal);
-        B = normalize(cross(N, T) * a_tangent.w);
+        B = normalize(cross(N, T) * tangent.w);
     }
     else {
-        world_pos = u_model * vec4(a_position, 1.0f);
+        world_pos = u_model * vec4(position, 1.0f);
 
         mat3 normal_matrix = transpose(inverse(mat3(u_model)));
 
-        N = normalize(normal_matrix * a_normal);
-        T = normalize(normal_matrix * a_tangent.xyz);
-        B = normalize(cross(N, T) * a_tangent.w);
+        N = normalize(normal_matrix * normal);
+        T = normalize(normal_matrix * tangent.xyz);
+        B = normalize(cross(N, T) * tangent.w);
     }
 
     i_TBN = mat3(T, B, N);
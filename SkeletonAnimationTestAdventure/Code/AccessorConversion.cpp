@@ -0,0 +1,185 @@
+#include "AccessorConversion.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "tiny_gltf.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ACCESSOR_CONVERSION_SSE41 1
+#include <smmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SSE41_TARGET
+#else
+#define SSE41_TARGET __attribute__((target("sse4.1")))
+#endif
+#else
+#define ACCESSOR_CONVERSION_SSE41 0
+#endif
+
+// glTF 2.0 normalization : unsigned c / max, signed max(c / max, -1)
+template <typename T>
+inline constexpr float NORMALIZE_DIVISOR = static_cast<float>(std::numeric_limits<T>::max());
+
+// scalar fallback, also the reference for the SIMD kernels
+template <typename T, int N, bool NORMALIZED>
+static void convertScalar(const uint8_t* src, size_t stride, size_t count, glm::vec4* dst) {
+    for (size_t i = 0; i < count; i++) {
+        T components[N]{};
+        memcpy(components, src + (i * stride), sizeof(components));
+
+        glm::vec4 v(0.0F);
+        for (int c = 0; c < N; c++) {
+            v[c] = static_cast<float>(components[c]);
+            if constexpr (NORMALIZED && !std::is_same_v<T, float>) {
+                v[c] /= NORMALIZE_DIVISOR<T>;
+                if constexpr (std::is_signed_v<T>) {
+                    v[c] = std::max(v[c], -1.0F);
+                }
+            }
+        }
+        dst[i] = v;
+    }
+}
+
+// tightly packed float vec4 is already the output layout
+static void convertCopyVec4(const uint8_t* src, size_t /*unused*/, size_t count, glm::vec4* dst) {
+    memcpy(dst, src, count * sizeof(glm::vec4));
+}
+
+#if ACCESSOR_CONVERSION_SSE41
+
+// loads COMPONENTS components of T into the low lanes and converts them to float
+template <typename T, int COMPONENTS>
+SSE41_TARGET static inline __m128 loadSse41(const uint8_t* element) {
+    if constexpr (std::is_same_v<T, float>) {
+        if constexpr (COMPONENTS == 4) {
+            return _mm_loadu_ps(reinterpret_cast<const float*>(element));
+        }
+        else {
+            alignas(16) float f[4]{};
+            memcpy(f, element, COMPONENTS * sizeof(float));
+            return _mm_load_ps(f);
+        }
+    }
+    else if constexpr (sizeof(T) == 1) {
+        uint32_t packed{};
+        memcpy(&packed, element, COMPONENTS * sizeof(T));
+        __m128i bytes = _mm_cvtsi32_si128(static_cast<int>(packed));
+        return _mm_cvtepi32_ps(std::is_signed_v<T> ? _mm_cvtepi8_epi32(bytes) : _mm_cvtepu8_epi32(bytes));
+    }
+    else {
+        uint64_t packed{};
+        memcpy(&packed, element, COMPONENTS * sizeof(T));
+        __m128i shorts = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&packed));
+        return _mm_cvtepi32_ps(std::is_signed_v<T> ? _mm_cvtepi16_epi32(shorts) : _mm_cvtepu16_epi32(shorts));
+    }
+}
+
+// scales normalized values and zeroes the lanes past N
+template <typename T, int N, bool NORMALIZED>
+SSE41_TARGET static inline __m128 finishSse41(__m128 v) {
+    if constexpr (NORMALIZED && !std::is_same_v<T, float>) {
+        v = _mm_div_ps(v, _mm_set1_ps(NORMALIZE_DIVISOR<T>)); // division, not a reciprocal multiply : bit-exact with the scalar path
+        if constexpr (std::is_signed_v<T>) {
+            v = _mm_max_ps(v, _mm_set1_ps(-1.0F));
+        }
+    }
+    if constexpr (N < 4) {
+        v = _mm_blend_ps(_mm_setzero_ps(), v, (1 << N) - 1);
+    }
+    return v;
+}
+
+// one element per iteration : load, widen to int32, convert, finish
+// elements whose full 4-component load stays inside the accessor take the fixed-size load,
+// the last few ones copy exactly N components, so nothing is read past the buffer
+template <typename T, int N, bool NORMALIZED>
+SSE41_TARGET static void convertSse41(const uint8_t* src, size_t stride, size_t count, glm::vec4* dst) {
+    size_t over_read  = (4 - N) * sizeof(T);
+    size_t tail_count = over_read == 0 ? 0 : (stride == 0 ? count : (over_read + stride - 1) / stride);
+    size_t safe_count = count > tail_count ? count - tail_count : 0;
+
+    size_t i = 0;
+    for (; i < safe_count; i++) {
+        _mm_storeu_ps(&dst[i].x, finishSse41<T, N, NORMALIZED>(loadSse41<T, 4>(src + (i * stride))));
+    }
+    for (; i < count; i++) {
+        _mm_storeu_ps(&dst[i].x, finishSse41<T, N, NORMALIZED>(loadSse41<T, N>(src + (i * stride))));
+    }
+}
+
+static bool detectSse41() {
+#ifdef _MSC_VER
+    int info[4]{};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+#endif
+
+bool hasSse41Converters() {
+#if ACCESSOR_CONVERSION_SSE41
+    static const bool has_sse41 = detectSse41();
+    return has_sse41;
+#else
+    return false;
+#endif
+}
+
+template <typename T, int N, bool NORMALIZED>
+static Vec4ConvertFunction selectKernel() {
+#if ACCESSOR_CONVERSION_SSE41
+    if (hasSse41Converters()) {
+        return &convertSse41<T, N, NORMALIZED>;
+    }
+#endif
+    return &convertScalar<T, N, NORMALIZED>;
+}
+
+template <typename T, bool NORMALIZED>
+static Vec4ConvertFunction selectByComponents(int num_components) {
+    switch (num_components) {
+        case 1:
+            return selectKernel<T, 1, NORMALIZED>();
+        case 2:
+            return selectKernel<T, 2, NORMALIZED>();
+        case 3:
+            return selectKernel<T, 3, NORMALIZED>();
+        case 4:
+            return selectKernel<T, 4, NORMALIZED>();
+        default:
+            return nullptr;
+    }
+}
+
+template <typename T>
+static Vec4ConvertFunction selectByNormalized(bool normalized, int num_components) {
+    return normalized ? selectByComponents<T, true>(num_components) : selectByComponents<T, false>(num_components);
+}
+
+Vec4ConvertFunction selectVec4Converter(int component_type, bool normalized, int num_components, size_t stride) {
+    switch (component_type) {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT:
+            if (num_components == 4 && stride == sizeof(glm::vec4)) {
+                return &convertCopyVec4;
+            }
+            return selectByComponents<float, false>(num_components); // normalized has no meaning for floats
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            return selectByNormalized<uint16_t>(normalized, num_components);
+        case TINYGLTF_COMPONENT_TYPE_SHORT:
+            return selectByNormalized<int16_t>(normalized, num_components);
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            return selectByNormalized<uint8_t>(normalized, num_components);
+        case TINYGLTF_COMPONENT_TYPE_BYTE:
+            return selectByNormalized<int8_t>(normalized, num_components);
+        default:
+            return nullptr;
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// converts count elements of an accessor into vec4 ( missing components are 0 )
+// src points to the first element, elements are stride bytes apart
+using Vec4ConvertFunction = void (*)(const uint8_t* src, size_t stride, size_t count, glm::vec4* dst);
+
+// picks the conversion kernel once per accessor : SSE4.1 when the CPU has it, scalar otherwise
+// component_type is a TINYGLTF_COMPONENT_TYPE_* value. nullptr if the combination is not supported
+Vec4ConvertFunction selectVec4Converter(int component_type, bool normalized, int num_components, size_t stride);
+
+// true if the SSE4.1 kernels are used on this CPU
+bool hasSse41Converters();
@@ -0,0 +1,149 @@
+#include "AccessorConversionBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <format>
+
+#include "AccessorConversion.hpp"
+#include "tiny_gltf.h"
+
+// the conversion readAccessorVec4 did before the kernels : a switch for every component
+static float readComponentAsFloat(const uint8_t* data, int component_type, bool normalized) {
+    switch (component_type) {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT: {
+            float v{};
+            memcpy(&v, data, sizeof(float));
+            return v;
+        }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+            uint16_t v{};
+            memcpy(&v, data, sizeof(uint16_t));
+            return normalized ? static_cast<float>(v) / 65535.0F : static_cast<float>(v);
+        }
+        case TINYGLTF_COMPONENT_TYPE_SHORT: {
+            int16_t v{};
+            memcpy(&v, data, sizeof(int16_t));
+            return normalized ? glm::clamp(static_cast<float>(v) / 32767.0F, -1.0F, 1.0F) : static_cast<float>(v);
+        }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            return normalized ? static_cast<float>(*data) / 255.0F : static_cast<float>(*data);
+        case TINYGLTF_COMPONENT_TYPE_BYTE: {
+            auto v = static_cast<int8_t>(*data);
+            return normalized ? glm::clamp(static_cast<float>(v) / 127.0F, -1.0F, 1.0F) : static_cast<float>(v);
+        }
+        default:
+            return 0.0F;
+    }
+}
+
+static void convertReference(const uint8_t* src, size_t stride, size_t count, int component_type, bool normalized, int num_components, glm::vec4* dst) {
+    auto component_size = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(component_type));
+    for (size_t i = 0; i < count; i++) {
+        glm::vec4      v(0.0F);
+        const uint8_t* element = src + (i * stride);
+        for (int component = 0; component < num_components; component++) {
+            v[component] = readComponentAsFloat(element + (component * component_size), component_type, normalized);
+        }
+        dst[i] = v;
+    }
+}
+
+// fastest of repeats runs, in milliseconds
+template <typename Function>
+static double timeFastest(int repeats, Function&& function) {
+    double best = 0.0;
+    for (int run = 0; run < repeats; run++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best      = run == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+std::vector<Vec4ConverterBenchmark> AccessorConversionBenchmark::Run(size_t count, int repeats) {
+    std::vector<Vec4ConverterBenchmark> results{};
+    std::vector<glm::vec4>              reference(count);
+    std::vector<glm::vec4>              converted(count);
+    std::vector<uint8_t>                source{};
+    repeats = std::max(repeats, 1);
+
+    constexpr int    COMPONENT_TYPES[]  = { TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_COMPONENT_TYPE_SHORT, TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_COMPONENT_TYPE_BYTE };
+    constexpr size_t INTERLEAVED_STRIDE = 48; // a position + normal + uv + tangent vertex
+
+    for (int component_type : COMPONENT_TYPES) {
+        auto component_size = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(component_type));
+        for (bool normalized : { false, true }) {
+            if (normalized && component_type == TINYGLTF_COMPONENT_TYPE_FLOAT) {
+                continue; // no meaning for floats
+            }
+            for (int num_components = 1; num_components <= 4; num_components++) {
+                for (size_t stride : { component_size * num_components, INTERLEAVED_STRIDE }) {
+                    // deterministic data, floats are finite so the outputs compare bit by bit
+                    source.assign((count * stride) + 16, 0);
+                    uint32_t state = 0x9E3779B9U;
+                    for (size_t i = 0; i < source.size(); i += component_size) {
+                        state = (state * 1664525U) + 1013904223U;
+                        if (component_type == TINYGLTF_COMPONENT_TYPE_FLOAT && i + sizeof(float) <= source.size()) {
+                            float value = static_cast<float>(state >> 8) / 65536.0F - 128.0F;
+                            memcpy(source.data() + i, &value, sizeof(float));
+                        }
+                        else {
+                            memcpy(source.data() + i, &state, std::min(component_size, source.size() - i));
+                        }
+                    }
+
+                    Vec4ConvertFunction kernel = selectVec4Converter(component_type, normalized, num_components, stride);
+                    if (kernel == nullptr) {
+                        continue;
+                    }
+
+                    Vec4ConverterBenchmark& result = results.emplace_back();
+                    result.component_type          = component_type;
+                    result.normalized              = normalized;
+                    result.num_components          = num_components;
+                    result.stride                  = stride;
+                    result.reference_ms            = timeFastest(repeats, [&]() { convertReference(source.data(), stride, count, component_type, normalized, num_components, reference.data()); });
+                    result.kernel_ms               = timeFastest(repeats, [&]() { kernel(source.data(), stride, count, converted.data()); });
+                    result.identical               = memcmp(reference.data(), converted.data(), count * sizeof(glm::vec4)) == 0;
+                }
+            }
+        }
+    }
+    return results;
+}
+
+static const char* getComponentTypeName(int component_type) {
+    switch (component_type) {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT:
+            return "f32";
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            return "u16";
+        case TINYGLTF_COMPONENT_TYPE_SHORT:
+            return "s16";
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            return "u8";
+        case TINYGLTF_COMPONENT_TYPE_BYTE:
+            return "s8";
+        default:
+            return "?";
+    }
+}
+
+std::string AccessorConversionBenchmark::getSummary(std::span<const Vec4ConverterBenchmark> results) {
+    std::string summary = std::format("{} kernels\n", hasSse41Converters() ? "SSE4.1" : "scalar");
+    summary += std::format("{:>5} {:>5} {:>10} {:>6} {:>10} {:>10} {:>8} {:>9}\n", "type", "width", "normalized", "stride", "before ms", "after ms", "speedup", "identical");
+    for (const auto& result : results) {
+        summary += std::format("{:>5} {:>5} {:>10} {:>6} {:>10.3f} {:>10.3f} {:>7.2f}x {:>9}\n",
+                               getComponentTypeName(result.component_type),
+                               result.num_components,
+                               result.normalized ? "yes" : "no",
+                               result.stride,
+                               result.reference_ms,
+                               result.kernel_ms,
+                               result.reference_ms / std::max(result.kernel_ms, 1e-6),
+                               result.identical ? "yes" : "NO");
+    }
+    return summary;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+// one accessor layout timed through selectVec4Converter() against the per-component path it replaced
+struct Vec4ConverterBenchmark {
+    int    component_type{ 0 }; // TINYGLTF_COMPONENT_TYPE_*
+    bool   normalized{ false };
+    int    num_components{ 0 };
+    size_t stride{ 0 }; // bytes between elements
+
+    double reference_ms{ 0 };  // per-component switch, one call per component
+    double kernel_ms{ 0 };     // the selected kernel
+    bool   identical{ false }; // bit-exact output
+
+    Vec4ConverterBenchmark()  = default;
+    ~Vec4ConverterBenchmark() = default;
+};
+
+// headless micro-benchmark of the accessor conversion kernels, no window or file needed
+//
+//  auto results = AccessorConversionBenchmark::Run();
+//  std::print("{}", AccessorConversionBenchmark::getSummary(results));
+class AccessorConversionBenchmark {
+public:
+    // every supported type, normalization and width, tightly packed and interleaved
+    // count elements per layout, the fastest of repeats runs counts
+    static std::vector<Vec4ConverterBenchmark> Run(size_t count = size_t{ 1 } << 20, int repeats = 5);
+
+    // one line per layout : type, width, stride, ms before / after, speedup, bit-exact
+    static std::string getSummary(std::span<const Vec4ConverterBenchmark> results);
+};
@@ -0,0 +1,236 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "tiny_gltf.h"
+#include "AccessorConversion.hpp"
+
+// component type and count of what an accessor element is read as
+template <typename T>
+struct AccessorElement {
+    static_assert(std::is_arithmetic_v<T>, "Unsupported accessor element type");
+    using Component                 = T;
+    static constexpr int COMPONENTS = 1;
+};
+
+template <glm::length_t L, typename V, glm::qualifier Q>
+struct AccessorElement<glm::vec<L, V, Q>> {
+    using Component                 = V;
+    static constexpr int COMPONENTS = L;
+};
+
+template <glm::length_t C, glm::length_t R, typename V, glm::qualifier Q>
+struct AccessorElement<glm::mat<C, R, V, Q>> {
+    using Component                 = V;
+    static constexpr int COMPONENTS = C * R; // column-major, same as glTF
+};
+
+// typed, strided view of a glTF accessor straight over the buffer bytes, nothing is copied on construction
+// every component type is converted on read : integer -> float follows the glTF normalized rules,
+// missing components are 0, extra ones are dropped ( u8 JOINTS_0 -> u16vec4, normalized u16 WEIGHTS_0 -> vec4 ... )
+template <typename T>
+class AccessorView {
+public:
+    using Component                 = typename AccessorElement<T>::Component;
+    static constexpr int COMPONENTS = AccessorElement<T>::COMPONENTS;
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+
+        Iterator(const AccessorView* view, size_t index) : m_view(view), m_index(index) {}
+
+        T         operator*() const { return (*m_view)[m_index]; }
+        Iterator& operator++() {
+            m_index++;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        const AccessorView* m_view;
+        size_t              m_index;
+    };
+
+public:
+    AccessorView() = default;
+    AccessorView(const uint8_t* data, size_t count, size_t stride, int component_type, bool normalized, int num_components)
+        : m_data(data), m_count(count), m_stride(stride), m_componentType(component_type), m_normalized(normalized), m_numComponents(num_components) {
+        m_read = AccessorView::selectRead(component_type, normalized, num_components);
+        if (m_read == nullptr) {
+            m_count = 0;
+        }
+    }
+    ~AccessorView() = default;
+
+    inline size_t size() const noexcept { return m_count; }
+    inline bool   empty() const noexcept { return m_count == 0; }
+
+    T operator[](size_t index) const { return m_read(m_data + (index * m_stride)); }
+
+    Iterator begin() const { return { this, 0 }; }
+    Iterator end() const { return { this, m_count }; }
+
+    // the first count elements ( or all of them if there are fewer )
+    AccessorView first(size_t count) const {
+        AccessorView view = *this;
+        view.m_count      = std::min(count, m_count);
+        return view;
+    }
+
+    // bulk conversion, dst_stride lets it write straight into an interleaved vertex
+    void copyTo(T* dst, size_t dst_stride = sizeof(T)) const {
+        if (m_count == 0) {
+            return;
+        }
+
+        bool same_layout = m_componentType == AccessorView::componentType() && m_numComponents == COMPONENTS && !m_normalized;
+
+        if (same_layout && m_stride == sizeof(T) && dst_stride == sizeof(T)) {
+            memcpy(dst, m_data, m_count * sizeof(T));
+            return;
+        }
+
+        if constexpr (std::is_same_v<T, glm::vec4>) {
+            if (dst_stride == sizeof(T)) {
+                Vec4ConvertFunction convert = selectVec4Converter(m_componentType, m_normalized, m_numComponents, m_stride);
+                if (convert != nullptr) {
+                    convert(m_data, m_stride, m_count, dst);
+                    return;
+                }
+            }
+        }
+
+        auto* out = reinterpret_cast<uint8_t*>(dst);
+        for (size_t i = 0; i < m_count; i++) {
+            T value = m_read(m_data + (i * m_stride));
+            memcpy(out + (i * dst_stride), &value, sizeof(T)); // dst may be unaligned ( packed Vertex )
+        }
+    }
+
+    void copyTo(std::vector<T>& out) const {
+        out.resize(m_count);
+        this->copyTo(out.data());
+    }
+
+private:
+    using ReadFunction = T (*)(const uint8_t*);
+
+    // TINYGLTF_COMPONENT_TYPE_* with the same layout as Component, -1 if there is none
+    static constexpr int componentType() {
+        if constexpr (std::is_same_v<Component, float>) {
+            return TINYGLTF_COMPONENT_TYPE_FLOAT;
+        }
+        else if constexpr (std::is_same_v<Component, uint32_t>) {
+            return TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+        }
+        else if constexpr (std::is_same_v<Component, uint16_t>) {
+            return TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+        }
+        else if constexpr (std::is_same_v<Component, int16_t>) {
+            return TINYGLTF_COMPONENT_TYPE_SHORT;
+        }
+        else if constexpr (std::is_same_v<Component, uint8_t>) {
+            return TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+        }
+        else if constexpr (std::is_same_v<Component, int8_t>) {
+            return TINYGLTF_COMPONENT_TYPE_BYTE;
+        }
+        else {
+            return -1;
+        }
+    }
+
+    template <typename Source, bool NORMALIZED>
+    static Component convertComponent(Source value) {
+        if constexpr (std::is_floating_point_v<Component> && NORMALIZED && std::is_integral_v<Source>) {
+            auto result = static_cast<Component>(value) / static_cast<Component>(std::numeric_limits<Source>::max());
+            if constexpr (std::is_signed_v<Source>) {
+                result = std::max(result, static_cast<Component>(-1));
+            }
+            return result;
+        }
+        else {
+            return static_cast<Component>(value);
+        }
+    }
+
+    template <typename Source, bool NORMALIZED, int N>
+    static T readElement(const uint8_t* element) {
+        Source source[N]{};
+        memcpy(source, element, sizeof(source));
+
+        Component components[COMPONENTS]{};
+        for (int c = 0; c < N && c < COMPONENTS; c++) {
+            components[c] = AccessorView::convertComponent<Source, NORMALIZED>(source[c]);
+        }
+
+        T value{};
+        memcpy(&value, components, sizeof(T));
+        return value;
+    }
+
+    template <typename Source, bool NORMALIZED>
+    static ReadFunction selectByComponents(int num_components) {
+        switch (num_components) {
+            case 1:
+                return &AccessorView::readElement<Source, NORMALIZED, 1>;
+            case 2:
+                return &AccessorView::readElement<Source, NORMALIZED, 2>;
+            case 3:
+                return &AccessorView::readElement<Source, NORMALIZED, 3>;
+            case 4:
+                return &AccessorView::readElement<Source, NORMALIZED, 4>;
+            case 9:
+                return &AccessorView::readElement<Source, NORMALIZED, 9>;
+            case 16:
+                return &AccessorView::readElement<Source, NORMALIZED, 16>;
+            default:
+                return nullptr;
+        }
+    }
+
+    template <typename Source>
+    static ReadFunction selectByNormalized(bool normalized, int num_components) {
+        return normalized ? AccessorView::selectByComponents<Source, true>(num_components) : AccessorView::selectByComponents<Source, false>(num_components);
+    }
+
+    static ReadFunction selectRead(int component_type, bool normalized, int num_components) {
+        switch (component_type) {
+            case TINYGLTF_COMPONENT_TYPE_FLOAT:
+                return AccessorView::selectByComponents<float, false>(num_components);
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                return AccessorView::selectByNormalized<uint32_t>(normalized, num_components);
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                return AccessorView::selectByNormalized<uint16_t>(normalized, num_components);
+            case TINYGLTF_COMPONENT_TYPE_SHORT:
+                return AccessorView::selectByNormalized<int16_t>(normalized, num_components);
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                return AccessorView::selectByNormalized<uint8_t>(normalized, num_components);
+            case TINYGLTF_COMPONENT_TYPE_BYTE:
+                return AccessorView::selectByNormalized<int8_t>(normalized, num_components);
+            default:
+                return nullptr;
+        }
+    }
+
+private:
+    const uint8_t* m_data{ nullptr };
+    size_t         m_count{ 0 };
+    size_t         m_stride{ 0 };
+    int            m_componentType{ -1 };
+    bool           m_normalized{ false };
+    int            m_numComponents{ 0 };
+    ReadFunction   m_read{ nullptr };
+};
@@ -0,0 +1,77 @@
+#include "AssetCache.hpp"
+
+#include <charconv>
+
+#include "ModelCache.hpp"
+
+bool AssetCache::Find(Model& model, const std::filesystem::path& path, const ModelLoadOptions& options) {
+    std::string     key = AssetCache::getKey(path, options);
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return false;
+    }
+
+    std::shared_ptr<ModelAsset> asset = it->second.lock();
+    if (asset == nullptr) { // every model and instance using it is gone
+        m_entries.erase(it);
+        return false;
+    }
+
+    model.m_asset          = std::move(asset);
+    model.m_loadStatistics = {};
+    model.m_name           = path.filename().string();
+    model.m_releaseCpuData = options.release_cpu_data;
+    model.m_reportMemory   = options.report_memory;
+    m_hits++;
+    return true;
+}
+
+void AssetCache::Publish(Model& model, const std::filesystem::path& path, const ModelLoadOptions& options) {
+    std::string     key = AssetCache::getKey(path, options);
+    std::lock_guard lock(m_mutex);
+
+    std::erase_if(m_entries, [](const auto& entry) { return entry.second.expired(); });
+    m_loads++;
+
+    std::weak_ptr<ModelAsset>& entry = m_entries[key];
+    if (std::shared_ptr<ModelAsset> asset = entry.lock()) { // same file, same options : same asset
+        model.m_asset = std::move(asset);
+        return;
+    }
+    entry = model.m_asset;
+}
+
+void AssetCache::Clear() {
+    std::lock_guard lock(m_mutex);
+    m_entries.clear();
+}
+
+AssetCacheStatistics AssetCache::getStatistics() const {
+    std::lock_guard lock(m_mutex);
+
+    AssetCacheStatistics statistics{};
+    statistics.hits  = m_hits;
+    statistics.loads = m_loads;
+    for (const auto& [key, entry] : m_entries) {
+        statistics.entries += entry.expired() ? 0 : 1;
+    }
+    return statistics;
+}
+
+AssetCache& AssetCache::getGlobal() {
+    static AssetCache cache{};
+    return cache;
+}
+
+std::string AssetCache::getKey(const std::filesystem::path& path, const ModelLoadOptions& options) {
+    std::error_code error{};
+    auto            canonical = std::filesystem::weakly_canonical(path, error);
+    std::string     key       = (error ? path : canonical).generic_string();
+
+    char hash[17]{};
+    std::to_chars(hash, hash + 16, ModelCache::hashOptions(options), 16);
+    // not part of the baked data, but a model keeping its CPU copies must not share an asset another one empties
+    return key + '|' + hash + (options.release_cpu_data ? "|released" : "");
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Model.hpp"
+
+struct AssetCacheStatistics {
+    size_t hits{ 0 };    // Initialize() calls served from an entry, nothing parsed or decoded
+    size_t loads{ 0 };   // Initialize() calls that loaded the file and published it
+    size_t entries{ 0 }; // entries whose asset is still in use
+
+    AssetCacheStatistics()  = default;
+    ~AssetCacheStatistics() = default;
+};
+
+// Process-wide table of the models loaded with ModelLoadOptions::share_assets, so loading the same file again shares
+// its ModelAsset instead of parsing, decoding and uploading it again
+// Entries are keyed by canonical path and ModelCache::hashOptions. The asset is held weakly : it lives as long as a model
+// or an instance uses it, the next load after that parses again
+class AssetCache {
+public:
+    AssetCache()  = default;
+    ~AssetCache() = default;
+
+    // false if there is no live entry for the file. The model is left untouched then
+    bool Find(Model& model, const std::filesystem::path& path, const ModelLoadOptions& options);
+    // makes the freshly loaded model the entry of its file
+    // if another thread published the same file in the meantime, the model switches to that entry's asset and drops its own
+    void Publish(Model& model, const std::filesystem::path& path, const ModelLoadOptions& options);
+
+    void Clear(); // forgets every entry, the models keep their assets
+
+    [[nodiscard]] AssetCacheStatistics getStatistics() const;
+
+    // process-wide cache, Model::Initialize uses it
+    static AssetCache& getGlobal();
+
+    AssetCache(const AssetCache&)            = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+private:
+    static std::string getKey(const std::filesystem::path& path, const ModelLoadOptions& options);
+
+private:
+    mutable std::mutex                                         m_mutex;
+    std::unordered_map<std::string, std::weak_ptr<ModelAsset>> m_entries;
+    size_t                                                     m_hits{ 0 };
+    size_t                                                     m_loads{ 0 };
+};
@@ -9,7 +9,8 @@ void Camera::UpdateMatrix(float fov_deg, float near_plane, float far_plane) {
     view       = glm::lookAt(m_position, m_position + m_orientation, m_up);
     projection = glm::perspective(glm::radians(fov_deg), (float) m_width / m_height, near_plane, far_plane);
 
-    m_cameraMatrix = projection * view;
+    m_cameraMatrix    = projection * view;
+    m_projectionScale = static_cast<float>(m_height) / (2.0F * std::tan(glm::radians(fov_deg) * 0.5F));
 }
 
 void Camera::UploadUniforms(Shader& shader, const char* uniform) {
@@ -12,6 +12,9 @@ public:
     void UploadUniforms(Shader& shader, const char* uniform);
 
     [[nodiscard]] const glm::vec3& getPosition() const noexcept { return m_position; }
+    [[nodiscard]] const glm::mat4& getMatrix() const noexcept { return m_cameraMatrix; } // projection * view
+    [[nodiscard]] int              getHeight() const noexcept { return m_height; }
+    [[nodiscard]] float            getProjectionScale() const noexcept { return m_projectionScale; } // pixels per unit at distance 1
 
 private:
     glm::vec3 m_position{};
@@ -19,6 +22,8 @@ private:
     glm::vec3 m_up           = glm::vec3(0.0F, 1.0F, 0.0F);
     glm::mat4 m_cameraMatrix = glm::mat4(1.0F);
 
+    float m_projectionScale = 1.0F;
+
     bool m_firstClick = true;
 
     int m_width  = 0;
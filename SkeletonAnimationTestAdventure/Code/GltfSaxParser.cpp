@@ -0,0 +1,1017 @@
+#include "GltfSaxParser.hpp"
+
+#include <utility>
+
+#include "json.hpp"
+
+// what the innermost open JSON object / array is being read into
+enum class SaxScope : uint8_t {
+    DOCUMENT,      // nothing open yet
+    SKIP,          // member nothing reads, skipped with everything below it
+    VALUE,         // extras / extension content, built as tinygltf::Value
+    EXTENSIONS,    // tinygltf::ExtensionMap
+    ATTRIBUTES,    // std::map<std::string, int>
+    OBJECT_ARRAY,  // std::vector of the element scope's type
+    NUMBER_ARRAY,  // std::vector<double>
+    INTEGER_ARRAY, // std::vector<int>
+    STRING_ARRAY,  // std::vector<std::string>
+    ROOT,
+    ASSET,
+    SCENE,
+    NODE,
+    MESH,
+    PRIMITIVE,
+    ACCESSOR,
+    SPARSE,
+    SPARSE_INDICES,
+    SPARSE_VALUES,
+    BUFFER_VIEW,
+    BUFFER,
+    MATERIAL,
+    PBR,
+    TEXTURE_INFO,
+    NORMAL_TEXTURE_INFO,
+    OCCLUSION_TEXTURE_INFO,
+    TEXTURE,
+    IMAGE,
+    SAMPLER,
+    SKIN,
+    ANIMATION,
+    CHANNEL,
+    CHANNEL_TARGET,
+    ANIMATION_SAMPLER,
+};
+
+struct SaxFrame {
+    SaxScope    scope{ SaxScope::DOCUMENT };
+    SaxScope    element{ SaxScope::DOCUMENT }; // OBJECT_ARRAY : scope of its elements
+    void*       target{ nullptr };             // what the scope fills
+    std::string key;                           // member being read
+    size_t      depth{ 0 };                    // SKIP : objects / arrays open below it
+};
+
+struct SaxNumber {
+    double  real{ 0.0 };
+    int64_t integer{ 0 };
+    bool    is_integer{ false }; // tinygltf reads integer properties from JSON integers only
+};
+
+using SparseIndices = decltype(tinygltf::Accessor::Sparse::indices);
+using SparseValues  = decltype(tinygltf::Accessor::Sparse::values);
+
+template <typename T>
+static T& getTarget(const SaxFrame& frame) {
+    return *static_cast<T*>(frame.target);
+}
+
+static void readInteger(int& value, const SaxNumber& number) {
+    if (number.is_integer) {
+        value = static_cast<int>(number.integer);
+    }
+}
+
+static void readUnsigned(size_t& value, const SaxNumber& number) {
+    if (number.is_integer && number.integer >= 0) {
+        value = static_cast<size_t>(number.integer);
+    }
+}
+
+template <typename TextureInfo>
+static void readTextureInfo(TextureInfo& info, const std::string& key, const SaxNumber& number) {
+    if (key == "index") {
+        readInteger(info.index, number);
+    }
+    else if (key == "texCoord") {
+        readInteger(info.texCoord, number);
+    }
+}
+
+static int getAccessorType(const std::string& type) {
+    if (type == "SCALAR") return TINYGLTF_TYPE_SCALAR;
+    if (type == "VEC2") return TINYGLTF_TYPE_VEC2;
+    if (type == "VEC3") return TINYGLTF_TYPE_VEC3;
+    if (type == "VEC4") return TINYGLTF_TYPE_VEC4;
+    if (type == "MAT2") return TINYGLTF_TYPE_MAT2;
+    if (type == "MAT3") return TINYGLTF_TYPE_MAT3;
+    if (type == "MAT4") return TINYGLTF_TYPE_MAT4;
+    return -1;
+}
+
+// calls function with the glTF object a frame fills, false for the scopes that are not one
+template <typename Function>
+static bool visitObject(const SaxFrame& frame, Function&& function) {
+    switch (frame.scope) {
+        case SaxScope::ROOT:                   function(getTarget<tinygltf::Model>(frame)); return true;
+        case SaxScope::ASSET:                  function(getTarget<tinygltf::Asset>(frame)); return true;
+        case SaxScope::SCENE:                  function(getTarget<tinygltf::Scene>(frame)); return true;
+        case SaxScope::NODE:                   function(getTarget<tinygltf::Node>(frame)); return true;
+        case SaxScope::MESH:                   function(getTarget<tinygltf::Mesh>(frame)); return true;
+        case SaxScope::PRIMITIVE:              function(getTarget<tinygltf::Primitive>(frame)); return true;
+        case SaxScope::ACCESSOR:               function(getTarget<tinygltf::Accessor>(frame)); return true;
+        case SaxScope::SPARSE:                 function(getTarget<tinygltf::Accessor::Sparse>(frame)); return true;
+        case SaxScope::SPARSE_INDICES:         function(getTarget<SparseIndices>(frame)); return true;
+        case SaxScope::SPARSE_VALUES:          function(getTarget<SparseValues>(frame)); return true;
+        case SaxScope::BUFFER_VIEW:            function(getTarget<tinygltf::BufferView>(frame)); return true;
+        case SaxScope::BUFFER:                 function(getTarget<tinygltf::Buffer>(frame)); return true;
+        case SaxScope::MATERIAL:               function(getTarget<tinygltf::Material>(frame)); return true;
+        case SaxScope::PBR:                    function(getTarget<tinygltf::PbrMetallicRoughness>(frame)); return true;
+        case SaxScope::TEXTURE_INFO:           function(getTarget<tinygltf::TextureInfo>(frame)); return true;
+        case SaxScope::NORMAL_TEXTURE_INFO:    function(getTarget<tinygltf::NormalTextureInfo>(frame)); return true;
+        case SaxScope::OCCLUSION_TEXTURE_INFO: function(getTarget<tinygltf::OcclusionTextureInfo>(frame)); return true;
+        case SaxScope::TEXTURE:                function(getTarget<tinygltf::Texture>(frame)); return true;
+        case SaxScope::IMAGE:                  function(getTarget<tinygltf::Image>(frame)); return true;
+        case SaxScope::SAMPLER:                function(getTarget<tinygltf::Sampler>(frame)); return true;
+        case SaxScope::SKIN:                   function(getTarget<tinygltf::Skin>(frame)); return true;
+        case SaxScope::ANIMATION:              function(getTarget<tinygltf::Animation>(frame)); return true;
+        case SaxScope::CHANNEL:                function(getTarget<tinygltf::AnimationChannel>(frame)); return true;
+        case SaxScope::ANIMATION_SAMPLER:      function(getTarget<tinygltf::AnimationSampler>(frame)); return true;
+        default:                               return false;
+    }
+}
+
+static tinygltf::Value* getExtras(const SaxFrame& frame) {
+    if (frame.scope == SaxScope::CHANNEL_TARGET) {
+        return &getTarget<tinygltf::AnimationChannel>(frame).target_extras;
+    }
+    tinygltf::Value* extras = nullptr;
+    visitObject(frame, [&extras](auto& object) { extras = &object.extras; });
+    return extras;
+}
+
+static tinygltf::ExtensionMap* getExtensions(const SaxFrame& frame) {
+    if (frame.scope == SaxScope::CHANNEL_TARGET) {
+        return &getTarget<tinygltf::AnimationChannel>(frame).target_extensions;
+    }
+    tinygltf::ExtensionMap* extensions = nullptr;
+    visitObject(frame, [&extensions](auto& object) { extensions = &object.extensions; });
+    return extensions;
+}
+
+// index referenced by an extension of a node / material, e.g. KHR_lights_punctual { "light" : 0 }
+static bool readExtensionIndex(const tinygltf::ExtensionMap& extensions, const char* extension, const char* member, int& index, std::string* error) {
+    auto it = extensions.find(extension);
+    if (it == extensions.end()) {
+        return true;
+    }
+    if (!it->second.Has(member)) {
+        *error += std::string("Extension ") + extension + " does not have its \"" + member + "\" member\n";
+        return false;
+    }
+    index = it->second.Get(member).GetNumberAsInt();
+    return true;
+}
+
+static bool readExtensionIds(const tinygltf::ExtensionMap& extensions, const char* extension, std::vector<int>& ids, std::string* error) {
+    ids.clear();
+    auto it = extensions.find(extension);
+    if (it == extensions.end()) {
+        return true;
+    }
+    if (!it->second.Has("ids")) {
+        *error += std::string("Extension ") + extension + " does not reference its ids\n";
+        return false;
+    }
+    const tinygltf::Value& array = it->second.Get("ids");
+    for (size_t i = 0; i < array.ArrayLen(); i++) {
+        ids.push_back(array.Get(static_cast<int>(i)).GetNumberAsInt());
+    }
+    return true;
+}
+
+// nlohmann::json SAX interface, member names are given by it
+class GltfSaxHandler {
+public:
+    GltfSaxHandler(tinygltf::Model* model, std::vector<size_t>* buffer_lengths, std::string* error, std::string* warning)
+        : m_model(model), m_bufferLengths(buffer_lengths), m_error(error), m_warning(warning) {
+        m_stack.reserve(32);
+        m_stack.emplace_back();
+    }
+    ~GltfSaxHandler() = default;
+
+    bool null() { // dropped everywhere, tinygltf does not keep nulls in extras either
+        return this->checkDocument();
+    }
+
+    bool boolean(bool value) {
+        SaxFrame& frame = m_stack.back();
+        if (tinygltf::Value* slot = this->getValueSlot(frame)) {
+            *slot = tinygltf::Value(value);
+            return true;
+        }
+        if (frame.scope == SaxScope::ACCESSOR && frame.key == "normalized") {
+            getTarget<tinygltf::Accessor>(frame).normalized = value;
+        }
+        else if (frame.scope == SaxScope::MATERIAL && frame.key == "doubleSided") {
+            getTarget<tinygltf::Material>(frame).doubleSided = value;
+        }
+        return this->checkScalar(frame);
+    }
+
+    bool number_integer(int64_t value) { return this->number({ static_cast<double>(value), value, true }); }
+    bool number_unsigned(uint64_t value) { return this->number({ static_cast<double>(value), static_cast<int64_t>(value), true }); }
+    bool number_float(double value, const std::string& /*text*/) { return this->number({ value, 0, false }); }
+
+    bool string(std::string& value) {
+        SaxFrame& frame = m_stack.back();
+        if (tinygltf::Value* slot = this->getValueSlot(frame)) {
+            *slot = tinygltf::Value(std::move(value));
+            return true;
+        }
+        if (frame.scope == SaxScope::STRING_ARRAY) {
+            getTarget<std::vector<std::string>>(frame).push_back(std::move(value));
+            return true;
+        }
+        if (!this->checkScalar(frame)) {
+            return false;
+        }
+        return this->readString(frame, value);
+    }
+
+    bool binary(nlohmann::json::binary_t& /*value*/) { // never produced by a JSON text
+        return true;
+    }
+
+    bool key(std::string& value) {
+        m_stack.back().key.swap(value);
+        return true;
+    }
+
+    bool start_object(size_t /*size*/) {
+        SaxFrame& frame = m_stack.back();
+        switch (frame.scope) {
+            case SaxScope::DOCUMENT:
+                return this->push(SaxScope::ROOT, m_model);
+            case SaxScope::SKIP:
+                frame.depth++;
+                return true;
+            case SaxScope::EXTENSIONS:
+                return this->pushValue(getTarget<tinygltf::ExtensionMap>(frame)[frame.key], tinygltf::Value(tinygltf::Value::Object{}));
+            case SaxScope::OBJECT_ARRAY:
+                return this->pushElement(frame);
+            case SaxScope::ATTRIBUTES:
+            case SaxScope::NUMBER_ARRAY:
+            case SaxScope::INTEGER_ARRAY:
+            case SaxScope::STRING_ARRAY:
+                return this->push(SaxScope::SKIP, nullptr);
+            default:
+                if (tinygltf::Value* slot = this->getValueSlot(frame)) {
+                    return this->pushValue(*slot, tinygltf::Value(tinygltf::Value::Object{}));
+                }
+                return this->pushObject(frame);
+        }
+    }
+
+    bool end_object() {
+        SaxFrame& frame = m_stack.back();
+        switch (frame.scope) {
+            case SaxScope::SKIP:
+                return this->endSkip(frame);
+            case SaxScope::VALUE:
+                return this->endValue();
+            case SaxScope::EXTENSIONS:
+            case SaxScope::ATTRIBUTES:
+                m_stack.pop_back();
+                return true;
+            default: {
+                bool good = this->finishObject(frame);
+                m_stack.pop_back();
+                return good;
+            }
+        }
+    }
+
+    bool start_array(size_t /*size*/) {
+        SaxFrame& frame = m_stack.back();
+        switch (frame.scope) {
+            case SaxScope::DOCUMENT:
+                return this->checkDocument();
+            case SaxScope::SKIP:
+                frame.depth++;
+                return true;
+            case SaxScope::OBJECT_ARRAY:
+                return this->failNotObject();
+            case SaxScope::EXTENSIONS: // an extension that is not an object is ignored
+            case SaxScope::ATTRIBUTES:
+            case SaxScope::NUMBER_ARRAY:
+            case SaxScope::INTEGER_ARRAY:
+            case SaxScope::STRING_ARRAY:
+                return this->push(SaxScope::SKIP, nullptr);
+            default:
+                if (tinygltf::Value* slot = this->getValueSlot(frame)) {
+                    return this->pushValue(*slot, tinygltf::Value(tinygltf::Value::Array{}));
+                }
+                return this->pushArray(frame);
+        }
+    }
+
+    bool end_array() {
+        SaxFrame& frame = m_stack.back();
+        switch (frame.scope) {
+            case SaxScope::SKIP:
+                return this->endSkip(frame);
+            case SaxScope::VALUE:
+                return this->endValue();
+            default:
+                m_stack.pop_back();
+                return true;
+        }
+    }
+
+    bool parse_error(size_t /*position*/, const std::string& /*last_token*/, const nlohmann::detail::exception& exception) {
+        *m_error += std::string("Failed to parse glTF JSON : ") + exception.what() + "\n";
+        return false;
+    }
+
+    [[nodiscard]] bool isComplete() const noexcept { return m_complete; }
+
+    GltfSaxHandler(const GltfSaxHandler&)            = delete;
+    GltfSaxHandler& operator=(const GltfSaxHandler&) = delete;
+
+private:
+    bool push(SaxScope scope, void* target, SaxScope element = SaxScope::DOCUMENT) {
+        SaxFrame& frame = m_stack.emplace_back();
+        frame.scope     = scope;
+        frame.element   = element;
+        frame.target    = target;
+        return true;
+    }
+
+    template <typename T>
+    bool pushArray(SaxScope scope, std::vector<T>& array) {
+        array.clear();
+        return this->push(scope, &array);
+    }
+
+    template <typename T>
+    bool pushObjects(SaxScope element, std::vector<T>& array) {
+        return this->push(SaxScope::OBJECT_ARRAY, &array, element);
+    }
+
+    bool pushValue(tinygltf::Value& slot, tinygltf::Value&& value) {
+        slot = std::move(value);
+        return this->push(SaxScope::VALUE, &slot);
+    }
+
+    bool fail(const std::string& message) {
+        *m_error += message + "\n";
+        return false;
+    }
+
+    bool checkDocument() {
+        return m_stack.back().scope != SaxScope::DOCUMENT || this->fail("Root element is not a JSON object");
+    }
+
+    bool failNotObject() {
+        const std::string& key = m_stack[m_stack.size() - 2].key;
+        return this->fail("`" + key + "' does not contain a JSON object");
+    }
+
+    bool checkScalar(const SaxFrame& frame) {
+        if (frame.scope == SaxScope::OBJECT_ARRAY) {
+            return this->failNotObject();
+        }
+        return this->checkDocument();
+    }
+
+    bool endSkip(SaxFrame& frame) {
+        if (frame.depth > 0) {
+            frame.depth--;
+        }
+        else {
+            m_stack.pop_back();
+        }
+        return true;
+    }
+
+    // where a value read in this frame goes : the next entry of a VALUE, or the extras of a glTF object. nullptr if neither
+    tinygltf::Value* getValueSlot(SaxFrame& frame) {
+        switch (frame.scope) {
+            case SaxScope::VALUE: {
+                auto& value = getTarget<tinygltf::Value>(frame);
+                if (value.IsArray()) {
+                    return &value.Get<tinygltf::Value::Array>().emplace_back();
+                }
+                return &value.Get<tinygltf::Value::Object>()[frame.key];
+            }
+            case SaxScope::DOCUMENT:
+            case SaxScope::SKIP:
+            case SaxScope::EXTENSIONS:
+            case SaxScope::ATTRIBUTES:
+            case SaxScope::OBJECT_ARRAY:
+            case SaxScope::NUMBER_ARRAY:
+            case SaxScope::INTEGER_ARRAY:
+            case SaxScope::STRING_ARRAY:
+                return nullptr;
+            default:
+                return frame.key == "extras" ? getExtras(frame) : nullptr;
+        }
+    }
+
+    // empty objects / arrays are dropped like nulls, an empty extension stays an empty object
+    bool endValue() {
+        auto& value = getTarget<tinygltf::Value>(m_stack.back());
+        bool  empty = value.IsArray() ? value.Get<tinygltf::Value::Array>().empty() : value.Get<tinygltf::Value::Object>().empty();
+        m_stack.pop_back();
+        if (!empty) {
+            return true;
+        }
+
+        SaxFrame& parent = m_stack.back();
+        switch (parent.scope) {
+            case SaxScope::VALUE: {
+                auto& container = getTarget<tinygltf::Value>(parent);
+                if (container.IsArray()) {
+                    container.Get<tinygltf::Value::Array>().pop_back();
+                }
+                else {
+                    container.Get<tinygltf::Value::Object>().erase(parent.key);
+                }
+                break;
+            }
+            case SaxScope::EXTENSIONS:
+                break;
+            default:
+                value = tinygltf::Value();
+                break;
+        }
+        return true;
+    }
+
+    bool pushElement(const SaxFrame& frame) {
+        switch (frame.element) {
+            case SaxScope::SCENE:
+                return this->push(SaxScope::SCENE, &getTarget<std::vector<tinygltf::Scene>>(frame).emplace_back());
+            case SaxScope::NODE:
+                m_hasMatrix = false;
+                return this->push(SaxScope::NODE, &getTarget<std::vector<tinygltf::Node>>(frame).emplace_back());
+            case SaxScope::MESH:
+                return this->push(SaxScope::MESH, &getTarget<std::vector<tinygltf::Mesh>>(frame).emplace_back());
+            case SaxScope::PRIMITIVE: {
+                tinygltf::Primitive& primitive = getTarget<std::vector<tinygltf::Primitive>>(frame).emplace_back();
+                primitive.mode                 = TINYGLTF_MODE_TRIANGLES;
+                return this->push(SaxScope::PRIMITIVE, &primitive);
+            }
+            case SaxScope::ATTRIBUTES:
+                return this->push(SaxScope::ATTRIBUTES, &getTarget<std::vector<std::map<std::string, int>>>(frame).emplace_back());
+            case SaxScope::ACCESSOR:
+                return this->push(SaxScope::ACCESSOR, &getTarget<std::vector<tinygltf::Accessor>>(frame).emplace_back());
+            case SaxScope::BUFFER_VIEW:
+                return this->push(SaxScope::BUFFER_VIEW, &getTarget<std::vector<tinygltf::BufferView>>(frame).emplace_back());
+            case SaxScope::BUFFER:
+                m_bufferLengths->push_back(0);
+                return this->push(SaxScope::BUFFER, &getTarget<std::vector<tinygltf::Buffer>>(frame).emplace_back());
+            case SaxScope::MATERIAL:
+                m_hasEmissiveFactor = false;
+                return this->push(SaxScope::MATERIAL, &getTarget<std::vector<tinygltf::Material>>(frame).emplace_back());
+            case SaxScope::TEXTURE:
+                return this->push(SaxScope::TEXTURE, &getTarget<std::vector<tinygltf::Texture>>(frame).emplace_back());
+            case SaxScope::IMAGE: {
+                tinygltf::Image& image = getTarget<std::vector<tinygltf::Image>>(frame).emplace_back();
+                image.width            = 0; // tinygltf's default for bufferView images, uri ones are reset in finishObject()
+                image.height           = 0;
+                m_hasImageUri          = false;
+                m_hasImageBufferView   = false;
+                return this->push(SaxScope::IMAGE, &image);
+            }
+            case SaxScope::SAMPLER:
+                return this->push(SaxScope::SAMPLER, &getTarget<std::vector<tinygltf::Sampler>>(frame).emplace_back());
+            case SaxScope::SKIN:
+                return this->push(SaxScope::SKIN, &getTarget<std::vector<tinygltf::Skin>>(frame).emplace_back());
+            case SaxScope::ANIMATION:
+                return this->push(SaxScope::ANIMATION, &getTarget<std::vector<tinygltf::Animation>>(frame).emplace_back());
+            case SaxScope::CHANNEL:
+                return this->push(SaxScope::CHANNEL, &getTarget<std::vector<tinygltf::AnimationChannel>>(frame).emplace_back());
+            case SaxScope::ANIMATION_SAMPLER:
+                return this->push(SaxScope::ANIMATION_SAMPLER, &getTarget<std::vector<tinygltf::AnimationSampler>>(frame).emplace_back());
+            default:
+                return this->push(SaxScope::SKIP, nullptr);
+        }
+    }
+
+    // an object member of a glTF object, anything unknown ( cameras, KHR_materials_* parameters, ... ) is skipped
+    bool pushObject(const SaxFrame& frame) {
+        const std::string& key = frame.key;
+
+        if (key == "extensions") {
+            tinygltf::ExtensionMap* extensions = getExtensions(frame);
+            if (extensions == nullptr) {
+                return this->push(SaxScope::SKIP, nullptr);
+            }
+            extensions->clear();
+            return this->push(SaxScope::EXTENSIONS, extensions);
+        }
+
+        switch (frame.scope) {
+            case SaxScope::ROOT:
+                if (key == "asset") return this->push(SaxScope::ASSET, &m_model->asset);
+                break;
+            case SaxScope::PRIMITIVE:
+                if (key == "attributes") {
+                    auto& attributes = getTarget<tinygltf::Primitive>(frame).attributes;
+                    attributes.clear();
+                    return this->push(SaxScope::ATTRIBUTES, &attributes);
+                }
+                break;
+            case SaxScope::ACCESSOR:
+                if (key == "sparse") {
+                    tinygltf::Accessor::Sparse& sparse = getTarget<tinygltf::Accessor>(frame).sparse;
+                    sparse.isSparse                    = true;
+                    return this->push(SaxScope::SPARSE, &sparse);
+                }
+                break;
+            case SaxScope::SPARSE:
+                if (key == "indices") return this->push(SaxScope::SPARSE_INDICES, &getTarget<tinygltf::Accessor::Sparse>(frame).indices);
+                if (key == "values") return this->push(SaxScope::SPARSE_VALUES, &getTarget<tinygltf::Accessor::Sparse>(frame).values);
+                break;
+            case SaxScope::MATERIAL: {
+                auto& material = getTarget<tinygltf::Material>(frame);
+                if (key == "pbrMetallicRoughness") {
+                    m_hasBaseColorFactor = false;
+                    return this->push(SaxScope::PBR, &material.pbrMetallicRoughness);
+                }
+                if (key == "normalTexture") return this->push(SaxScope::NORMAL_TEXTURE_INFO, &material.normalTexture);
+                if (key == "occlusionTexture") return this->push(SaxScope::OCCLUSION_TEXTURE_INFO, &material.occlusionTexture);
+                if (key == "emissiveTexture") return this->push(SaxScope::TEXTURE_INFO, &material.emissiveTexture);
+                break;
+            }
+            case SaxScope::PBR: {
+                auto& pbr = getTarget<tinygltf::PbrMetallicRoughness>(frame);
+                if (key == "baseColorTexture") return this->push(SaxScope::TEXTURE_INFO, &pbr.baseColorTexture);
+                if (key == "metallicRoughnessTexture") return this->push(SaxScope::TEXTURE_INFO, &pbr.metallicRoughnessTexture);
+                break;
+            }
+            case SaxScope::CHANNEL:
+                if (key == "target") return this->push(SaxScope::CHANNEL_TARGET, frame.target);
+                break;
+            default:
+                break;
+        }
+        return this->push(SaxScope::SKIP, nullptr);
+    }
+
+    // an array member of a glTF object
+    bool pushArray(const SaxFrame& frame) {
+        const std::string& key = frame.key;
+
+        switch (frame.scope) {
+            case SaxScope::ROOT: {
+                tinygltf::Model& model = *m_model;
+                if (key == "extensionsUsed") return this->pushArray(SaxScope::STRING_ARRAY, model.extensionsUsed);
+                if (key == "extensionsRequired") return this->pushArray(SaxScope::STRING_ARRAY, model.extensionsRequired);
+                if (key == "scenes") return this->pushObjects(SaxScope::SCENE, model.scenes);
+                if (key == "nodes") return this->pushObjects(SaxScope::NODE, model.nodes);
+                if (key == "meshes") return this->pushObjects(SaxScope::MESH, model.meshes);
+                if (key == "accessors") return this->pushObjects(SaxScope::ACCESSOR, model.accessors);
+                if (key == "bufferViews") return this->pushObjects(SaxScope::BUFFER_VIEW, model.bufferViews);
+                if (key == "buffers") return this->pushObjects(SaxScope::BUFFER, model.buffers);
+                if (key == "materials") return this->pushObjects(SaxScope::MATERIAL, model.materials);
+                if (key == "textures") return this->pushObjects(SaxScope::TEXTURE, model.textures);
+                if (key == "images") return this->pushObjects(SaxScope::IMAGE, model.images);
+                if (key == "samplers") return this->pushObjects(SaxScope::SAMPLER, model.samplers);
+                if (key == "skins") return this->pushObjects(SaxScope::SKIN, model.skins);
+                if (key == "animations") return this->pushObjects(SaxScope::ANIMATION, model.animations);
+                break;
+            }
+            case SaxScope::SCENE:
+                if (key == "nodes") return this->pushArray(SaxScope::INTEGER_ARRAY, getTarget<tinygltf::Scene>(frame).nodes);
+                break;
+            case SaxScope::NODE: {
+                auto& node = getTarget<tinygltf::Node>(frame);
+                if (key == "children") return this->pushArray(SaxScope::INTEGER_ARRAY, node.children);
+                if (key == "matrix") {
+                    m_hasMatrix = true;
+                    return this->pushArray(SaxScope::NUMBER_ARRAY, node.matrix);
+                }
+                if (key == "rotation") return this->pushArray(SaxScope::NUMBER_ARRAY, node.rotation);
+                if (key == "scale") return this->pushArray(SaxScope::NUMBER_ARRAY, node.scale);
+                if (key == "translation") return this->pushArray(SaxScope::NUMBER_ARRAY, node.translation);
+                if (key == "weights") return this->pushArray(SaxScope::NUMBER_ARRAY, node.weights);
+                break;
+            }
+            case SaxScope::MESH: {
+                auto& mesh = getTarget<tinygltf::Mesh>(frame);
+                if (key == "primitives") {
+                    mesh.primitives.clear();
+                    return this->pushObjects(SaxScope::PRIMITIVE, mesh.primitives);
+                }
+                if (key == "weights") return this->pushArray(SaxScope::NUMBER_ARRAY, mesh.weights);
+                break;
+            }
+            case SaxScope::PRIMITIVE:
+                if (key == "targets") return this->pushObjects(SaxScope::ATTRIBUTES, getTarget<tinygltf::Primitive>(frame).targets);
+                break;
+            case SaxScope::ACCESSOR:
+                if (key == "min") return this->pushArray(SaxScope::NUMBER_ARRAY, getTarget<tinygltf::Accessor>(frame).minValues);
+                if (key == "max") return this->pushArray(SaxScope::NUMBER_ARRAY, getTarget<tinygltf::Accessor>(frame).maxValues);
+                break;
+            case SaxScope::MATERIAL:
+                if (key == "emissiveFactor") {
+                    m_hasEmissiveFactor = true;
+                    return this->pushArray(SaxScope::NUMBER_ARRAY, getTarget<tinygltf::Material>(frame).emissiveFactor);
+                }
+                break;
+            case SaxScope::PBR:
+                if (key == "baseColorFactor") {
+                    m_hasBaseColorFactor = true;
+                    return this->pushArray(SaxScope::NUMBER_ARRAY, getTarget<tinygltf::PbrMetallicRoughness>(frame).baseColorFactor);
+                }
+                break;
+            case SaxScope::SKIN:
+                if (key == "joints") return this->pushArray(SaxScope::INTEGER_ARRAY, getTarget<tinygltf::Skin>(frame).joints);
+                break;
+            case SaxScope::ANIMATION: {
+                auto& animation = getTarget<tinygltf::Animation>(frame);
+                if (key == "channels") return this->pushObjects(SaxScope::CHANNEL, animation.channels);
+                if (key == "samplers") return this->pushObjects(SaxScope::ANIMATION_SAMPLER, animation.samplers);
+                break;
+            }
+            default:
+                break;
+        }
+        return this->push(SaxScope::SKIP, nullptr);
+    }
+
+    bool number(const SaxNumber& number) {
+        SaxFrame& frame = m_stack.back();
+        if (tinygltf::Value* slot = this->getValueSlot(frame)) {
+            *slot = number.is_integer ? tinygltf::Value(static_cast<int>(number.integer)) : tinygltf::Value(number.real);
+            return true;
+        }
+
+        switch (frame.scope) {
+            case SaxScope::NUMBER_ARRAY:
+                getTarget<std::vector<double>>(frame).push_back(number.real);
+                return true;
+            case SaxScope::INTEGER_ARRAY:
+                if (number.is_integer) {
+                    getTarget<std::vector<int>>(frame).push_back(static_cast<int>(number.integer));
+                }
+                return true;
+            case SaxScope::ATTRIBUTES:
+                if (number.is_integer) {
+                    getTarget<std::map<std::string, int>>(frame)[frame.key] = static_cast<int>(number.integer);
+                }
+                return true;
+            default:
+                if (!this->checkScalar(frame)) {
+                    return false;
+                }
+                this->readNumber(frame, number);
+                return true;
+        }
+    }
+
+    void readNumber(const SaxFrame& frame, const SaxNumber& number) {
+        const std::string& key = frame.key;
+
+        switch (frame.scope) {
+            case SaxScope::ROOT:
+                if (key == "scene") readInteger(m_model->defaultScene, number);
+                break;
+            case SaxScope::NODE: {
+                auto& node = getTarget<tinygltf::Node>(frame);
+                if (key == "mesh") readInteger(node.mesh, number);
+                else if (key == "skin") readInteger(node.skin, number);
+                else if (key == "camera") readInteger(node.camera, number);
+                break;
+            }
+            case SaxScope::PRIMITIVE: {
+                auto& primitive = getTarget<tinygltf::Primitive>(frame);
+                if (key == "indices") readInteger(primitive.indices, number);
+                else if (key == "material") readInteger(primitive.material, number);
+                else if (key == "mode") readInteger(primitive.mode, number);
+                break;
+            }
+            case SaxScope::ACCESSOR: {
+                auto& accessor = getTarget<tinygltf::Accessor>(frame);
+                if (key == "bufferView") readInteger(accessor.bufferView, number);
+                else if (key == "byteOffset") readUnsigned(accessor.byteOffset, number);
+                else if (key == "count") readUnsigned(accessor.count, number);
+                else if (key == "componentType" && number.is_integer && number.integer >= 0) readInteger(accessor.componentType, number);
+                break;
+            }
+            case SaxScope::SPARSE:
+                if (key == "count") readInteger(getTarget<tinygltf::Accessor::Sparse>(frame).count, number);
+                break;
+            case SaxScope::SPARSE_INDICES: {
+                auto& indices = getTarget<SparseIndices>(frame);
+                if (key == "bufferView") readInteger(indices.bufferView, number);
+                else if (key == "byteOffset") readUnsigned(indices.byteOffset, number);
+                else if (key == "componentType") readInteger(indices.componentType, number);
+                break;
+            }
+            case SaxScope::SPARSE_VALUES: {
+                auto& values = getTarget<SparseValues>(frame);
+                if (key == "bufferView") readInteger(values.bufferView, number);
+                else if (key == "byteOffset") readUnsigned(values.byteOffset, number);
+                break;
+            }
+            case SaxScope::BUFFER_VIEW: {
+                auto& buffer_view = getTarget<tinygltf::BufferView>(frame);
+                if (key == "buffer") readInteger(buffer_view.buffer, number);
+                else if (key == "byteOffset") readUnsigned(buffer_view.byteOffset, number);
+                else if (key == "byteLength") readUnsigned(buffer_view.byteLength, number);
+                else if (key == "byteStride") readUnsigned(buffer_view.byteStride, number);
+                else if (key == "target") readInteger(buffer_view.target, number);
+                break;
+            }
+            case SaxScope::BUFFER:
+                if (key == "byteLength") readUnsigned(m_bufferLengths->back(), number);
+                break;
+            case SaxScope::MATERIAL:
+                if (key == "alphaCutoff") getTarget<tinygltf::Material>(frame).alphaCutoff = number.real;
+                break;
+            case SaxScope::PBR: {
+                auto& pbr = getTarget<tinygltf::PbrMetallicRoughness>(frame);
+                if (key == "metallicFactor") pbr.metallicFactor = number.real;
+                else if (key == "roughnessFactor") pbr.roughnessFactor = number.real;
+                break;
+            }
+            case SaxScope::TEXTURE_INFO:
+                readTextureInfo(getTarget<tinygltf::TextureInfo>(frame), key, number);
+                break;
+            case SaxScope::NORMAL_TEXTURE_INFO: {
+                auto& info = getTarget<tinygltf::NormalTextureInfo>(frame);
+                readTextureInfo(info, key, number);
+                if (key == "scale") info.scale = number.real;
+                break;
+            }
+            case SaxScope::OCCLUSION_TEXTURE_INFO: {
+                auto& info = getTarget<tinygltf::OcclusionTextureInfo>(frame);
+                readTextureInfo(info, key, number);
+                if (key == "strength") info.strength = number.real;
+                break;
+            }
+            case SaxScope::TEXTURE: {
+                auto& texture = getTarget<tinygltf::Texture>(frame);
+                if (key == "source") readInteger(texture.source, number);
+                else if (key == "sampler") readInteger(texture.sampler, number);
+                break;
+            }
+            case SaxScope::IMAGE: {
+                auto& image = getTarget<tinygltf::Image>(frame);
+                if (key == "bufferView") {
+                    m_hasImageBufferView = true;
+                    readInteger(image.bufferView, number);
+                }
+                else if (key == "width") readInteger(image.width, number);
+                else if (key == "height") readInteger(image.height, number);
+                break;
+            }
+            case SaxScope::SAMPLER: {
+                auto& sampler = getTarget<tinygltf::Sampler>(frame);
+                if (key == "minFilter") readInteger(sampler.minFilter, number);
+                else if (key == "magFilter") readInteger(sampler.magFilter, number);
+                else if (key == "wrapS") readInteger(sampler.wrapS, number);
+                else if (key == "wrapT") readInteger(sampler.wrapT, number);
+                break;
+            }
+            case SaxScope::SKIN: {
+                auto& skin = getTarget<tinygltf::Skin>(frame);
+                if (key == "inverseBindMatrices") readInteger(skin.inverseBindMatrices, number);
+                else if (key == "skeleton") readInteger(skin.skeleton, number);
+                break;
+            }
+            case SaxScope::CHANNEL:
+                if (key == "sampler") readInteger(getTarget<tinygltf::AnimationChannel>(frame).sampler, number);
+                break;
+            case SaxScope::CHANNEL_TARGET:
+                if (key == "node") readInteger(getTarget<tinygltf::AnimationChannel>(frame).target_node, number);
+                break;
+            case SaxScope::ANIMATION_SAMPLER: {
+                auto& sampler = getTarget<tinygltf::AnimationSampler>(frame);
+                if (key == "input") readInteger(sampler.input, number);
+                else if (key == "output") readInteger(sampler.output, number);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    bool readString(const SaxFrame& frame, std::string& value) {
+        const std::string& key = frame.key;
+
+        if (key == "name") {
+            visitObject(frame, [&value](auto& object) {
+                if constexpr (requires { object.name = std::move(value); }) {
+                    object.name = std::move(value);
+                }
+            });
+            return true;
+        }
+
+        switch (frame.scope) {
+            case SaxScope::ASSET: {
+                auto& asset = getTarget<tinygltf::Asset>(frame);
+                if (key == "version") asset.version = std::move(value);
+                else if (key == "generator") asset.generator = std::move(value);
+                else if (key == "minVersion") asset.minVersion = std::move(value);
+                else if (key == "copyright") asset.copyright = std::move(value);
+                break;
+            }
+            case SaxScope::ACCESSOR:
+                if (key == "type") {
+                    int type = getAccessorType(value);
+                    if (type < 0) {
+                        return this->fail("Unsupported `type` for accessor object. Got \"" + value + "\"");
+                    }
+                    getTarget<tinygltf::Accessor>(frame).type = type;
+                }
+                break;
+            case SaxScope::MATERIAL:
+                if (key == "alphaMode") getTarget<tinygltf::Material>(frame).alphaMode = std::move(value);
+                break;
+            case SaxScope::IMAGE: {
+                auto& image = getTarget<tinygltf::Image>(frame);
+                if (key == "uri") {
+                    m_hasImageUri = true;
+                    image.uri     = std::move(value);
+                }
+                else if (key == "mimeType") {
+                    image.mimeType = std::move(value);
+                }
+                break;
+            }
+            case SaxScope::BUFFER:
+                if (key == "uri") getTarget<tinygltf::Buffer>(frame).uri = std::move(value);
+                break;
+            case SaxScope::CHANNEL_TARGET:
+                if (key == "path") getTarget<tinygltf::AnimationChannel>(frame).target_path = std::move(value);
+                break;
+            case SaxScope::ANIMATION_SAMPLER:
+                if (key == "interpolation") getTarget<tinygltf::AnimationSampler>(frame).interpolation = std::move(value);
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    // required members and the fix-ups tinygltf does once an object is parsed
+    bool finishObject(const SaxFrame& frame) {
+        switch (frame.scope) {
+            case SaxScope::ROOT:
+                return this->finishModel();
+            case SaxScope::NODE: {
+                auto& node = getTarget<tinygltf::Node>(frame);
+                if (m_hasMatrix) { // TRS is ignored next to a matrix
+                    node.rotation.clear();
+                    node.scale.clear();
+                    node.translation.clear();
+                }
+                return readExtensionIndex(node.extensions, "KHR_lights_punctual", "light", node.light, m_error) &&
+                       readExtensionIndex(node.extensions, "KHR_audio", "emitter", node.emitter, m_error) &&
+                       readExtensionIds(node.extensions, "MSFT_lod", node.lods, m_error);
+            }
+            case SaxScope::ACCESSOR: {
+                auto& accessor = getTarget<tinygltf::Accessor>(frame);
+                if (accessor.type < 0) {
+                    return this->fail("Accessor has no `type`");
+                }
+                if (accessor.componentType < TINYGLTF_COMPONENT_TYPE_BYTE || accessor.componentType > TINYGLTF_COMPONENT_TYPE_DOUBLE) {
+                    return this->fail("Invalid `componentType` in accessor. Got " + std::to_string(accessor.componentType));
+                }
+                return true;
+            }
+            case SaxScope::SPARSE: {
+                auto& sparse = getTarget<tinygltf::Accessor::Sparse>(frame);
+                if (sparse.indices.bufferView < 0 || sparse.values.bufferView < 0) {
+                    return this->fail("the sparse object of this accessor doesn't have indices or values");
+                }
+                return true;
+            }
+            case SaxScope::BUFFER_VIEW: {
+                auto& buffer_view = getTarget<tinygltf::BufferView>(frame);
+                if (buffer_view.buffer < 0) {
+                    return this->fail("BufferView has no `buffer`");
+                }
+                if (buffer_view.byteStride > 252 || buffer_view.byteStride % 4 != 0) {
+                    return this->fail("Invalid `byteStride' value. `byteStride' must be the multiple of 4 : " + std::to_string(buffer_view.byteStride));
+                }
+                if (buffer_view.target != TINYGLTF_TARGET_ARRAY_BUFFER && buffer_view.target != TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER) {
+                    buffer_view.target = 0;
+                }
+                return true;
+            }
+            case SaxScope::MATERIAL: {
+                auto& material = getTarget<tinygltf::Material>(frame);
+                if (!m_hasEmissiveFactor) {
+                    material.emissiveFactor = { 0.0, 0.0, 0.0 };
+                }
+                else if (material.emissiveFactor.size() == 4) {
+                    *m_warning += "Array length of `emissiveFactor` parameter in material must be 3, but got 4\n";
+                    material.emissiveFactor.resize(3);
+                }
+                else if (material.emissiveFactor.size() != 3) {
+                    return this->fail("Array length of `emissiveFactor` parameter in material must be 3, but got " + std::to_string(material.emissiveFactor.size()));
+                }
+                return readExtensionIds(material.extensions, "MSFT_lod", material.lods, m_error);
+            }
+            case SaxScope::PBR: {
+                auto& pbr = getTarget<tinygltf::PbrMetallicRoughness>(frame);
+                if (m_hasBaseColorFactor && pbr.baseColorFactor.size() != 4) { // reported, the material keeps the default factor
+                    *m_error += "Array length of `baseColorFactor` parameter in pbrMetallicRoughness must be 4, but got " + std::to_string(pbr.baseColorFactor.size()) + "\n";
+                    pbr.baseColorFactor = { 1.0, 1.0, 1.0, 1.0 };
+                }
+                return true;
+            }
+            case SaxScope::IMAGE: {
+                auto&  image = getTarget<tinygltf::Image>(frame);
+                size_t index = m_model->images.size() - 1;
+                if (m_hasImageBufferView == m_hasImageUri) {
+                    return this->fail("Exactly one of `bufferView` or `uri` has to be defined for image[" + std::to_string(index) + "] name = \"" + image.name + "\"");
+                }
+                if (m_hasImageUri) { // only read for the bufferView ones
+                    image.mimeType.clear();
+                    image.width  = -1;
+                    image.height = -1;
+                }
+                else if (image.bufferView < 0) {
+                    return this->fail("Failed to parse `bufferView` for image[" + std::to_string(index) + "] name = \"" + image.name + "\"");
+                }
+                return true;
+            }
+            case SaxScope::CHANNEL: {
+                auto& channel = getTarget<tinygltf::AnimationChannel>(frame);
+                if (channel.sampler < 0) {
+                    return this->fail("`sampler` field is missing in animation channels");
+                }
+                if (channel.target_path.empty()) {
+                    return this->fail("`path` field is missing in animation.channels.target");
+                }
+                return true;
+            }
+            case SaxScope::ANIMATION_SAMPLER: {
+                auto& sampler = getTarget<tinygltf::AnimationSampler>(frame);
+                if (sampler.input < 0 || sampler.output < 0) {
+                    return this->fail("`input` or `output` field is missing in animation.sampler");
+                }
+                return true;
+            }
+            default:
+                return true;
+        }
+    }
+
+    bool finishModel() {
+        tinygltf::Model& model = *m_model;
+        if (model.asset.version.empty()) {
+            return this->fail("\"asset\" object not found in .gltf or not an object type");
+        }
+
+        // bufferView targets tinygltf derives from the primitives
+        auto mark_target = [&model](int accessor, int target) {
+            if (accessor < 0 || static_cast<size_t>(accessor) >= model.accessors.size()) {
+                return;
+            }
+            int buffer_view = model.accessors[accessor].bufferView;
+            if (buffer_view >= 0 && static_cast<size_t>(buffer_view) < model.bufferViews.size()) {
+                model.bufferViews[buffer_view].target = target;
+            }
+        };
+        for (const auto& mesh : model.meshes) {
+            for (const auto& primitive : mesh.primitives) {
+                if (primitive.indices >= 0 && static_cast<size_t>(primitive.indices) >= model.accessors.size()) {
+                    return this->fail("primitive indices accessor out of bounds");
+                }
+                mark_target(primitive.indices, TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER);
+                for (const auto& [name, accessor] : primitive.attributes) {
+                    mark_target(accessor, TINYGLTF_TARGET_ARRAY_BUFFER);
+                }
+                for (const auto& target : primitive.targets) {
+                    for (const auto& [name, accessor] : target) {
+                        mark_target(accessor, TINYGLTF_TARGET_ARRAY_BUFFER);
+                    }
+                }
+            }
+        }
+
+        m_complete = true;
+        return true;
+    }
+
+private:
+    tinygltf::Model*      m_model;
+    std::vector<size_t>*  m_bufferLengths;
+    std::string*          m_error;
+    std::string*          m_warning;
+    std::vector<SaxFrame> m_stack; // [0] - DOCUMENT, then every open object / array
+
+    // members whose presence matters, not just their value. Nodes, materials and images do not nest
+    bool m_hasMatrix{ false };
+    bool m_hasEmissiveFactor{ false };
+    bool m_hasBaseColorFactor{ false };
+    bool m_hasImageUri{ false };
+    bool m_hasImageBufferView{ false };
+    bool m_complete{ false };
+};
+
+bool GltfSaxParser::Parse(std::span<const uint8_t> json, tinygltf::Model* model, std::vector<size_t>* buffer_lengths, std::string* error, std::string* warning) {
+    *model = tinygltf::Model{};
+    buffer_lengths->clear();
+
+    GltfSaxHandler handler(model, buffer_lengths, error, warning);
+    bool           good = nlohmann::json::sax_parse(json.begin(), json.end(), &handler);
+    return good && handler.isComplete();
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "tiny_gltf.h"
+
+// glTF JSON straight into a tinygltf::Model through nlohmann::json::sax_parse, no DOM is built in between
+// Fills the same fields as TinyGLTF::LoadASCIIFromString for everything Model reads : asset, scenes, nodes, meshes,
+// accessors, bufferViews, buffers, materials, textures, images, samplers, skins, animations, extensionsUsed / Required
+// and every extensions / extras member. Cameras, lights, audio and the legacy material values are not filled
+// Buffers get their uri only and images their uri / bufferView only, the data is left to the caller ( MappedGltfLoader::Load )
+class GltfSaxParser {
+public:
+    // buffer_lengths - byteLength of every model->buffers entry, tinygltf::Buffer has no field for it
+    static bool Parse(std::span<const uint8_t> json, tinygltf::Model* model, std::vector<size_t>* buffer_lengths, std::string* error, std::string* warning);
+};
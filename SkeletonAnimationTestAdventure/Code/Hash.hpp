@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+// fast non-cryptographic 64-bit hashing for cache keys
+// not stable across endianness, caches are local to the machine anyway
+
+inline static constexpr uint64_t HASH_SEED = 0x9E3779B97F4A7C15ULL;
+
+inline uint64_t hashMix(uint64_t value) noexcept {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+inline uint64_t hashCombine(uint64_t seed, uint64_t value) noexcept {
+    return hashMix(seed ^ (value + HASH_SEED + (seed << 6) + (seed >> 2)));
+}
+
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = HASH_SEED) noexcept {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+
+    uint64_t lanes[4] = { seed, seed ^ 0x6A09E667F3BCC908ULL, seed ^ 0xBB67AE8584CAA73BULL, seed ^ 0x3C6EF372FE94F82BULL };
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) { // 4 independent lanes keep the multiplier pipeline busy
+        for (int lane = 0; lane < 4; lane++) {
+            uint64_t word{};
+            memcpy(&word, bytes + i + (lane * 8), sizeof(uint64_t));
+            lanes[lane] = (lanes[lane] ^ word) * 0x9FB21C651E98DF25ULL;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+
+    uint64_t hash = hashCombine(hashCombine(lanes[0], lanes[1]), hashCombine(lanes[2], lanes[3]));
+
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word{};
+        memcpy(&word, bytes + i, sizeof(uint64_t));
+        hash = hashCombine(hash, word);
+    }
+
+    uint64_t tail{};
+    if (i < size) {
+        memcpy(&tail, bytes + i, size - i);
+    }
+
+    return hashCombine(hash, tail ^ (static_cast<uint64_t>(size) << 56));
+}
+
+inline uint64_t hashBytes(std::span<const uint8_t> bytes, uint64_t seed = HASH_SEED) noexcept {
+    return hashBytes(bytes.data(), bytes.size(), seed);
+}
+
+inline uint64_t hashString(std::string_view string, uint64_t seed = HASH_SEED) noexcept {
+    return hashBytes(string.data(), string.size(), seed);
+}
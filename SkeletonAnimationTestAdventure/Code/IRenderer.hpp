@@ -3,6 +3,10 @@
 #include <GLFW/glfw3.h>
 #include "Camera.hpp"
 
+struct ModelStreamUpdate;       // forward declaration
+struct TextureStreamingOptions; // forward declaration
+class TextureStreamer;          // forward declaration
+
 struct RenderCommand {
     int 
     glm::mat4 transform{};
@@ -25,7 +29,16 @@ public:
     virtual void Release()                        = 0;
     virtual void Initialize(GLFWwindow* p_window) = 0;
 
-    virtual void loadModel(const Model& model) = 0;
+    // both hand what they uploaded to Model::releaseUploadedData()
+    virtual void loadModel(Model& model) = 0;
+    // ModelStream::Update output : slots with placeholders first, filled in place as the parts arrive
+    virtual void updateModel(Model& model, const ModelStreamUpdate& update) = 0;
+    // before the model goes away or is loaded again. GPU data shared with other models ( AssetCache ) stays until the last one
+    virtual void unloadModel(const Model& model) = 0;
+
+    // before the models are loaded : mips stream by screen size under options.budget_bytes
+    // nullptr - the renderer keeps every texture resident, requests go nowhere
+    virtual TextureStreamer* enableTextureStreaming(const TextureStreamingOptions& options) { return nullptr; }
 
     virtual void onResize(uint32_t width, uint32_t height) = 0;
 
@@ -0,0 +1,147 @@
+#include "LoadProfiler.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <map>
+#include <print>
+
+#include "json.hpp"
+
+void LoadProfiler::Record(LoadProfileEvent&& event) {
+    std::lock_guard lock(m_mutex);
+    m_events.push_back(std::move(event));
+}
+
+std::vector<LoadProfileEvent> LoadProfiler::takeEvents() {
+    std::lock_guard lock(m_mutex);
+
+    std::vector<LoadProfileEvent> events = std::move(m_events);
+    m_events.clear();
+    std::ranges::stable_sort(events, {}, &LoadProfileEvent::start_us);
+    return events;
+}
+
+uint32_t LoadProfiler::getThread() {
+    std::thread::id id = std::this_thread::get_id();
+    std::lock_guard lock(m_mutex);
+
+    auto it = std::ranges::find(m_threads, id);
+    if (it == m_threads.end()) {
+        m_threads.push_back(id);
+        return static_cast<uint32_t>(m_threads.size() - 1);
+    }
+    return static_cast<uint32_t>(it - m_threads.begin());
+}
+
+bool LoadProfiler::writeChromeTrace(const std::filesystem::path& path, std::span<const LoadProfileEvent> events) {
+    nlohmann::json trace_events = nlohmann::json::array();
+    for (const auto& event : events) {
+        nlohmann::json args = {
+            { "bytes_read", event.bytes_read },
+            { "bytes_allocated", event.bytes_allocated },
+        };
+        if (!event.detail.empty()) {
+            args["detail"] = event.detail;
+        }
+
+        trace_events.push_back({
+            { "name", event.detail.empty() ? std::string(event.name) : std::format("{} {}", event.name, event.detail) },
+            { "cat", event.name },
+            { "ph", "X" }, // complete event : start and duration
+            { "ts", event.start_us },
+            { "dur", event.duration_us },
+            { "pid", 1 },
+            { "tid", event.thread },
+            { "args", std::move(args) },
+        });
+    }
+
+    nlohmann::json trace = {
+        { "traceEvents", std::move(trace_events) },
+        { "displayTimeUnit", "ms" },
+    };
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        std::println("WARNING : Failed to open load trace : {}", path.string());
+        return false;
+    }
+    file << trace.dump();
+    return static_cast<bool>(file);
+}
+
+std::string LoadProfiler::getSummary(std::span<const LoadProfileEvent> events) {
+    struct Phase {
+        size_t            events{ 0 };
+        std::vector<bool> threads;
+        double            start_us{ 0 };
+        double            end_us{ 0 };
+        double            total_us{ 0 };
+        double            max_us{ 0 };
+        size_t            bytes_read{ 0 };
+        size_t            bytes_allocated{ 0 };
+    };
+
+    std::vector<std::string>     order{}; // phases in order of their first event
+    std::map<std::string, Phase> phases{};
+    for (const auto& event : events) {
+        auto [it, inserted] = phases.try_emplace(event.name);
+        Phase& phase        = it->second;
+        if (inserted) {
+            order.emplace_back(event.name);
+            phase.start_us = event.start_us;
+        }
+
+        phase.events++;
+        phase.threads.resize(std::max<size_t>(phase.threads.size(), event.thread + 1));
+        phase.threads[event.thread] = true;
+        phase.start_us              = std::min(phase.start_us, event.start_us);
+        phase.end_us                = std::max(phase.end_us, event.start_us + event.duration_us);
+        phase.total_us += event.duration_us;
+        phase.max_us = std::max(phase.max_us, event.duration_us);
+        phase.bytes_read += event.bytes_read;
+        phase.bytes_allocated += event.bytes_allocated;
+    }
+
+    // wall - first start to last end, sum - over every event and thread, so nested and parallel phases are not additive
+    std::string summary = std::format("{:<16} {:>7} {:>7} {:>10} {:>10} {:>10} {:>10} {:>10}\n", "phase", "events", "threads", "wall ms", "sum ms", "max ms", "read MB", "alloc MB");
+    for (const auto& name : order) {
+        const Phase& phase = phases[name];
+        summary += std::format("{:<16} {:>7} {:>7} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}\n",
+                               name,
+                               phase.events,
+                               std::ranges::count(phase.threads, true),
+                               (phase.end_us - phase.start_us) / 1000.0,
+                               phase.total_us / 1000.0,
+                               phase.max_us / 1000.0,
+                               static_cast<double>(phase.bytes_read) / (1024.0 * 1024.0),
+                               static_cast<double>(phase.bytes_allocated) / (1024.0 * 1024.0));
+    }
+    return summary;
+}
+
+LoadProfileScope::LoadProfileScope(LoadProfiler* profiler, const char* name)
+    : m_profiler(profiler) {
+    if (m_profiler != nullptr) {
+        m_event.name = name;
+        m_start      = LoadProfiler::Clock::now();
+    }
+}
+
+LoadProfileScope::~LoadProfileScope() {
+    this->End();
+}
+
+void LoadProfileScope::End() {
+    if (m_profiler == nullptr) {
+        return;
+    }
+
+    auto end            = LoadProfiler::Clock::now();
+    m_event.thread      = m_profiler->getThread();
+    m_event.start_us    = m_profiler->getTime(m_start);
+    m_event.duration_us = std::chrono::duration<double, std::micro>(end - m_start).count();
+    m_profiler->Record(std::move(m_event));
+    m_profiler = nullptr;
+}
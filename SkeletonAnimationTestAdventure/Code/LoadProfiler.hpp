@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// one timed phase of a load, a "complete" event in the Chrome trace
+struct LoadProfileEvent {
+    const char* name{ "" };  // phase, a string literal : "parse", "loadMeshes", "primitive", "tangents", "decodeTexture", ...
+    std::string detail;      // what the phase worked on, e.g. "mesh 3 primitive 1". Empty for whole phases
+    uint32_t    thread{ 0 }; // 0 - the thread that started the load, the others numbered in order of their first event
+
+    double start_us{ 0 }; // since the load started
+    double duration_us{ 0 };
+
+    size_t bytes_read{ 0 };      // source bytes the phase consumed : file, accessor or encoded image bytes
+    size_t bytes_allocated{ 0 }; // CPU bytes of what it produced, element sizes only for the hierarchy phases
+
+    LoadProfileEvent()  = default;
+    ~LoadProfileEvent() = default;
+};
+
+// collects the LoadProfileEvent of one load from any thread ( ModelLoadOptions::profile )
+class LoadProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    LoadProfiler()  = default;
+    ~LoadProfiler() = default;
+
+    void Record(LoadProfileEvent&& event);
+
+    [[nodiscard]] std::vector<LoadProfileEvent> takeEvents(); // sorted by start time
+
+    [[nodiscard]] double   getTime(Clock::time_point time) const noexcept { return std::chrono::duration<double, std::micro>(time - m_start).count(); }
+    [[nodiscard]] uint32_t getThread(); // number of the calling thread, see LoadProfileEvent::thread
+
+    // Chrome trace-event JSON, for chrome://tracing or ui.perfetto.dev
+    static bool writeChromeTrace(const std::filesystem::path& path, std::span<const LoadProfileEvent> events);
+    // one line per phase : events, threads, wall and summed time, bytes
+    static std::string getSummary(std::span<const LoadProfileEvent> events);
+
+    LoadProfiler(const LoadProfiler&)            = delete;
+    LoadProfiler& operator=(const LoadProfiler&) = delete;
+
+private:
+    Clock::time_point             m_start{ Clock::now() };
+    std::mutex                    m_mutex;
+    std::vector<std::thread::id>  m_threads{ std::this_thread::get_id() };
+    std::vector<LoadProfileEvent> m_events;
+};
+
+// times the enclosing block into a LoadProfiler, does nothing without one
+//
+//  LoadProfileScope scope(m_profiler, "loadSkins");
+//  ...
+//  scope.setBytes(read, allocated);
+class LoadProfileScope {
+public:
+    LoadProfileScope(LoadProfiler* profiler, const char* name);
+    ~LoadProfileScope();
+
+    [[nodiscard]] bool isActive() const noexcept { return m_profiler != nullptr; } // check before formatting a detail
+
+    void End(); // records the event now instead of at the end of the block
+
+    void setDetail(std::string detail) { m_event.detail = std::move(detail); }
+    void setBytes(size_t read, size_t allocated) noexcept {
+        m_event.bytes_read      = read;
+        m_event.bytes_allocated = allocated;
+    }
+
+    LoadProfileScope(const LoadProfileScope&)            = delete;
+    LoadProfileScope& operator=(const LoadProfileScope&) = delete;
+
+private:
+    LoadProfiler*                   m_profiler{ nullptr };
+    LoadProfiler::Clock::time_point m_start{};
+    LoadProfileEvent                m_event;
+};
@@ -0,0 +1,92 @@
+#include "LodSelection.hpp"
+
+#include <algorithm>
+
+#include "Camera.hpp"
+
+// the largest axis scale of model, errors and radii are scaled by it
+static float getMaxScale(const glm::mat4& model) {
+    return std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+}
+
+// distance from the camera to the nearest point of the sphere, 0 inside it
+static float getSphereDistance(const glm::vec3& center, float radius, const glm::mat4& model, const LodView& view) {
+    glm::vec3 world_center = glm::vec3(model * glm::vec4(center, 1.0F));
+    float     world_radius = radius * getMaxScale(model);
+    return std::max(glm::length(view.camera_position - world_center) - world_radius, 0.0F);
+}
+
+LodView LodSelection::makeView(const Camera& camera, float pixel_error) {
+    LodView view{};
+    view.camera_position  = camera.getPosition();
+    view.projection_scale = camera.getProjectionScale();
+    view.viewport_height  = static_cast<float>(camera.getHeight());
+    view.pixel_error      = pixel_error;
+    return view;
+}
+
+float LodSelection::getErrorScale(const glm::vec3& center, float radius, const glm::mat4& model, const LodView& view) {
+    float distance = getSphereDistance(center, radius, model, view);
+    if (distance <= 0.0F) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return getMaxScale(model) * view.projection_scale / distance;
+}
+
+float LodSelection::getScreenCoverage(const glm::vec3& center, float radius, const glm::mat4& model, const LodView& view) {
+    float distance = getSphereDistance(center, radius, model, view);
+    if (distance <= 0.0F || view.viewport_height <= 0.0F) {
+        return 1.0F;
+    }
+    float diameter = 2.0F * radius * getMaxScale(model) * view.projection_scale / distance; // pixels
+    return std::min(diameter / view.viewport_height, 1.0F);
+}
+
+float LodSelection::getScreenCoverage(const Mesh& mesh, const glm::mat4& model, const LodView& view) {
+    if (mesh.primitives.empty()) {
+        return 0.0F;
+    }
+
+    // sphere around the primitive spheres
+    glm::vec3 minimum{ std::numeric_limits<float>::max() };
+    glm::vec3 maximum{ std::numeric_limits<float>::lowest() };
+    for (const Primitive& primitive : mesh.primitives) {
+        minimum = glm::min(minimum, primitive.bounds_center - primitive.bounds_radius);
+        maximum = glm::max(maximum, primitive.bounds_center + primitive.bounds_radius);
+    }
+
+    glm::vec3 center = (minimum + maximum) * 0.5F;
+    float     radius = 0.0F;
+    for (const Primitive& primitive : mesh.primitives) {
+        radius = std::max(radius, glm::length(primitive.bounds_center - center) + primitive.bounds_radius);
+    }
+    return LodSelection::getScreenCoverage(center, radius, model, view);
+}
+
+size_t LodSelection::selectPrimitiveLod(const Primitive& primitive, const glm::mat4& model, const LodView& view) {
+    if (primitive.lods.empty()) {
+        return 0;
+    }
+
+    float scale = LodSelection::getErrorScale(primitive.bounds_center, primitive.bounds_radius, model, view);
+
+    size_t lod = 0;
+    while (lod < primitive.lods.size() && primitive.lods[lod].error * scale <= view.pixel_error) { // errors only grow along the chain
+        lod++;
+    }
+    return lod;
+}
+
+size_t LodSelection::selectNodeLod(const Node& node, float screen_coverage) {
+    size_t levels = node.lods.size() + 1;
+
+    size_t lod = 0;
+    while (lod + 1 < levels) {
+        float threshold = node.screen_coverage.size() == levels ? node.screen_coverage[lod] : DEFAULT_SCREEN_COVERAGE / static_cast<float>(1U << std::min<size_t>(lod, 16));
+        if (screen_coverage >= threshold) {
+            break;
+        }
+        lod++;
+    }
+    return lod;
+}
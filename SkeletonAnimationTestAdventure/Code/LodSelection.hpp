@@ -0,0 +1,40 @@
+#pragma once
+#include "Model.hpp"
+
+class Camera; // forward declaration
+
+// what LOD selection needs to know about the camera
+struct LodView {
+    glm::vec3 camera_position{ 0.0F };
+    float     projection_scale{ 1.0F }; // pixels per world unit at distance 1 : viewport height / ( 2 * tan( fov_y / 2 ) )
+    float     viewport_height{ 1.0F };  // pixels
+    float     pixel_error{ 1.0F };      // largest error a generated LOD may show on screen, in pixels
+
+    LodView()  = default;
+    ~LodView() = default;
+};
+
+// picks detail levels per draw : generated PrimitiveLod levels by screen-space error, MSFT_lod node levels by screen coverage
+class LodSelection {
+public:
+    // MSFT_lod threshold of the node itself when the file gives no MSFT_screencoverage, every further level halves it
+    static constexpr float DEFAULT_SCREEN_COVERAGE = 0.25F;
+
+public:
+    static LodView makeView(const Camera& camera, float pixel_error = 1.0F);
+
+    // pixels on screen per unit of primitive-space error, for a bounding sphere drawn with model
+    // the nearest point of the sphere counts, so a level never pops in the part closest to the camera
+    static float getErrorScale(const glm::vec3& center, float radius, const glm::mat4& model, const LodView& view);
+
+    // share of the viewport height the sphere covers, 1 with the camera inside it
+    static float getScreenCoverage(const glm::vec3& center, float radius, const glm::mat4& model, const LodView& view);
+    static float getScreenCoverage(const Mesh& mesh, const glm::mat4& model, const LodView& view);
+
+    // 0 - the primitive itself, i - primitive.lods[i - 1] : the coarsest level whose error stays under view.pixel_error
+    static size_t selectPrimitiveLod(const Primitive& primitive, const glm::mat4& model, const LodView& view);
+
+    // 0 - the node itself, i - node.lods[i - 1] : the coarsest level whose screen coverage threshold is still reached
+    // the coarsest level is kept below the last threshold, nothing is culled here
+    static size_t selectNodeLod(const Node& node, float screen_coverage);
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+// read-only memory mapping of a whole file
+// the mapped bytes stay valid until Release() or destruction
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { this->Release(); }
+
+    void Release();
+    bool Initialize(const std::filesystem::path& path);
+
+    inline const uint8_t*           data() const noexcept { return m_data; }
+    inline size_t                   size() const noexcept { return m_size; }
+    inline std::span<const uint8_t> bytes() const noexcept { return { m_data, m_size }; }
+    inline bool                     isMapped() const noexcept { return m_data != nullptr; }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+private:
+    const uint8_t* m_data{ nullptr };
+    size_t         m_size{ 0 };
+
+#ifdef _WIN32
+    void* m_file{ nullptr };    // HANDLE
+    void* m_mapping{ nullptr }; // HANDLE
+#else
+    int m_file{ -1 };
+#endif
+};
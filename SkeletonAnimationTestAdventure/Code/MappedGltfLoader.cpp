@@ -0,0 +1,206 @@
+#include "MappedGltfLoader.hpp"
+
+#include <cstring>
+
+#include "GltfSaxParser.hpp"
+
+static constexpr uint32_t GLB_MAGIC           = 0x46546C67; // "glTF"
+static constexpr uint32_t GLB_VERSION         = 2;
+static constexpr uint32_t GLB_CHUNK_JSON      = 0x4E4F534A; // "JSON"
+static constexpr uint32_t GLB_CHUNK_BIN       = 0x004E4942; // "BIN\0"
+static constexpr size_t   GLB_HEADER_SIZE     = 12;
+static constexpr size_t   GLB_CHUNK_HEAD_SIZE = 8;
+
+static uint32_t readU32(const uint8_t* data) {
+    uint32_t value{};
+    memcpy(&value, data, sizeof(uint32_t));
+    return value;
+}
+
+bool MappedGltfLoader::Load(const tinygltf::LoadImageDataFunction& load_image, tinygltf::Model* model, std::string* error, std::string* warning, const std::filesystem::path& path) {
+    std::span<const uint8_t> json_chunk{};
+    std::span<const uint8_t> bin_chunk{};
+    if (!this->openFile(path, json_chunk, bin_chunk, error)) {
+        return false;
+    }
+
+    std::vector<size_t> buffer_lengths{};
+    if (!GltfSaxParser::Parse(json_chunk, model, &buffer_lengths, error, warning)) {
+        return false;
+    }
+
+    std::filesystem::path base_dir = path.parent_path();
+
+    for (size_t i = 0; i < model->buffers.size(); i++) {
+        const tinygltf::Buffer& buffer = model->buffers[i];
+
+        auto meshopt  = buffer.extensions.find("EXT_meshopt_compression");
+        bool fallback = meshopt != buffer.extensions.end() && meshopt->second.Has("fallback") && meshopt->second.Get("fallback").IsBool() && meshopt->second.Get("fallback").Get<bool>();
+
+        if (!this->mapBuffer(buffer.uri, buffer_lengths[i], fallback, base_dir, bin_chunk, error)) {
+            return false;
+        }
+    }
+    model->buffers.clear(); // the data is in getBuffers()
+
+    return this->loadImages(load_image, model, base_dir, error, warning);
+}
+
+void MappedGltfLoader::releaseMappings() {
+    m_buffers.clear();
+    m_files.clear(); // last, the spans above point into them
+}
+
+bool MappedGltfLoader::openFile(const std::filesystem::path& path, std::span<const uint8_t>& json_chunk, std::span<const uint8_t>& bin_chunk, std::string* error) {
+    m_files.clear();
+    m_buffers.clear();
+    m_bufferUris.clear();
+
+    bool is_binary = path.extension() == ".glb";
+    if (!is_binary && path.extension() != ".gltf") {
+        *error += "Unknown glTF extension : " + path.extension().string() + "\n";
+        return false;
+    }
+
+    MappedFile& file = m_files.emplace_back();
+    if (!file.Initialize(path)) {
+        *error += "Failed to map file : " + path.string() + "\n";
+        return false;
+    }
+
+    return this->readContainer(file, is_binary, json_chunk, bin_chunk, error);
+}
+
+bool MappedGltfLoader::readContainer(const MappedFile& file, bool is_binary, std::span<const uint8_t>& json_chunk, std::span<const uint8_t>& bin_chunk, std::string* error) const {
+    if (!is_binary) {
+        json_chunk = file.bytes();
+        return true;
+    }
+
+    const uint8_t* data = file.data();
+    size_t         size = file.size();
+
+    if (size < GLB_HEADER_SIZE + GLB_CHUNK_HEAD_SIZE || readU32(data) != GLB_MAGIC || readU32(data + 4) != GLB_VERSION) {
+        *error += "Invalid GLB header\n";
+        return false;
+    }
+
+    size_t total_length = std::min<size_t>(readU32(data + 8), size);
+    size_t offset       = GLB_HEADER_SIZE;
+
+    while (offset + GLB_CHUNK_HEAD_SIZE <= total_length) {
+        size_t   chunk_length = readU32(data + offset);
+        uint32_t chunk_type   = readU32(data + offset + 4);
+        offset += GLB_CHUNK_HEAD_SIZE;
+
+        if (offset + chunk_length > total_length) {
+            *error += "GLB chunk exceeds the file size\n";
+            return false;
+        }
+
+        if (chunk_type == GLB_CHUNK_JSON && json_chunk.empty()) {
+            json_chunk = { data + offset, chunk_length };
+        }
+        else if (chunk_type == GLB_CHUNK_BIN && bin_chunk.empty()) {
+            bin_chunk = { data + offset, chunk_length };
+        }
+
+        offset += (chunk_length + 3) & ~size_t{ 3 }; // chunks are 4-byte aligned
+    }
+
+    if (json_chunk.empty()) {
+        *error += "GLB has no JSON chunk\n";
+        return false;
+    }
+    return true;
+}
+
+bool MappedGltfLoader::mapBuffer(const std::string& uri, size_t byte_length, bool meshopt_fallback, const std::filesystem::path& base_dir, std::span<const uint8_t> bin_chunk, std::string* error) {
+    // EXT_meshopt_compression placeholder for the decoded bufferViews, it has no data to map
+    if (uri.empty() && meshopt_fallback) {
+        m_buffers.emplace_back();
+        m_bufferUris.emplace_back();
+        return true;
+    }
+
+    if (uri.empty()) { // GLB BIN chunk
+        if (byte_length > bin_chunk.size()) {
+            *error += "Buffer is larger than the GLB BIN chunk\n";
+            return false;
+        }
+        m_buffers.emplace_back(bin_chunk.data(), byte_length);
+        m_bufferUris.emplace_back();
+        return true;
+    }
+
+    if (tinygltf::IsDataURI(uri)) { // base64 has to be decoded anyway, nothing to map
+        *error += "Data URI buffers are not supported by the mapped loader\n";
+        return false;
+    }
+
+    std::string decoded_uri{};
+    tinygltf::URIDecode(uri, &decoded_uri, nullptr);
+
+    MappedFile& file = m_files.emplace_back();
+    if (!file.Initialize(base_dir / std::filesystem::u8path(decoded_uri))) {
+        *error += "Failed to map buffer file : " + decoded_uri + "\n";
+        return false;
+    }
+    if (byte_length > file.size()) {
+        *error += "Buffer file is smaller than its byteLength : " + decoded_uri + "\n";
+        return false;
+    }
+    m_buffers.emplace_back(file.data(), byte_length);
+    m_bufferUris.emplace_back(std::move(decoded_uri));
+    return true;
+}
+
+bool MappedGltfLoader::loadImages(const tinygltf::LoadImageDataFunction& load_image, tinygltf::Model* model, const std::filesystem::path& base_dir, std::string* error, std::string* warning) const {
+    for (size_t i = 0; i < model->images.size(); i++) {
+        tinygltf::Image&           image = model->images[i];
+        int                        index = static_cast<int>(i);
+        std::vector<unsigned char> data{};
+        std::span<const uint8_t>   bytes{};
+
+        if (image.bufferView >= 0) { // straight from the mapping
+            if (static_cast<size_t>(image.bufferView) >= model->bufferViews.size()) {
+                *error += "Image references a missing bufferView\n";
+                return false;
+            }
+            const tinygltf::BufferView& buffer_view = model->bufferViews[image.bufferView];
+            if (buffer_view.buffer < 0 || static_cast<size_t>(buffer_view.buffer) >= m_buffers.size() || buffer_view.byteOffset + buffer_view.byteLength > m_buffers[buffer_view.buffer].size()) {
+                *error += "Image bufferView is out of its buffer bounds\n";
+                return false;
+            }
+            bytes = m_buffers[buffer_view.buffer].subspan(buffer_view.byteOffset, buffer_view.byteLength);
+        }
+        else if (tinygltf::IsDataURI(image.uri)) {
+            std::string uri = std::move(image.uri);
+            image.uri.clear();
+            if (!tinygltf::DecodeDataURI(&data, image.mimeType, uri, 0, false)) {
+                *error += "Failed to decode 'uri' for image[" + std::to_string(i) + "] name = \"" + image.name + "\"\n";
+                return false;
+            }
+            bytes = data;
+        }
+        else {
+            std::string decoded_uri{};
+            std::string file_error{};
+            tinygltf::URIDecode(image.uri, &decoded_uri, nullptr);
+            if (!tinygltf::ReadWholeFile(&data, &file_error, (base_dir / std::filesystem::u8path(decoded_uri)).string(), nullptr) || data.empty()) {
+                // not fatal, like in tinygltf the image keeps its uri and gets no data
+                *warning += "Failed to load external 'uri' for image[" + std::to_string(i) + "] name = \"" + decoded_uri + "\"\n";
+                continue;
+            }
+            bytes = data;
+        }
+
+        int width  = image.bufferView >= 0 ? image.width : 0;
+        int height = image.bufferView >= 0 ? image.height : 0;
+        if (!load_image(&image, index, error, warning, width, height, bytes.data(), static_cast<int>(bytes.size()), nullptr)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <span>
+#include <string>
+#include <vector>
+
+#include "tiny_gltf.h"
+#include "MappedFile.hpp"
+
+// Loads .gltf/.glb through memory mappings instead of heap reads
+// The JSON goes through GltfSaxParser once, no DOM is built and tinygltf never sees the buffers. They are never copied :
+// getBuffers()[i] views the GLB BIN chunk or the mapped external .bin file of model.buffers[i]
+// Embedded images are served to the image loader from the mapping, only their encoded bytes get copied
+// EXT_meshopt_compression fallback buffers ( no uri ) get an empty view
+// The views are valid while this loader is alive
+class MappedGltfLoader {
+public:
+    MappedGltfLoader()  = default;
+    ~MappedGltfLoader() = default;
+
+    // on success model->buffers stays empty, use getBuffers() instead
+    // load_image gets every image's encoded bytes, embedded ones straight from the mapping
+    // returns false for inputs this path does not handle (data URIs, broken GLB containers). Then a regular load should be used
+    bool Load(const tinygltf::LoadImageDataFunction& load_image, tinygltf::Model* model, std::string* error, std::string* warning, const std::filesystem::path& path);
+
+    inline const std::vector<std::span<const uint8_t>>& getBuffers() const noexcept { return m_buffers; }
+    inline const std::vector<std::string>&              getBufferUris() const noexcept { return m_bufferUris; }
+
+    // unmaps the files once nothing reads the buffers anymore, getBuffers() is empty after it. getBufferUris() stays
+    void releaseMappings();
+
+    MappedGltfLoader(const MappedGltfLoader&)            = delete;
+    MappedGltfLoader& operator=(const MappedGltfLoader&) = delete;
+
+private:
+    bool openFile(const std::filesystem::path& path, std::span<const uint8_t>& json_chunk, std::span<const uint8_t>& bin_chunk, std::string* error);
+    bool readContainer(const MappedFile& file, bool is_binary, std::span<const uint8_t>& json_chunk, std::span<const uint8_t>& bin_chunk, std::string* error) const;
+    bool mapBuffer(const std::string& uri, size_t byte_length, bool meshopt_fallback, const std::filesystem::path& base_dir, std::span<const uint8_t> bin_chunk, std::string* error);
+
+    bool loadImages(const tinygltf::LoadImageDataFunction& load_image, tinygltf::Model* model, const std::filesystem::path& base_dir, std::string* error, std::string* warning) const;
+
+private:
+    std::vector<MappedFile>               m_files; // [0] - the .gltf / .glb itself, then external .bin files
+    std::vector<std::span<const uint8_t>> m_buffers;
+    std::vector<std::string>              m_bufferUris; // decoded uri of every external .bin, empty for the GLB BIN chunk
+};
@@ -0,0 +1,289 @@
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+// sum of squared distances to a set of planes, area weighted : p' A p + 2 b' p + c
+struct Quadric {
+    double a00{ 0 }, a01{ 0 }, a02{ 0 }, a11{ 0 }, a12{ 0 }, a22{ 0 };
+    double b0{ 0 }, b1{ 0 }, b2{ 0 };
+    double c{ 0 };
+    double weight{ 0 };
+
+    static Quadric fromPlane(const glm::vec3& normal, float distance, float weight) {
+        Quadric q{};
+        double  x = normal.x;
+        double  y = normal.y;
+        double  z = normal.z;
+        double  d = distance;
+        double  w = weight;
+
+        q.a00    = w * x * x;
+        q.a01    = w * x * y;
+        q.a02    = w * x * z;
+        q.a11    = w * y * y;
+        q.a12    = w * y * z;
+        q.a22    = w * z * z;
+        q.b0     = w * x * d;
+        q.b1     = w * y * d;
+        q.b2     = w * z * d;
+        q.c      = w * d * d;
+        q.weight = w;
+        return q;
+    }
+
+    void add(const Quadric& other) {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+    }
+
+    // weighted mean squared distance of point to the planes
+    double evaluate(const glm::vec3& point) const {
+        double x = point.x;
+        double y = point.y;
+        double z = point.z;
+
+        double error = (a00 * x * x) + (a11 * y * y) + (a22 * z * z) +
+                       (2.0 * ((a01 * x * y) + (a02 * x * z) + (a12 * y * z))) +
+                       (2.0 * ((b0 * x) + (b1 * y) + (b2 * z))) + c;
+        return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+    }
+
+    Quadric()  = default;
+    ~Quadric() = default;
+};
+
+struct Collapse {
+    uint32_t from{ 0 };
+    uint32_t to{ 0 };
+    double   cost{ 0 };
+};
+
+static inline uint64_t edgeKey(uint32_t a, uint32_t b) {
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+// joint with the largest weight, -1 for an unskinned vertex
+static int getDominantJoint(const Vertex& vertex) {
+    int   joint  = -1;
+    float weight = 0.0F;
+    for (int i = 0; i < 4; i++) {
+        if (vertex.weights[i] > weight) {
+            weight = vertex.weights[i];
+            joint  = vertex.joints[i];
+        }
+    }
+    return joint;
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const Vertices&              vertices,
+                                               const std::vector<uint32_t>& indices,
+                                               size_t                       target_index_count,
+                                               float                        target_error,
+                                               float*                       result_error) {
+    std::vector<uint32_t> result(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(indices.size() / 3 * 3));
+    size_t                vertices_count = vertices.size();
+
+    if (result_error != nullptr) {
+        *result_error = 0.0F;
+    }
+    for (uint32_t index : result) {
+        if (index >= vertices_count) {
+            throw std::runtime_error("Index is out of the vertex range");
+        }
+    }
+
+    // open and non-manifold edges lock both of their vertices
+    std::vector<bool> locked(vertices_count, false);
+    {
+        std::unordered_map<uint64_t, uint32_t> half_edges{};
+        half_edges.reserve(result.size());
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (size_t e = 0; e < 3; e++) {
+                half_edges[edgeKey(result[i + e], result[i + ((e + 1) % 3)])]++;
+            }
+        }
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (size_t e = 0; e < 3; e++) {
+                uint32_t a    = result[i + e];
+                uint32_t b    = result[i + ((e + 1) % 3)];
+                auto     twin = half_edges.find(edgeKey(b, a));
+                if (twin == half_edges.end() || twin->second != 1 || half_edges[edgeKey(a, b)] != 1) {
+                    locked[a] = true;
+                    locked[b] = true;
+                }
+            }
+        }
+    }
+
+    std::vector<int> dominant_joints(vertices_count);
+    for (size_t i = 0; i < vertices_count; i++) {
+        dominant_joints[i] = getDominantJoint(vertices[i]);
+    }
+
+    std::vector<Quadric> quadrics(vertices_count);
+    for (size_t i = 0; i < result.size(); i += 3) {
+        const glm::vec3& p0 = vertices[result[i + 0]].position;
+        const glm::vec3& p1 = vertices[result[i + 1]].position;
+        const glm::vec3& p2 = vertices[result[i + 2]].position;
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float     length = glm::length(normal);
+        if (length == 0.0F) {
+            continue;
+        }
+        normal /= length;
+
+        Quadric plane = Quadric::fromPlane(normal, -glm::dot(normal, p0), length * 0.5F);
+        for (size_t c = 0; c < 3; c++) {
+            quadrics[result[i + c]].add(plane);
+        }
+    }
+
+    double                max_cost   = 0.0;
+    double                cost_limit = static_cast<double>(target_error) * static_cast<double>(target_error);
+    std::vector<uint32_t> offsets{};
+    std::vector<uint32_t> adjacency{};
+    std::vector<Collapse> candidates{};
+    std::vector<uint32_t> remap(vertices_count);
+    std::vector<bool>     touched(vertices_count);
+
+    // moving from onto to must not turn any of the triangles around from that stay over
+    auto flips = [&](uint32_t from, uint32_t to) {
+        const glm::vec3& target = vertices[to].position;
+        for (uint32_t k = offsets[from]; k < offsets[from + 1]; k++) {
+            const uint32_t* triangle = &result[static_cast<size_t>(adjacency[k]) * 3];
+            if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                continue; // collapses away
+            }
+
+            glm::vec3 p[3]{};
+            glm::vec3 moved[3]{};
+            for (size_t c = 0; c < 3; c++) {
+                p[c]     = vertices[triangle[c]].position;
+                moved[c] = triangle[c] == from ? target : p[c];
+            }
+            glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::vec3 after  = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+            if (glm::dot(before, after) <= 1e-2F * glm::length(before) * glm::length(after)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // passes of independent collapses, cheapest first, until the target count or the error limit stops them
+    while (result.size() > target_index_count) {
+        size_t triangles_count = result.size() / 3;
+
+        offsets.assign(vertices_count + 1, 0);
+        for (uint32_t index : result) {
+            offsets[index + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++) {
+                adjacency[fill[result[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // every interior edge is seen from both of its triangles, a < b keeps one of them
+        candidates.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (size_t e = 0; e < 3; e++) {
+                uint32_t a = result[i + e];
+                uint32_t b = result[i + ((e + 1) % 3)];
+                if (a >= b || dominant_joints[a] != dominant_joints[b]) {
+                    continue;
+                }
+
+                Quadric quadric = quadrics[a];
+                quadric.add(quadrics[b]);
+
+                Collapse best{ a, b, -1.0 };
+                if (!locked[a]) {
+                    best.cost = quadric.evaluate(vertices[b].position);
+                }
+                if (!locked[b]) {
+                    double cost = quadric.evaluate(vertices[a].position);
+                    if (best.cost < 0.0 || cost < best.cost) {
+                        best = { b, a, cost };
+                    }
+                }
+                if (best.cost >= 0.0 && best.cost <= cost_limit) {
+                    candidates.push_back(best);
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        std::iota(remap.begin(), remap.end(), 0);
+        touched.assign(vertices_count, false);
+
+        size_t triangles_to_remove = (result.size() - target_index_count + 2) / 3;
+        size_t triangles_removed   = 0;
+        size_t collapses           = 0;
+
+        for (const Collapse& collapse : candidates) {
+            if (touched[collapse.from] || touched[collapse.to] || flips(collapse.from, collapse.to)) {
+                continue;
+            }
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            max_cost = std::max(max_cost, collapse.cost);
+            collapses++;
+
+            // the whole one-ring waits for the next pass, the flip tests above assumed it does not move
+            for (uint32_t k = offsets[collapse.from]; k < offsets[collapse.from + 1]; k++) {
+                const uint32_t* triangle = &result[static_cast<size_t>(adjacency[k]) * 3];
+                for (size_t c = 0; c < 3; c++) {
+                    touched[triangle[c]] = true;
+                }
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                    triangles_removed++;
+                }
+            }
+
+            if (triangles_removed >= triangles_to_remove) {
+                break;
+            }
+        }
+
+        if (collapses == 0) {
+            break;
+        }
+
+        size_t write = 0;
+        for (size_t t = 0; t < triangles_count; t++) {
+            uint32_t a = remap[result[(t * 3) + 0]];
+            uint32_t b = remap[result[(t * 3) + 1]];
+            uint32_t c = remap[result[(t * 3) + 2]];
+            if (a == b || b == c || a == c) {
+                continue;
+            }
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (result_error != nullptr) {
+        *result_error = static_cast<float>(std::sqrt(max_cost));
+    }
+    return result;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <vector>
+
+#include "VertexBuffers.hpp"
+
+// quadric error metric simplification ( Garland, Heckbert - "Surface Simplification Using Quadric Error Metrics", 1997 )
+// with half-edge collapses only : a vertex is always merged into one of its neighbours, so the result is an index list
+// into the same vertices and every attribute ( UVs, normals, joints / weights ) of a kept vertex is the loaded one
+class MeshSimplifier {
+public:
+    // vertices on an open edge never move : mesh borders and attribute seams ( UV / normal splits are open edges
+    // in index space ). Two vertices only merge if the same joint dominates both, skinned parts stay on their bones
+    // target_error - largest allowed surface deviation, in vertex position units
+    // result_error - the deviation actually reached, may be nullptr
+    static std::vector<uint32_t> simplify(const Vertices&              vertices,
+                                          const std::vector<uint32_t>& indices,
+                                          size_t                       target_index_count,
+                                          float                        target_error,
+                                          float*                       result_error = nullptr);
+};
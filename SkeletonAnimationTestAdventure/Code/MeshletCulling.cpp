@@ -0,0 +1,77 @@
+#include "MeshletCulling.hpp"
+
+#include "Camera.hpp"
+
+Frustum Frustum::fromMatrix(const glm::mat4& matrix) {
+    // Gribb & Hartmann, OpenGL clip space : -w <= x, y, z <= w
+    glm::mat4 rows = glm::transpose(matrix);
+
+    Frustum frustum{};
+    frustum.planes[0] = rows[3] + rows[0]; // left
+    frustum.planes[1] = rows[3] - rows[0]; // right
+    frustum.planes[2] = rows[3] + rows[1]; // bottom
+    frustum.planes[3] = rows[3] - rows[1]; // top
+    frustum.planes[4] = rows[3] + rows[2]; // near
+    frustum.planes[5] = rows[3] - rows[2]; // far
+
+    for (glm::vec4& plane : frustum.planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0F) {
+            plane /= length;
+        }
+    }
+    return frustum;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+    for (const glm::vec4& plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MeshletCulling::View MeshletCulling::makeView(const glm::mat4& view_projection, const glm::vec3& camera_position, const glm::mat4& model) {
+    View view{};
+    view.frustum         = Frustum::fromMatrix(view_projection * model);
+    view.camera_position = glm::vec3(glm::inverse(model) * glm::vec4(camera_position, 1.0F));
+
+    float scale_x     = glm::length(glm::vec3(model[0]));
+    float scale_y     = glm::length(glm::vec3(model[1]));
+    float scale_z     = glm::length(glm::vec3(model[2]));
+    float tolerance   = 1e-3F * std::max({ scale_x, scale_y, scale_z });
+    view.cone_culling = std::abs(scale_x - scale_y) <= tolerance && std::abs(scale_x - scale_z) <= tolerance;
+
+    return view;
+}
+
+MeshletCulling::View MeshletCulling::makeView(const Camera& camera, const glm::mat4& model) {
+    return MeshletCulling::makeView(camera.getMatrix(), camera.getPosition(), model);
+}
+
+bool MeshletCulling::isVisible(const Meshlet& meshlet, const View& view) {
+    if (!view.frustum.intersectsSphere(meshlet.center, meshlet.radius)) {
+        return false;
+    }
+
+    if (view.cone_culling && meshlet.cone_cutoff < 1.0F) {
+        glm::vec3 direction = meshlet.cone_apex - view.camera_position;
+        float     distance  = glm::length(direction);
+        if (distance > 0.0F && glm::dot(direction / distance, meshlet.cone_axis) >= meshlet.cone_cutoff) {
+            return false; // every triangle faces away
+        }
+    }
+    return true;
+}
+
+size_t MeshletCulling::cullMeshlets(const Primitive& primitive, const View& view, std::vector<uint32_t>& visible) {
+    size_t count = 0;
+    for (size_t i = 0; i < primitive.meshlets.size(); i++) {
+        if (MeshletCulling::isVisible(primitive.meshlets[i], view)) {
+            visible.push_back(static_cast<uint32_t>(i));
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <array>
+#include <vector>
+
+#include "Model.hpp"
+
+class Camera; // forward declaration
+
+// six planes ( xyz - inward normal, w - distance ), extracted from a projection * view ( * model ) matrix
+struct Frustum {
+    std::array<glm::vec4, 6> planes{};
+
+    static Frustum fromMatrix(const glm::mat4& matrix);
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const;
+
+    Frustum()  = default;
+    ~Frustum() = default;
+};
+
+// CPU-side meshlet culling, works in primitive space : the camera is moved into it instead of moving every meshlet out
+class MeshletCulling {
+public:
+    struct View {
+        Frustum   frustum{};
+        glm::vec3 camera_position{ 0.0F };
+        bool      cone_culling{ true }; // off under non-uniform scale, the cones are not valid there
+
+        View()  = default;
+        ~View() = default;
+    };
+
+    // model - global matrix of the node the primitive is drawn with
+    static View makeView(const glm::mat4& view_projection, const glm::vec3& camera_position, const glm::mat4& model);
+    static View makeView(const Camera& camera, const glm::mat4& model);
+
+    static bool isVisible(const Meshlet& meshlet, const View& view);
+
+    // appends the indices of the visible meshlets, returns how many were appended
+    static size_t cullMeshlets(const Primitive& primitive, const View& view, std::vector<uint32_t>& visible);
+};
@@ -0,0 +1,816 @@
+#include "MeshoptDecoder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "AccessorConversion.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MESHOPT_DECODER_SSE41 1
+#include <smmintrin.h>
+#ifdef _MSC_VER
+#define SSE41_TARGET
+#else
+#define SSE41_TARGET __attribute__((target("sse4.1")))
+#endif
+#else
+#define MESHOPT_DECODER_SSE41 0
+#endif
+
+// bitstream constants of meshoptimizer's vertexcodec.cpp / indexcodec.cpp
+static constexpr uint8_t VERTEX_HEADER         = 0xA0;
+static constexpr uint8_t INDEX_HEADER          = 0xE0;
+static constexpr uint8_t SEQUENCE_HEADER       = 0xD0;
+static constexpr size_t  BYTE_GROUP_SIZE       = 16;
+static constexpr size_t  VERTEX_BLOCK_BYTES    = 8192;
+static constexpr size_t  VERTEX_BLOCK_MAX_SIZE = 256;
+static constexpr size_t  TAIL_MAX_SIZE         = 32;
+static constexpr size_t  MAX_VERTEX_STRIDE     = 256;
+static constexpr size_t  INDEX_AUX_TABLE_SIZE  = 16;
+
+[[noreturn]] static void throwMalformed(const char* what) {
+    throw std::runtime_error(std::string("Malformed EXT_meshopt_compression data : ") + what);
+}
+
+static inline uint8_t unzigzag8(uint8_t value) {
+    return static_cast<uint8_t>(-(value & 1) ^ (value >> 1));
+}
+
+// 16 deltas of BITS bits ( first one in the high bits ), the all-ones value means "the next extra byte"
+template <int BITS>
+static const uint8_t* decodePackedGroup(const uint8_t* data, const uint8_t* end, uint8_t* out) {
+    constexpr size_t  PACKED_SIZE = BYTE_GROUP_SIZE * BITS / 8;
+    constexpr uint8_t SENTINEL    = (1 << BITS) - 1;
+
+    if (static_cast<size_t>(end - data) < PACKED_SIZE) {
+        throwMalformed("vertex group is truncated");
+    }
+
+    const uint8_t* extra = data + PACKED_SIZE;
+    for (size_t i = 0; i < BYTE_GROUP_SIZE; i++) {
+        size_t  bit   = i * BITS;
+        uint8_t value = (data[bit / 8] >> (8 - BITS - (bit % 8))) & SENTINEL;
+        if (value == SENTINEL) {
+            if (extra >= end) {
+                throwMalformed("vertex group is truncated");
+            }
+            value = *extra++;
+        }
+        out[i] = value;
+    }
+    return extra;
+}
+
+// one byte of every vertex in a block : 2-bit group modes, then the groups
+using BytesDecodeFunction = const uint8_t* (*)(const uint8_t* data, const uint8_t* end, uint8_t* buffer, size_t buffer_size);
+
+static const uint8_t* decodeBytesScalar(const uint8_t* data, const uint8_t* end, uint8_t* buffer, size_t buffer_size) {
+    size_t groups      = buffer_size / BYTE_GROUP_SIZE;
+    size_t header_size = (groups + 3) / 4;
+    if (static_cast<size_t>(end - data) < header_size) {
+        throwMalformed("vertex block header is truncated");
+    }
+
+    const uint8_t* header = data;
+    data += header_size;
+
+    for (size_t group = 0; group < groups; group++) {
+        uint8_t* out = buffer + (group * BYTE_GROUP_SIZE);
+        switch ((header[group / 4] >> ((group % 4) * 2)) & 3) {
+            case 0:
+                memset(out, 0, BYTE_GROUP_SIZE);
+                break;
+            case 1:
+                data = decodePackedGroup<2>(data, end, out);
+                break;
+            case 2:
+                data = decodePackedGroup<4>(data, end, out);
+                break;
+            default:
+                if (static_cast<size_t>(end - data) < BYTE_GROUP_SIZE) {
+                    throwMalformed("vertex group is truncated");
+                }
+                memcpy(out, data, BYTE_GROUP_SIZE);
+                data += BYTE_GROUP_SIZE;
+                break;
+        }
+    }
+    return data;
+}
+
+#if MESHOPT_DECODER_SSE41
+
+// per 8 sentinel flags : where every flagged lane finds its extra byte ( 0x80 - keep the lane ), and how many it takes
+struct GroupShuffleTable {
+    alignas(16) uint8_t shuffle[256][8]{};
+    uint8_t             count[256]{};
+
+    constexpr GroupShuffleTable() {
+        for (int mask = 0; mask < 256; mask++) {
+            uint8_t rank = 0;
+            for (int lane = 0; lane < 8; lane++) {
+                shuffle[mask][lane] = (mask & (1 << lane)) != 0 ? rank++ : 0x80;
+            }
+            count[mask] = rank;
+        }
+    }
+};
+
+static constexpr GroupShuffleTable GROUP_SHUFFLE_TABLE{};
+
+// sel - the 16 unpacked values, the sentinel ones are replaced by the extra bytes at rest
+SSE41_TARGET static inline const uint8_t* resolveSentinelsSse41(__m128i sel, __m128i sentinel, const uint8_t* rest, uint8_t* out) {
+    __m128i mask   = _mm_cmpeq_epi8(sel, sentinel);
+    int     mask16 = _mm_movemask_epi8(mask);
+    int     mask0  = mask16 & 255;
+    int     mask1  = mask16 >> 8;
+
+    __m128i shuffle0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(GROUP_SHUFFLE_TABLE.shuffle[mask0]));
+    __m128i shuffle1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(GROUP_SHUFFLE_TABLE.shuffle[mask1]));
+    shuffle1         = _mm_add_epi8(shuffle1, _mm_set1_epi8(static_cast<char>(GROUP_SHUFFLE_TABLE.count[mask0])));
+
+    __m128i extra = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rest)), _mm_unpacklo_epi64(shuffle0, shuffle1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_or_si128(extra, _mm_andnot_si128(mask, sel)));
+    return rest + GROUP_SHUFFLE_TABLE.count[mask0] + GROUP_SHUFFLE_TABLE.count[mask1];
+}
+
+// the packed groups unpack with shifts / interleaves and take their extra bytes with one shuffle
+// a group reads up to 24 bytes ahead, the few near the end of the buffer go the scalar way
+SSE41_TARGET static const uint8_t* decodeBytesSse41(const uint8_t* data, const uint8_t* end, uint8_t* buffer, size_t buffer_size) {
+    size_t groups      = buffer_size / BYTE_GROUP_SIZE;
+    size_t header_size = (groups + 3) / 4;
+    if (static_cast<size_t>(end - data) < header_size) {
+        throwMalformed("vertex block header is truncated");
+    }
+
+    const uint8_t* header = data;
+    data += header_size;
+
+    for (size_t group = 0; group < groups; group++) {
+        uint8_t* out  = buffer + (group * BYTE_GROUP_SIZE);
+        int      mode = (header[group / 4] >> ((group % 4) * 2)) & 3;
+
+        if ((mode == 1 || mode == 2) && static_cast<size_t>(end - data) < 8 + BYTE_GROUP_SIZE) {
+            data = mode == 1 ? decodePackedGroup<2>(data, end, out) : decodePackedGroup<4>(data, end, out);
+            continue;
+        }
+
+        switch (mode) {
+            case 0:
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_setzero_si128());
+                break;
+            case 1: {
+                int packed{};
+                memcpy(&packed, data, sizeof(int));
+                __m128i sel2    = _mm_cvtsi32_si128(packed);
+                __m128i sel22   = _mm_unpacklo_epi8(_mm_srli_epi16(sel2, 4), sel2);
+                __m128i sel2222 = _mm_unpacklo_epi8(_mm_srli_epi16(sel22, 2), sel22);
+                __m128i sel     = _mm_and_si128(sel2222, _mm_set1_epi8(3));
+                data            = resolveSentinelsSse41(sel, _mm_set1_epi8(3), data + 4, out);
+                break;
+            }
+            case 2: {
+                __m128i sel4  = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+                __m128i sel44 = _mm_unpacklo_epi8(_mm_srli_epi16(sel4, 4), sel4);
+                __m128i sel   = _mm_and_si128(sel44, _mm_set1_epi8(15));
+                data          = resolveSentinelsSse41(sel, _mm_set1_epi8(15), data + 8, out);
+                break;
+            }
+            default:
+                if (static_cast<size_t>(end - data) < BYTE_GROUP_SIZE) {
+                    throwMalformed("vertex group is truncated");
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+                data += BYTE_GROUP_SIZE;
+                break;
+        }
+    }
+    return data;
+}
+
+#endif
+
+static BytesDecodeFunction selectBytesDecode() {
+#if MESHOPT_DECODER_SSE41
+    if (hasSse41Converters()) {
+        return &decodeBytesSse41;
+    }
+#endif
+    return &decodeBytesScalar;
+}
+
+// zigzag deltas of 4 byte channels ( VERTEX_BLOCK_MAX_SIZE apart ) -> 4 bytes of every vertex, written stride apart
+// previous holds the channels' last bytes, the next block continues from them
+using DeltaDecodeFunction = void (*)(const uint8_t* deltas, size_t count, uint8_t* previous, uint8_t* dst, size_t stride);
+
+static void decodeDeltasScalar(const uint8_t* deltas, size_t count, uint8_t* previous, uint8_t* dst, size_t stride) {
+    for (size_t c = 0; c < 4; c++) {
+        const uint8_t* channel = deltas + (c * VERTEX_BLOCK_MAX_SIZE);
+        uint8_t        value   = previous[c];
+        for (size_t i = 0; i < count; i++) {
+            value += unzigzag8(channel[i]);
+            dst[(i * stride) + c] = value;
+        }
+        previous[c] = value;
+    }
+}
+
+#if MESHOPT_DECODER_SSE41
+
+// 16 deltas of a channel at once : unzigzag, then a log-step prefix sum across the lanes
+SSE41_TARGET static inline __m128i decodeDeltaGroupSse41(const uint8_t* deltas, uint8_t previous) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas)); // deltas are padded to whole groups
+    v         = _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(v, 1), _mm_set1_epi8(0x7F)),
+                              _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi8(1))));
+
+    v = _mm_add_epi8(v, _mm_slli_si128(v, 1));
+    v = _mm_add_epi8(v, _mm_slli_si128(v, 2));
+    v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+    v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+    return _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(previous)));
+}
+
+// the 4 channels are transposed into 16 4-byte vertex slices, one 32-bit store per vertex
+SSE41_TARGET static void decodeDeltasSse41(const uint8_t* deltas, size_t count, uint8_t* previous, uint8_t* dst, size_t stride) {
+    alignas(16) uint32_t slices[BYTE_GROUP_SIZE];
+    for (size_t i = 0; i < count; i += BYTE_GROUP_SIZE) {
+        __m128i v0 = decodeDeltaGroupSse41(deltas + i, previous[0]);
+        __m128i v1 = decodeDeltaGroupSse41(deltas + VERTEX_BLOCK_MAX_SIZE + i, previous[1]);
+        __m128i v2 = decodeDeltaGroupSse41(deltas + (2 * VERTEX_BLOCK_MAX_SIZE) + i, previous[2]);
+        __m128i v3 = decodeDeltaGroupSse41(deltas + (3 * VERTEX_BLOCK_MAX_SIZE) + i, previous[3]);
+
+        __m128i t0 = _mm_unpacklo_epi8(v0, v1);
+        __m128i t1 = _mm_unpackhi_epi8(v0, v1);
+        __m128i t2 = _mm_unpacklo_epi8(v2, v3);
+        __m128i t3 = _mm_unpackhi_epi8(v2, v3);
+        _mm_store_si128(reinterpret_cast<__m128i*>(slices + 0), _mm_unpacklo_epi16(t0, t2));
+        _mm_store_si128(reinterpret_cast<__m128i*>(slices + 4), _mm_unpackhi_epi16(t0, t2));
+        _mm_store_si128(reinterpret_cast<__m128i*>(slices + 8), _mm_unpacklo_epi16(t1, t3));
+        _mm_store_si128(reinterpret_cast<__m128i*>(slices + 12), _mm_unpackhi_epi16(t1, t3));
+
+        size_t group_count = std::min(BYTE_GROUP_SIZE, count - i);
+        for (size_t j = 0; j < group_count; j++) {
+            memcpy(dst + ((i + j) * stride), &slices[j], sizeof(uint32_t));
+        }
+        memcpy(previous, &slices[group_count - 1], sizeof(uint32_t));
+    }
+}
+
+#endif
+
+static DeltaDecodeFunction selectDeltaDecode() {
+#if MESHOPT_DECODER_SSE41
+    if (hasSse41Converters()) {
+        return &decodeDeltasSse41;
+    }
+#endif
+    return &decodeDeltasScalar;
+}
+
+static uint32_t decodeVByte(const uint8_t*& data, const uint8_t* end) {
+    if (data >= end) {
+        throwMalformed("index data is truncated");
+    }
+    uint8_t lead = *data++;
+    if (lead < 128) {
+        return lead;
+    }
+
+    uint32_t result = lead & 127;
+    uint32_t shift  = 7;
+    for (int i = 0; i < 4; i++) {
+        if (data >= end) {
+            throwMalformed("index data is truncated");
+        }
+        uint8_t group = *data++;
+        result |= static_cast<uint32_t>(group & 127) << shift;
+        shift += 7;
+        if (group < 128) {
+            break;
+        }
+    }
+    return result;
+}
+
+static uint32_t decodeIndex(const uint8_t*& data, const uint8_t* end, uint32_t last) {
+    uint32_t value = decodeVByte(data, end);
+    return last + ((value >> 1) ^ (0U - (value & 1)));
+}
+
+static void writeIndex(uint8_t* dst, size_t index_size, size_t i, uint32_t value) {
+    if (index_size == 2) {
+        auto value16 = static_cast<uint16_t>(value);
+        memcpy(dst + (i * 2), &value16, sizeof(uint16_t));
+    }
+    else {
+        memcpy(dst + (i * 4), &value, sizeof(uint32_t));
+    }
+}
+
+using FilterFunction = void (*)(uint8_t* data, size_t count);
+
+template <typename T>
+static void filterOctahedralScalar(uint8_t* data, size_t count) {
+    constexpr float MAX = static_cast<float>((1 << ((sizeof(T) * 8) - 1)) - 1);
+
+    for (size_t i = 0; i < count; i++) {
+        T v[4]{};
+        memcpy(v, data + (i * 4 * sizeof(T)), sizeof(v));
+
+        // z holds 1.0 in the same bit count, x / y are the octahedral coordinates
+        auto  x = static_cast<float>(v[0]);
+        auto  y = static_cast<float>(v[1]);
+        float z = static_cast<float>(v[2]) - std::abs(x) - std::abs(y);
+        float t = z < 0.0F ? z : 0.0F;
+        x += x >= 0.0F ? t : -t;
+        y += y >= 0.0F ? t : -t;
+
+        float scale = MAX / std::sqrt((x * x) + (y * y) + (z * z));
+        v[0]        = static_cast<T>(static_cast<int>((x * scale) + (x >= 0.0F ? 0.5F : -0.5F)));
+        v[1]        = static_cast<T>(static_cast<int>((y * scale) + (y >= 0.0F ? 0.5F : -0.5F)));
+        v[2]        = static_cast<T>(static_cast<int>((z * scale) + (z >= 0.0F ? 0.5F : -0.5F)));
+        memcpy(data + (i * 4 * sizeof(T)), v, sizeof(v)); // w is kept
+    }
+}
+
+static void filterQuaternionScalar(uint8_t* data, size_t count) {
+    const float scale = 1.0F / std::sqrt(2.0F);
+
+    for (size_t i = 0; i < count; i++) {
+        int16_t v[4]{};
+        memcpy(v, data + (i * 8), sizeof(v));
+
+        // w holds the index of the dropped ( largest ) component and the scale of the other three
+        float s = scale / static_cast<float>(v[3] | 3);
+        float x = static_cast<float>(v[0]) * s;
+        float y = static_cast<float>(v[1]) * s;
+        float z = static_cast<float>(v[2]) * s;
+        float w = 1.0F - (x * x) - (y * y) - (z * z);
+        w       = std::sqrt(w >= 0.0F ? w : 0.0F);
+
+        int qc = v[3] & 3;
+        int16_t out[4]{};
+        out[(qc + 1) & 3] = static_cast<int16_t>(static_cast<int>((x * 32767.0F) + (x >= 0.0F ? 0.5F : -0.5F)));
+        out[(qc + 2) & 3] = static_cast<int16_t>(static_cast<int>((y * 32767.0F) + (y >= 0.0F ? 0.5F : -0.5F)));
+        out[(qc + 3) & 3] = static_cast<int16_t>(static_cast<int>((z * 32767.0F) + (z >= 0.0F ? 0.5F : -0.5F)));
+        out[qc]           = static_cast<int16_t>(static_cast<int>((w * 32767.0F) + 0.5F));
+        memcpy(data + (i * 8), out, sizeof(out));
+    }
+}
+
+// count - 32-bit words : 24-bit signed mantissa, 8-bit signed exponent
+static void filterExponentialScalar(uint8_t* data, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t v{};
+        memcpy(&v, data + (i * 4), sizeof(uint32_t));
+
+        int   mantissa = static_cast<int>(v << 8) >> 8;
+        int   exponent = static_cast<int>(v) >> 24;
+        float value    = std::bit_cast<float>(static_cast<uint32_t>(exponent + 127) << 23) * static_cast<float>(mantissa);
+        memcpy(data + (i * 4), &value, sizeof(float));
+    }
+}
+
+#if MESHOPT_DECODER_SSE41
+
+// the kernels below do the scalar math lane by lane ( same operations, same order ), the output is bit-exact with it
+
+SSE41_TARGET static inline __m128 roundingHalf(__m128 value) { // +0.5 or -0.5 by the sign of value
+    return _mm_or_ps(_mm_set1_ps(0.5F), _mm_and_ps(value, _mm_set1_ps(-0.0F)));
+}
+
+SSE41_TARGET static inline void octahedralSse41(__m128& x, __m128& y, __m128& z, float max) {
+    const __m128 sign = _mm_set1_ps(-0.0F);
+
+    z        = _mm_sub_ps(_mm_sub_ps(z, _mm_andnot_ps(sign, x)), _mm_andnot_ps(sign, y));
+    __m128 t = _mm_min_ps(z, _mm_setzero_ps());
+    x        = _mm_add_ps(x, _mm_xor_ps(t, _mm_and_ps(x, sign)));
+    y        = _mm_add_ps(y, _mm_xor_ps(t, _mm_and_ps(y, sign)));
+
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+    __m128 scale  = _mm_div_ps(_mm_set1_ps(max), length);
+
+    x = _mm_mul_ps(x, scale);
+    y = _mm_mul_ps(y, scale);
+    z = _mm_mul_ps(z, scale);
+    x = _mm_add_ps(x, roundingHalf(x));
+    y = _mm_add_ps(y, roundingHalf(y));
+    z = _mm_add_ps(z, roundingHalf(z));
+}
+
+SSE41_TARGET static void filterOctahedral8Sse41(uint8_t* data, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + (i * 4)));
+
+        __m128 x = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(v, 24), 24));
+        __m128 y = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(v, 16), 24));
+        __m128 z = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(v, 8), 24));
+        octahedralSse41(x, y, z, 127.0F);
+
+        const __m128i mask = _mm_set1_epi32(0xFF);
+        __m128i       out  = _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFF000000)));
+        out                = _mm_or_si128(out, _mm_and_si128(_mm_cvttps_epi32(x), mask));
+        out                = _mm_or_si128(out, _mm_slli_epi32(_mm_and_si128(_mm_cvttps_epi32(y), mask), 8));
+        out                = _mm_or_si128(out, _mm_slli_epi32(_mm_and_si128(_mm_cvttps_epi32(z), mask), 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + (i * 4)), out);
+    }
+    filterOctahedralScalar<int8_t>(data + (i * 4), count - i);
+}
+
+SSE41_TARGET static void filterOctahedral16Sse41(uint8_t* data, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + (i * 8)));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + (i * 8) + 16));
+
+        // xy / zw of the 4 elements, one 32-bit lane each
+        __m128i xy = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i zw = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1)));
+
+        __m128 x = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(xy, 16), 16));
+        __m128 y = _mm_cvtepi32_ps(_mm_srai_epi32(xy, 16));
+        __m128 z = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(zw, 16), 16));
+        octahedralSse41(x, y, z, 32767.0F);
+
+        const __m128i mask   = _mm_set1_epi32(0xFFFF);
+        __m128i       out_xy = _mm_or_si128(_mm_and_si128(_mm_cvttps_epi32(x), mask), _mm_slli_epi32(_mm_cvttps_epi32(y), 16));
+        __m128i       out_zw = _mm_or_si128(_mm_and_si128(_mm_cvttps_epi32(z), mask), _mm_andnot_si128(mask, zw));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + (i * 8)), _mm_unpacklo_epi32(out_xy, out_zw));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + (i * 8) + 16), _mm_unpackhi_epi32(out_xy, out_zw));
+    }
+    filterOctahedralScalar<int16_t>(data + (i * 8), count - i);
+}
+
+SSE41_TARGET static void filterQuaternionSse41(uint8_t* data, size_t count) {
+    const __m128 scale = _mm_set1_ps(1.0F / std::sqrt(2.0F));
+    const __m128 max   = _mm_set1_ps(32767.0F);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + (i * 8)));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + (i * 8) + 16));
+
+        __m128i xy = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i zw = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1)));
+        __m128i w  = _mm_srai_epi32(zw, 16);
+
+        __m128 s = _mm_div_ps(scale, _mm_cvtepi32_ps(_mm_or_si128(w, _mm_set1_epi32(3))));
+        __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(xy, 16), 16)), s);
+        __m128 y = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(xy, 16)), s);
+        __m128 z = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(zw, 16), 16)), s);
+
+        __m128 ww = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.0F), _mm_mul_ps(x, x)), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        __m128 qw = _mm_sqrt_ps(_mm_max_ps(ww, _mm_setzero_ps()));
+
+        x = _mm_mul_ps(x, max);
+        y = _mm_mul_ps(y, max);
+        z = _mm_mul_ps(z, max);
+        qw = _mm_mul_ps(qw, max);
+
+        alignas(16) int32_t out[4][4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[0]), _mm_cvttps_epi32(_mm_add_ps(x, roundingHalf(x))));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[1]), _mm_cvttps_epi32(_mm_add_ps(y, roundingHalf(y))));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[2]), _mm_cvttps_epi32(_mm_add_ps(z, roundingHalf(z))));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[3]), _mm_cvttps_epi32(_mm_add_ps(qw, _mm_set1_ps(0.5F))));
+
+        alignas(16) int32_t codes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(codes), _mm_and_si128(w, _mm_set1_epi32(3)));
+
+        // the component order depends on every element's own code
+        for (size_t j = 0; j < 4; j++) {
+            int     qc = codes[j];
+            int16_t q[4]{};
+            q[(qc + 1) & 3] = static_cast<int16_t>(out[0][j]);
+            q[(qc + 2) & 3] = static_cast<int16_t>(out[1][j]);
+            q[(qc + 3) & 3] = static_cast<int16_t>(out[2][j]);
+            q[qc]           = static_cast<int16_t>(out[3][j]);
+            memcpy(data + ((i + j) * 8), q, sizeof(q));
+        }
+    }
+    filterQuaternionScalar(data + (i * 8), count - i);
+}
+
+SSE41_TARGET static void filterExponentialSse41(uint8_t* data, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v        = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + (i * 4)));
+        __m128i mantissa = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+        __m128i exponent = _mm_srai_epi32(v, 24);
+        __m128  power    = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(exponent, _mm_set1_epi32(127)), 23));
+        _mm_storeu_ps(reinterpret_cast<float*>(data + (i * 4)), _mm_mul_ps(power, _mm_cvtepi32_ps(mantissa)));
+    }
+    filterExponentialScalar(data + (i * 4), count - i);
+}
+
+#endif
+
+// nullptr if the filter does not apply to stride
+static FilterFunction selectFilter(MeshoptDecoder::Filter filter, size_t stride) {
+    bool sse41 = hasSse41Converters();
+    (void) sse41;
+
+    switch (filter) {
+        case MeshoptDecoder::Filter::OCTAHEDRAL:
+            if (stride == 4) {
+#if MESHOPT_DECODER_SSE41
+                if (sse41) {
+                    return &filterOctahedral8Sse41;
+                }
+#endif
+                return &filterOctahedralScalar<int8_t>;
+            }
+            if (stride == 8) {
+#if MESHOPT_DECODER_SSE41
+                if (sse41) {
+                    return &filterOctahedral16Sse41;
+                }
+#endif
+                return &filterOctahedralScalar<int16_t>;
+            }
+            return nullptr;
+        case MeshoptDecoder::Filter::QUATERNION:
+            if (stride == 8) {
+#if MESHOPT_DECODER_SSE41
+                if (sse41) {
+                    return &filterQuaternionSse41;
+                }
+#endif
+                return &filterQuaternionScalar;
+            }
+            return nullptr;
+        case MeshoptDecoder::Filter::EXPONENTIAL:
+            if (stride % 4 == 0) {
+#if MESHOPT_DECODER_SSE41
+                if (sse41) {
+                    return &filterExponentialSse41;
+                }
+#endif
+                return &filterExponentialScalar;
+            }
+            return nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+MeshoptDecoder::Mode MeshoptDecoder::parseMode(std::string_view mode) {
+    if (mode == "ATTRIBUTES") {
+        return Mode::ATTRIBUTES;
+    }
+    if (mode == "TRIANGLES") {
+        return Mode::TRIANGLES;
+    }
+    if (mode == "INDICES") {
+        return Mode::INDICES;
+    }
+    throw std::runtime_error("Unknown EXT_meshopt_compression mode : " + std::string(mode));
+}
+
+MeshoptDecoder::Filter MeshoptDecoder::parseFilter(std::string_view filter) {
+    if (filter.empty() || filter == "NONE") {
+        return Filter::NONE;
+    }
+    if (filter == "OCTAHEDRAL") {
+        return Filter::OCTAHEDRAL;
+    }
+    if (filter == "QUATERNION") {
+        return Filter::QUATERNION;
+    }
+    if (filter == "EXPONENTIAL") {
+        return Filter::EXPONENTIAL;
+    }
+    throw std::runtime_error("Unknown EXT_meshopt_compression filter : " + std::string(filter));
+}
+
+void MeshoptDecoder::decode(uint8_t* dst, size_t count, size_t stride, const uint8_t* src, size_t size, Mode mode, Filter filter) {
+    switch (mode) {
+        case Mode::ATTRIBUTES:
+            MeshoptDecoder::decodeVertexBuffer(dst, count, stride, src, size);
+            MeshoptDecoder::applyFilter(dst, count, stride, filter);
+            break;
+        case Mode::TRIANGLES:
+            MeshoptDecoder::decodeIndexBuffer(dst, count, stride, src, size);
+            break;
+        case Mode::INDICES:
+            MeshoptDecoder::decodeIndexSequence(dst, count, stride, src, size);
+            break;
+    }
+}
+
+void MeshoptDecoder::decodeVertexBuffer(uint8_t* dst, size_t count, size_t stride, const uint8_t* src, size_t size) {
+    if (stride == 0 || stride > MAX_VERTEX_STRIDE || stride % 4 != 0) {
+        throwMalformed("vertex stride must be a multiple of 4 up to 256");
+    }
+    if (size < 1 + stride || (src[0] & 0xF0) != VERTEX_HEADER) {
+        throwMalformed("bad vertex buffer header");
+    }
+    if ((src[0] & 0x0F) != 0) {
+        throwMalformed("unsupported vertex codec version");
+    }
+
+    const uint8_t* data = src + 1;
+    const uint8_t* end  = src + size;
+
+    // the tail ends with the vertex the first block is delta-coded against
+    uint8_t last_vertex[MAX_VERTEX_STRIDE]{};
+    memcpy(last_vertex, end - stride, stride);
+
+    BytesDecodeFunction decode_bytes  = selectBytesDecode();
+    DeltaDecodeFunction decode_deltas = selectDeltaDecode();
+    size_t              block_size    = std::min((VERTEX_BLOCK_BYTES / stride) & ~(BYTE_GROUP_SIZE - 1), VERTEX_BLOCK_MAX_SIZE);
+
+    // the stride is a multiple of 4, so the byte channels always come in whole groups of 4
+    alignas(16) uint8_t buffer[4 * VERTEX_BLOCK_MAX_SIZE];
+    for (size_t offset = 0; offset < count; offset += block_size) {
+        size_t   block_count   = std::min(block_size, count - offset);
+        size_t   aligned_count = (block_count + BYTE_GROUP_SIZE - 1) & ~(BYTE_GROUP_SIZE - 1);
+        uint8_t* block_dst     = dst + (offset * stride);
+
+        for (size_t k = 0; k < stride; k += 4) {
+            for (size_t c = 0; c < 4; c++) {
+                data = decode_bytes(data, end, buffer + (c * VERTEX_BLOCK_MAX_SIZE), aligned_count);
+            }
+            decode_deltas(buffer, block_count, last_vertex + k, block_dst + k, stride);
+        }
+    }
+
+    if (static_cast<size_t>(end - data) != std::max(stride, TAIL_MAX_SIZE)) {
+        throwMalformed("vertex buffer size does not match its contents");
+    }
+}
+
+void MeshoptDecoder::decodeIndexBuffer(uint8_t* dst, size_t count, size_t index_size, const uint8_t* src, size_t size) {
+    if (count % 3 != 0 || (index_size != 2 && index_size != 4)) {
+        throwMalformed("index buffer must hold triangles of 2 or 4 byte indices");
+    }
+    if (size < 1 + (count / 3) + INDEX_AUX_TABLE_SIZE || (src[0] & 0xF0) != INDEX_HEADER) {
+        throwMalformed("bad index buffer header");
+    }
+    int version = src[0] & 0x0F;
+    if (version > 1) {
+        throwMalformed("unsupported index codec version");
+    }
+
+    // every triangle is one code byte, the free indices and aux bytes follow all codes, the aux table closes the buffer
+    const uint8_t* code      = src + 1;
+    const uint8_t* data      = code + (count / 3);
+    const uint8_t* data_end  = src + size - INDEX_AUX_TABLE_SIZE;
+    const uint8_t* aux_table = data_end;
+
+    uint32_t edge_fifo[16][2]{};
+    uint32_t vertex_fifo[16]{};
+    size_t   edge_offset   = 0;
+    size_t   vertex_offset = 0;
+    uint32_t next          = 0;
+    uint32_t last          = 0;
+    size_t   fc_max        = version >= 1 ? 13 : 15; // version 0 has no +-1 codes
+
+    auto push_vertex = [&](uint32_t v, bool condition = true) {
+        vertex_fifo[vertex_offset] = v;
+        vertex_offset              = (vertex_offset + (condition ? 1 : 0)) & 15;
+    };
+    auto push_edge = [&](uint32_t a, uint32_t b) {
+        edge_fifo[edge_offset][0] = a;
+        edge_fifo[edge_offset][1] = b;
+        edge_offset               = (edge_offset + 1) & 15;
+    };
+    auto write_triangle = [&](size_t i, uint32_t a, uint32_t b, uint32_t c) {
+        writeIndex(dst, index_size, i + 0, a);
+        writeIndex(dst, index_size, i + 1, b);
+        writeIndex(dst, index_size, i + 2, c);
+    };
+
+    for (size_t i = 0; i < count; i += 3) {
+        uint8_t code_triangle = *code++;
+
+        if (code_triangle < 0xF0) { // an edge from the fifo and a third vertex
+            size_t   fe = code_triangle >> 4;
+            uint32_t a  = edge_fifo[(edge_offset - 1 - fe) & 15][0];
+            uint32_t b  = edge_fifo[(edge_offset - 1 - fe) & 15][1];
+            size_t   fc = code_triangle & 15;
+
+            uint32_t c = 0;
+            if (fc < fc_max) { // fifo vertex, 0 - the next new vertex
+                c = fc == 0 ? next : vertex_fifo[(vertex_offset - 1 - fc) & 15];
+                next += fc == 0 ? 1 : 0;
+                push_vertex(c, fc == 0);
+            }
+            else { // 13 / 14 - the last free index -1 / +1, 15 - a new free index
+                c    = fc != 15 ? last + static_cast<uint32_t>(fc == 13 ? -1 : 1) : decodeIndex(data, data_end, last);
+                last = c;
+                push_vertex(c);
+            }
+
+            write_triangle(i, a, b, c);
+            push_edge(c, b);
+            push_edge(a, c);
+        }
+        else if (code_triangle < 0xFE) { // three vertices, the codes come from the aux table
+            uint8_t code_aux = aux_table[code_triangle & 15];
+            size_t  fb       = code_aux >> 4;
+            size_t  fc       = code_aux & 15;
+
+            uint32_t a = next++;
+            uint32_t b = fb == 0 ? next : vertex_fifo[(vertex_offset - fb) & 15];
+            next += fb == 0 ? 1 : 0;
+            uint32_t c = fc == 0 ? next : vertex_fifo[(vertex_offset - fc) & 15];
+            next += fc == 0 ? 1 : 0;
+
+            write_triangle(i, a, b, c);
+            push_vertex(a);
+            push_vertex(b, fb == 0);
+            push_vertex(c, fc == 0);
+            push_edge(b, a);
+            push_edge(c, b);
+            push_edge(a, c);
+        }
+        else { // three vertices, an explicit aux byte
+            if (data >= data_end) {
+                throwMalformed("index data is truncated");
+            }
+            uint8_t code_aux = *data++;
+            size_t  fa       = code_triangle == 0xFE ? 0 : 15;
+            size_t  fb       = code_aux >> 4;
+            size_t  fc       = code_aux & 15;
+
+            if (code_aux == 0) { // restart
+                next = 0;
+            }
+
+            uint32_t a = fa == 0 ? next++ : 0;
+            uint32_t b = fb == 0 ? next++ : vertex_fifo[(vertex_offset - fb) & 15];
+            uint32_t c = fc == 0 ? next++ : vertex_fifo[(vertex_offset - fc) & 15];
+
+            if (fa == 15) {
+                a = last = decodeIndex(data, data_end, last);
+            }
+            if (fb == 15) {
+                b = last = decodeIndex(data, data_end, last);
+            }
+            if (fc == 15) {
+                c = last = decodeIndex(data, data_end, last);
+            }
+
+            write_triangle(i, a, b, c);
+            push_vertex(a);
+            push_vertex(b, fb == 0 || fb == 15);
+            push_vertex(c, fc == 0 || fc == 15);
+            push_edge(b, a);
+            push_edge(c, b);
+            push_edge(a, c);
+        }
+    }
+
+    if (data != data_end) {
+        throwMalformed("index buffer size does not match its contents");
+    }
+}
+
+void MeshoptDecoder::decodeIndexSequence(uint8_t* dst, size_t count, size_t index_size, const uint8_t* src, size_t size) {
+    if (index_size != 2 && index_size != 4) {
+        throwMalformed("index sequence must hold 2 or 4 byte indices");
+    }
+    if (size < 1 + 4 || (src[0] & 0xF0) != SEQUENCE_HEADER) {
+        throwMalformed("bad index sequence header");
+    }
+    if ((src[0] & 0x0F) != 1) {
+        throwMalformed("unsupported index sequence version");
+    }
+
+    const uint8_t* data     = src + 1;
+    const uint8_t* data_end = src + size - 4; // 4 bytes of padding close the buffer
+
+    // two delta baselines, the low bit of every value picks one
+    uint32_t last[2]{};
+    for (size_t i = 0; i < count; i++) {
+        uint32_t value    = decodeVByte(data, data_end);
+        uint32_t baseline = value & 1;
+        value >>= 1;
+
+        uint32_t index = last[baseline] + ((value >> 1) ^ (0U - (value & 1)));
+        last[baseline] = index;
+        writeIndex(dst, index_size, i, index);
+    }
+
+    if (data != data_end) {
+        throwMalformed("index sequence size does not match its contents");
+    }
+}
+
+void MeshoptDecoder::applyFilter(uint8_t* data, size_t count, size_t stride, Filter filter) {
+    if (filter == Filter::NONE) {
+        return;
+    }
+
+    FilterFunction function = selectFilter(filter, stride);
+    if (function == nullptr) {
+        throwMalformed("filter does not match the byte stride");
+    }
+    function(data, filter == Filter::EXPONENTIAL ? count * (stride / 4) : count);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// EXT_meshopt_compression bufferView decoding : meshoptimizer vertex codec ( version 0 ), index codec and index sequence
+// codec ( version 1 ), then the OCTAHEDRAL / QUATERNION / EXPONENTIAL filters
+// malformed input throws std::runtime_error, nothing outside src / dst is ever touched
+class MeshoptDecoder {
+public:
+    enum class Mode {
+        ATTRIBUTES,
+        TRIANGLES,
+        INDICES,
+    };
+
+    enum class Filter {
+        NONE,
+        OCTAHEDRAL,
+        QUATERNION,
+        EXPONENTIAL,
+    };
+
+public:
+    // the extension's "mode" / "filter" strings, throws on unknown ones
+    static Mode   parseMode(std::string_view mode);
+    static Filter parseFilter(std::string_view filter);
+
+    // dst - count * stride bytes, the uncompressed bufferView
+    static void decode(uint8_t* dst, size_t count, size_t stride, const uint8_t* src, size_t size, Mode mode, Filter filter);
+
+    static void decodeVertexBuffer(uint8_t* dst, size_t count, size_t stride, const uint8_t* src, size_t size);
+    static void decodeIndexBuffer(uint8_t* dst, size_t count, size_t index_size, const uint8_t* src, size_t size);
+    static void decodeIndexSequence(uint8_t* dst, size_t count, size_t index_size, const uint8_t* src, size_t size);
+
+    // in place, over count elements of stride bytes
+    static void applyFilter(uint8_t* data, size_t count, size_t stride, Filter filter);
+};
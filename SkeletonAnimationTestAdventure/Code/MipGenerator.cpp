@@ -0,0 +1,314 @@
+#include "MipGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MIP_GENERATOR_SSE2 1 // part of every x64 CPU, no target attribute needed
+#include <emmintrin.h>
+#else
+#define MIP_GENERATOR_SSE2 0
+#endif
+
+static constexpr float  KAISER_RADIUS = 3.0F; // in texels of the smaller level
+static constexpr float  KAISER_ALPHA  = 4.0F;
+static constexpr size_t BLOCK_ROWS    = 16; // rows of the smaller level per task, shares the horizontally filtered rows
+static constexpr size_t SRGB_STEPS    = 65536;
+
+// taps of every output texel along one axis, count taps each ( the padding has weight 0 )
+struct MipTaps {
+    size_t             count{ 0 };
+    std::vector<int>   indices;
+    std::vector<float> weights;
+
+    MipTaps()  = default;
+    ~MipTaps() = default;
+};
+
+static float besselI0(float x) {
+    float sum  = 1.0F;
+    float term = 1.0F;
+    for (int k = 1; k < 32; k++) {
+        term *= (x * x) / (4.0F * static_cast<float>(k * k));
+        sum += term;
+        if (term < sum * 1e-7F) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// d - distance from the output texel center, in output texels
+static float filterWeight(MipFilter filter, float d) {
+    d = std::abs(d);
+    if (filter == MipFilter::BOX) {
+        return d < 0.5F ? 1.0F : (d == 0.5F ? 0.5F : 0.0F); // a source texel on the edge is shared by both neighbours
+    }
+
+    if (d >= KAISER_RADIUS) {
+        return 0.0F;
+    }
+    float sinc   = d < 1e-6F ? 1.0F : std::sin(std::numbers::pi_v<float> * d) / (std::numbers::pi_v<float> * d);
+    float t      = d / KAISER_RADIUS;
+    float window = besselI0(KAISER_ALPHA * std::sqrt(1.0F - (t * t))) / besselI0(KAISER_ALPHA);
+    return sinc * window;
+}
+
+static MipTaps buildTaps(MipFilter filter, unsigned int source_size, unsigned int size, bool wrap) {
+    float scale   = static_cast<float>(source_size) / static_cast<float>(size);
+    float support = (filter == MipFilter::BOX ? 0.5F : KAISER_RADIUS) * scale;
+
+    MipTaps taps{};
+    taps.count = static_cast<size_t>(std::ceil(support * 2.0F)) + 1;
+    taps.indices.assign(size * taps.count, 0);
+    taps.weights.assign(size * taps.count, 0.0F);
+
+    for (unsigned int x = 0; x < size; x++) {
+        float center = (static_cast<float>(x) + 0.5F) * scale; // in source texels
+        int   first  = static_cast<int>(std::floor(center - support));
+        float sum    = 0.0F;
+
+        for (size_t i = 0; i < taps.count; i++) {
+            int   source = first + static_cast<int>(i);
+            float weight = filterWeight(filter, ((static_cast<float>(source) + 0.5F) - center) / scale);
+            if (wrap) {
+                source %= static_cast<int>(source_size);
+                source += source < 0 ? static_cast<int>(source_size) : 0;
+            }
+            else {
+                source = std::clamp(source, 0, static_cast<int>(source_size) - 1);
+            }
+
+            taps.indices[(x * taps.count) + i] = source;
+            taps.weights[(x * taps.count) + i] = weight;
+            sum += weight;
+        }
+        for (size_t i = 0; i < taps.count; i++) {
+            taps.weights[(x * taps.count) + i] /= sum;
+        }
+    }
+    return taps;
+}
+
+static const std::array<float, 256>& getSrgbToLinear() {
+    static const std::array<float, 256> table = []() {
+        std::array<float, 256> result{};
+        for (size_t i = 0; i < result.size(); i++) {
+            float c   = static_cast<float>(i) / 255.0F;
+            result[i] = c <= 0.04045F ? c / 12.92F : std::pow((c + 0.055F) / 1.055F, 2.4F);
+        }
+        return result;
+    }();
+    return table;
+}
+
+static const std::vector<uint8_t>& getLinearToSrgb() {
+    static const std::vector<uint8_t> table = []() {
+        std::vector<uint8_t> result(SRGB_STEPS);
+        for (size_t i = 0; i < result.size(); i++) {
+            float c   = static_cast<float>(i) / static_cast<float>(SRGB_STEPS - 1);
+            float s   = c <= 0.0031308F ? c * 12.92F : (1.055F * std::pow(c, 1.0F / 2.4F)) - 0.055F;
+            result[i] = static_cast<uint8_t>(std::lround(std::clamp(s, 0.0F, 1.0F) * 255.0F));
+        }
+        return result;
+    }();
+    return table;
+}
+
+// row += weight * source, the whole row of floats at once
+static void accumulateRow(float* row, const float* source, float weight, size_t count) {
+    size_t i = 0;
+#if MIP_GENERATOR_SSE2
+    __m128 w = _mm_set1_ps(weight);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(row + i, _mm_add_ps(_mm_loadu_ps(row + i), _mm_mul_ps(w, _mm_loadu_ps(source + i))));
+    }
+#endif
+    for (; i < count; i++) {
+        row[i] += weight * source[i];
+    }
+}
+
+// one source row filtered horizontally into size texels
+static void filterRow(float* row, const float* source, const MipTaps& taps, unsigned int size, unsigned int components) {
+#if MIP_GENERATOR_SSE2
+    if (components == 4) {
+        for (unsigned int x = 0; x < size; x++) {
+            const int*   indices = &taps.indices[x * taps.count];
+            const float* weights = &taps.weights[x * taps.count];
+
+            __m128 sum = _mm_setzero_ps();
+            for (size_t i = 0; i < taps.count; i++) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[i]), _mm_loadu_ps(source + (static_cast<size_t>(indices[i]) * 4))));
+            }
+            _mm_storeu_ps(row + (static_cast<size_t>(x) * 4), sum);
+        }
+        return;
+    }
+#endif
+    for (unsigned int x = 0; x < size; x++) {
+        const int*   indices = &taps.indices[x * taps.count];
+        const float* weights = &taps.weights[x * taps.count];
+
+        for (unsigned int c = 0; c < components; c++) {
+            float sum = 0.0F;
+            for (size_t i = 0; i < taps.count; i++) {
+                sum += weights[i] * source[(static_cast<size_t>(indices[i]) * components) + c];
+            }
+            row[(static_cast<size_t>(x) * components) + c] = sum;
+        }
+    }
+}
+
+// share of the texels whose alpha, times scale, reaches cutoff
+static float getCoverage(const std::array<size_t, 256>& histogram, size_t count, float scale, float cutoff) {
+    size_t covered = 0;
+    for (size_t a = 0; a < histogram.size(); a++) {
+        covered += (static_cast<float>(a) / 255.0F) * scale >= cutoff ? histogram[a] : 0;
+    }
+    return static_cast<float>(covered) / static_cast<float>(std::max<size_t>(count, 1));
+}
+
+static std::array<size_t, 256> getAlphaHistogram(const unsigned char* level, size_t texels) {
+    std::array<size_t, 256> histogram{};
+    for (size_t i = 0; i < texels; i++) {
+        histogram[level[(i * 4) + 3]]++;
+    }
+    return histogram;
+}
+
+unsigned int MipGenerator::getLevelCount(unsigned int width, unsigned int height) {
+    unsigned int levels = 1;
+    for (unsigned int size = std::max(width, height); size > 1; size >>= 1) {
+        levels++;
+    }
+    return levels;
+}
+
+size_t MipGenerator::getLevelOffset(unsigned int width, unsigned int height, unsigned int components, unsigned int level) {
+    return MipGenerator::getChainSize(width, height, components, level);
+}
+
+size_t MipGenerator::getChainSize(unsigned int width, unsigned int height, unsigned int components, unsigned int levels) {
+    size_t size = 0;
+    for (unsigned int level = 0; level < levels; level++) {
+        size += static_cast<size_t>(MipGenerator::getLevelSize(width, level)) * MipGenerator::getLevelSize(height, level) * components;
+    }
+    return size;
+}
+
+void MipGenerator::generate(unsigned char* chain, unsigned int width, unsigned int height, unsigned int components, unsigned int levels, const MipOptions& options) {
+    const auto& srgb_to_linear = getSrgbToLinear();
+    const auto& linear_to_srgb = getLinearToSrgb();
+
+    bool   has_alpha      = components == 4;
+    size_t color_channels = has_alpha ? 3 : components; // the sRGB encoded ones
+    bool   keep_coverage  = has_alpha && options.alpha_cutoff >= 0.0F;
+
+    float coverage = 0.0F;
+    if (keep_coverage) {
+        size_t texels = static_cast<size_t>(width) * height;
+        coverage      = getCoverage(getAlphaHistogram(chain, texels), texels, 1.0F, options.alpha_cutoff);
+    }
+
+    for (unsigned int level = 1; level < levels; level++) {
+        unsigned int         source_width  = MipGenerator::getLevelSize(width, level - 1);
+        unsigned int         source_height = MipGenerator::getLevelSize(height, level - 1);
+        unsigned int         level_width   = MipGenerator::getLevelSize(width, level);
+        unsigned int         level_height  = MipGenerator::getLevelSize(height, level);
+        const unsigned char* source        = chain + MipGenerator::getLevelOffset(width, height, components, level - 1);
+        unsigned char*       target        = chain + MipGenerator::getLevelOffset(width, height, components, level);
+
+        MipTaps taps_x = buildTaps(options.filter, source_width, level_width, options.wrap_s);
+        MipTaps taps_y = buildTaps(options.filter, source_height, level_height, options.wrap_t);
+
+        size_t source_row = static_cast<size_t>(source_width) * components;
+        size_t row_size   = static_cast<size_t>(level_width) * components;
+
+        // every block filters the source rows it needs horizontally once, then sums them vertically
+        auto block_task = [&](size_t block) {
+            size_t first_row = block * BLOCK_ROWS;
+            size_t last_row  = std::min<size_t>(first_row + BLOCK_ROWS, level_height);
+
+            std::vector<int> slots(source_height, -1);
+            size_t           slot_count = 0;
+            for (size_t y = first_row; y < last_row; y++) {
+                for (size_t i = 0; i < taps_y.count; i++) {
+                    int& slot = slots[taps_y.indices[(y * taps_y.count) + i]];
+                    slot      = slot < 0 ? static_cast<int>(slot_count++) : slot;
+                }
+            }
+
+            std::vector<float> decoded(source_row);
+            std::vector<float> filtered(slot_count * row_size);
+            for (size_t y = 0; y < source_height; y++) {
+                if (slots[y] < 0) {
+                    continue;
+                }
+                const unsigned char* bytes = source + (y * source_row);
+                for (size_t i = 0; i < source_row; i++) {
+                    size_t channel = i % components;
+                    decoded[i]     = options.srgb && channel < color_channels ? srgb_to_linear[bytes[i]] : static_cast<float>(bytes[i]) / 255.0F;
+                }
+                filterRow(&filtered[slots[y] * row_size], decoded.data(), taps_x, level_width, components);
+            }
+
+            std::vector<float> row(row_size);
+            for (size_t y = first_row; y < last_row; y++) {
+                std::fill(row.begin(), row.end(), 0.0F);
+                for (size_t i = 0; i < taps_y.count; i++) {
+                    float weight = taps_y.weights[(y * taps_y.count) + i];
+                    if (weight != 0.0F) {
+                        accumulateRow(row.data(), &filtered[slots[taps_y.indices[(y * taps_y.count) + i]] * row_size], weight, row_size);
+                    }
+                }
+
+                unsigned char* bytes = target + (y * row_size);
+                for (size_t i = 0; i < row_size; i++) {
+                    float value = std::clamp(row[i], 0.0F, 1.0F); // the Kaiser lobes overshoot
+                    if (options.srgb && i % components < color_channels) {
+                        bytes[i] = linear_to_srgb[static_cast<size_t>(std::lround(value * static_cast<float>(SRGB_STEPS - 1)))];
+                    }
+                    else {
+                        bytes[i] = static_cast<unsigned char>(std::lround(value * 255.0F));
+                    }
+                }
+            }
+        };
+
+        size_t blocks = (level_height + BLOCK_ROWS - 1) / BLOCK_ROWS;
+        if (options.parallel && blocks > 1) {
+            ThreadPool::getGlobal().parallelFor(blocks, block_task);
+        }
+        else {
+            for (size_t block = 0; block < blocks; block++) {
+                block_task(block);
+            }
+        }
+
+        // alpha-tested edges would thin out level by level, so the alpha is scaled until the cutoff covers as much as in level 0
+        if (keep_coverage) {
+            size_t texels    = static_cast<size_t>(level_width) * level_height;
+            auto   histogram = getAlphaHistogram(target, texels);
+
+            float low  = 0.0F;
+            float high = 4.0F;
+            for (int i = 0; i < 16; i++) {
+                float middle = (low + high) * 0.5F;
+                (getCoverage(histogram, texels, middle, options.alpha_cutoff) < coverage ? low : high) = middle;
+            }
+            float scale = (low + high) * 0.5F;
+
+            for (size_t i = 0; i < texels; i++) {
+                unsigned char& alpha = target[(i * 4) + 3];
+                alpha                = static_cast<unsigned char>(std::lround(std::min(static_cast<float>(alpha) * scale, 255.0F)));
+            }
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+
+enum class MipFilter {
+    BOX,    // 2x2 average, what glGenerateMipmap does on most drivers
+    KAISER, // Kaiser-windowed sinc over 3 texels of the smaller level, sharper with little ringing
+};
+
+struct MipOptions {
+    MipFilter filter{ MipFilter::KAISER };
+    bool      srgb{ false };         // color channels are sRGB encoded and filtered in linear light. Alpha is always linear
+    bool      wrap_s{ true };        // the taps wrap around horizontally ( REPEAT ), else they clamp to the edge
+    bool      wrap_t{ true };
+    float     alpha_cutoff{ -1.0F }; // >= 0 : MASK material, the alpha of every level is scaled to keep level 0's coverage of the cutoff
+    bool      parallel{ true };      // rows on ThreadPool::getGlobal()
+
+    MipOptions()  = default;
+    ~MipOptions() = default;
+};
+
+// mip chains on the CPU. The levels are stored one after the other, each max( 1, previous / 2 ) on a side like GL and Vulkan
+// expect them, so the whole chain uploads without any GPU work
+class MipGenerator {
+public:
+    static unsigned int getLevelCount(unsigned int width, unsigned int height); // full chain, down to 1x1
+    static unsigned int getLevelSize(unsigned int size, unsigned int level) { return size >> level != 0 ? size >> level : 1; }
+    static size_t       getLevelOffset(unsigned int width, unsigned int height, unsigned int components, unsigned int level); // bytes before the level
+    static size_t       getChainSize(unsigned int width, unsigned int height, unsigned int components, unsigned int levels);
+
+    // chain starts with level 0 and has room for getChainSize( levels ), every later level is written
+    // each level is filtered from the one before it, 8-bit per channel
+    static void generate(unsigned char* chain, unsigned int width, unsigned int height, unsigned int components, unsigned int levels, const MipOptions& options);
+};
@@ -1,6 +1,26 @@
 #include "Model.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+#include "AssetCache.hpp"
+#include "Hash.hpp"
+#include "MappedGltfLoader.hpp"
+#include "MeshoptDecoder.hpp"
+#include "ModelCache.hpp"
+#include "PrimitiveOptimizer.hpp"
+#include "ProcessMemory.hpp"
+#include "TangentCache.hpp"
+#include "TextureRegistry.hpp"
+#include "ThreadPool.hpp"
 
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -8,16 +28,46 @@
 
 #include "mikktspace.h"
 
+static constexpr const char* MESHOPT_EXTENSION = "EXT_meshopt_compression";
+
+// required extensions the loader understands. KHR_mesh_quantization needs nothing special, AccessorView converts every component type
+static constexpr std::array<std::string_view, 3> SUPPORTED_REQUIRED_EXTENSIONS = { "KHR_mesh_quantization", "EXT_meshopt_compression", "MSFT_lod" };
+
+static bool usesExtension(const tinygltf::Model& model, std::string_view extension) {
+    return std::ranges::find(model.extensionsUsed, extension) != model.extensionsUsed.end();
+}
+
+static RenderMode getRenderMode(int mode) {
+    switch (mode) {
+        case TINYGLTF_MODE_POINTS:
+            return RenderMode::POINTS;
+        case TINYGLTF_MODE_LINE:
+            return RenderMode::LINES;
+        case TINYGLTF_MODE_LINE_LOOP:
+            return RenderMode::LINE_LOOP;
+        case TINYGLTF_MODE_LINE_STRIP:
+            return RenderMode::LINE_STRIP;
+        case TINYGLTF_MODE_TRIANGLES:
+            return RenderMode::TRIANGLES;
+        case TINYGLTF_MODE_TRIANGLE_STRIP:
+            return RenderMode::TRIANGLE_STRIP;
+        case TINYGLTF_MODE_TRIANGLE_FAN:
+            return RenderMode::TRIANGLE_FAN;
+        default:
+            assert(false);
+            return RenderMode::TRIANGLES;
+    }
+}
+
+template <typename Index>
 struct MikkUserData {
-    std::vector<glm::vec3>* positions;
-    std::vector<glm::vec3>* normals;
-    std::vector<glm::vec2>* texture_coords;
-    std::vector<glm::vec4>* tangents; // output
-    std::vector<uint32_t>*  indices;
+    Vertices*                 vertices; // reads position/normal/texture_coord, writes tangent
+    const std::vector<Index>* indices;
 };
 
+template <typename Index>
 int getNumberFaces(const SMikkTSpaceContext* p_context) {
-    auto* data = (MikkUserData*) p_context->m_pUserData;
+    auto* data = (MikkUserData<Index>*) p_context->m_pUserData;
     return data->indices->size() / 3;
 }
 
@@ -25,46 +75,98 @@ int getNumberVerticesOfFace(const SMikkTSpaceContext* /*unused*/, int /*unused*/
     return 3;
 }
 
+template <typename Index>
 void getPosition(const SMikkTSpaceContext* p_context, float position[3], int face, int vertex) {
-    auto*    data  = (MikkUserData*) p_context->m_pUserData;
-    uint32_t index = (*data->indices)[(face * 3) + vertex];
-    auto&    p     = (*data->positions)[index];
-    position[0]    = p.x;
-    position[1]    = p.y;
-    position[2]    = p.z;
+    auto*     data  = (MikkUserData<Index>*) p_context->m_pUserData;
+    uint32_t  index = (*data->indices)[(face * 3) + vertex];
+    glm::vec3 p     = (*data->vertices)[index].position;
+    position[0]     = p.x;
+    position[1]     = p.y;
+    position[2]     = p.z;
 }
 
+template <typename Index>
 void getNormal(const SMikkTSpaceContext* p_context, float normal[3], int face, int vertex) {
-    auto*    data  = (MikkUserData*) p_context->m_pUserData;
-    uint32_t index = (*data->indices)[(face * 3) + vertex];
-    auto&    p     = (*data->normals)[index];
-    normal[0]      = p.x;
-    normal[1]      = p.y;
-    normal[2]      = p.z;
+    auto*     data  = (MikkUserData<Index>*) p_context->m_pUserData;
+    uint32_t  index = (*data->indices)[(face * 3) + vertex];
+    glm::vec3 p     = (*data->vertices)[index].normal;
+    normal[0]       = p.x;
+    normal[1]       = p.y;
+    normal[2]       = p.z;
 }
 
+template <typename Index>
 void getTextureCoord(const SMikkTSpaceContext* p_context, float texture_coord[2], int face, int vertex) {
-    auto*    data    = (MikkUserData*) p_context->m_pUserData;
-    uint32_t index   = (*data->indices)[(face * 3) + vertex];
-    auto&    p       = (*data->texture_coords)[index];
+    auto*     data   = (MikkUserData<Index>*) p_context->m_pUserData;
+    uint32_t  index  = (*data->indices)[(face * 3) + vertex];
+    glm::vec2 p      = (*data->vertices)[index].texture_coord;
     texture_coord[0] = p.x;
     texture_coord[1] = p.y;
 }
 
+template <typename Index>
 void setTSpaceBasic(const SMikkTSpaceContext* p_context,
                     const float               tangent[3],
                     const float               sign,
                     const int                 face,
                     const int                 vertex) {
-    auto*    data            = (MikkUserData*) p_context->m_pUserData;
-    uint32_t index           = (*data->indices)[(face * 3) + vertex];
-    (*data->tangents)[index] = glm::vec4(tangent[0], tangent[1], tangent[2], sign);
+    auto*    data                    = (MikkUserData<Index>*) p_context->m_pUserData;
+    uint32_t index                   = (*data->indices)[(face * 3) + vertex];
+    (*data->vertices)[index].tangent = glm::vec4(tangent[0], tangent[1], tangent[2], sign);
 }
 
 void Model::Release() {
 }
 
-void Model::Initialize(const std::filesystem::path& path) {
+void Model::releaseUploadedData(bool geometry, std::span<const size_t> textures) {
+    if (!m_releaseCpuData) {
+        return;
+    }
+
+    size_t before = Model::countCpuBytes(*m_asset);
+    if (geometry) {
+        for (auto& mesh : m_asset->meshes) {
+            for (auto& primitive : mesh.primitives) {
+                // index_count, bounds and meshlets stay, culling and drawing read them every frame
+                Vertices().swap(primitive.vertices);
+                CompactVertices().swap(primitive.compact_vertices);
+                primitive.indices = Indices{};
+                for (auto& lod : primitive.lods) {
+                    lod.indices = Indices{};
+                }
+            }
+        }
+    }
+    for (size_t texture : textures) {
+        // a TextureRegistry texture keeps its texels : other models' loaders may be reading them right now ( Find, ModelCache::Save )
+        if (texture < m_asset->textures.size() && m_asset->textures[texture] != nullptr && m_asset->textures[texture]->getRegistryKey() == 0) {
+            m_asset->textures[texture]->releaseBytes();
+        }
+    }
+    m_loadStatistics.cpu_bytes_released += before - Model::countCpuBytes(*m_asset);
+    m_loadStatistics.rss_released = ProcessMemory::getResidentBytes();
+
+    if (m_reportMemory) {
+        std::println("Memory : {:.2f} MB of CPU data released after the upload, {:.2f} MB resident : {}",
+                     static_cast<double>(m_loadStatistics.cpu_bytes_released) / (1024.0 * 1024.0),
+                     static_cast<double>(m_loadStatistics.rss_released) / (1024.0 * 1024.0),
+                     m_name);
+    }
+}
+
+void Model::Initialize(const std::filesystem::path& path, const ModelLoadOptions& options) {
+    if (options.share_assets && AssetCache::getGlobal().Find(*this, path, options)) {
+        return;
+    }
+
+    this->load(path, options, nullptr);
+
+    if (options.share_assets) {
+        AssetCache::getGlobal().Publish(*this, path, options);
+    }
+}
+
+void Model::load(const std::filesystem::path& path, const ModelLoadOptions& options, const ModelLoadCallbacks* callbacks) {
     tinygltf::Model    model{};
     tinygltf::TinyGLTF loader{};
     std::string        error{};
@@ -72,11 +174,75 @@ void Model::Initialize(const std::filesystem::path& path) {
     std::string        filename = path.string();
     bool               good     = false;
 
-    if (path.extension() == ".gltf") {
-        good = loader.LoadASCIIFromFile(&model, &error, &warning, filename);
+    m_asset = std::make_shared<ModelAsset>(); // never write into an asset other models or instances may share
+
+    m_name                     = path.filename().string();
+    m_releaseCpuData           = options.release_cpu_data;
+    m_reportMemory             = options.report_memory;
+    m_loadStatistics           = {};
+    m_loadStatistics.rss_start = ProcessMemory::getResidentBytes();
+    m_loadStatistics.rss_peak  = m_loadStatistics.rss_start;
+    size_t process_peak        = ProcessMemory::getPeakResidentBytes();
+
+    std::optional<LoadProfiler> profiler{};
+    if (options.profile) {
+        m_profiler = &profiler.emplace();
+    }
+
+    ModelCache       cache = options.cache_directory.empty() ? ModelCache{} : ModelCache{ options.cache_directory };
+    LoadProfileScope cache_scope(options.use_cache ? m_profiler : nullptr, "cacheLoad");
+    bool             cached = options.use_cache && cache.Load(*this, path, options);
+    cache_scope.End();
+
+    if (cached) {
+        if (options.report_load) { // the other passes did not run
+            this->reportTextureSharing(filename);
+        }
+        this->finishMemoryStatistics(process_peak);
+        this->finishProfile(options);
+        if (callbacks != nullptr && callbacks->on_stage) {
+            for (ModelLoadStage stage : { ModelLoadStage::HIERARCHY, ModelLoadStage::GEOMETRY, ModelLoadStage::LOW_RES_TEXTURES, ModelLoadStage::TEXTURES }) {
+                callbacks->on_stage(stage);
+            }
+        }
+        return;
+    }
+
+    LoadProfileScope parse_scope(m_profiler, "parse");
+
+    loader.SetImageLoader(&Texture::storeEncodedImage, nullptr); // decoding is done later by loadTextures()
+
+    MappedGltfLoader mapped_loader{}; // must outlive the load* calls below, m_bufferData points into its mappings
+    bool             mapped = false;
+
+    if (options.memory_map || options.sax_parser) {
+        mapped = mapped_loader.Load(&Texture::storeEncodedImage, &model, &error, &warning, path);
+        good   = mapped;
+
+        if (!mapped) {
+            std::println("WARNING : Failed to memory-map glTF, using a regular load : {}\n{}", filename, error);
+            model = tinygltf::Model{};
+            error.clear();
+            warning.clear();
+        }
     }
-    else if (path.extension() == ".glb") {
-        good = loader.LoadBinaryFromFile(&model, &error, &warning, filename);
+
+    if (!good) {
+        if (path.extension() == ".gltf") {
+            good = loader.LoadASCIIFromFile(&model, &error, &warning, filename);
+        }
+        else if (path.extension() == ".glb") {
+            good = loader.LoadBinaryFromFile(&model, &error, &warning, filename);
+        }
+
+        // tinygltf rejects the uri-less fallback buffers of EXT_meshopt_compression, the mapped loader leaves them empty
+        if (!good && !options.memory_map && !options.sax_parser && usesExtension(model, MESHOPT_EXTENSION)) {
+            model = tinygltf::Model{};
+            error.clear();
+            warning.clear();
+            mapped = mapped_loader.Load(&Texture::storeEncodedImage, &model, &error, &warning, path);
+            good   = mapped;
+        }
     }
 
     if (!warning.empty()) {
@@ -91,50 +257,398 @@ void Model::Initialize(const std::filesystem::path& path) {
         assert(false);
     }
 
+    if (parse_scope.isActive()) { // the file and its external buffers, what tinygltf holds on the heap
+        std::error_code error_code{};
+        size_t          read      = std::filesystem::file_size(path, error_code);
+        size_t          allocated = 0;
+        for (size_t i = 0; i < model.buffers.size(); i++) {
+            read += model.buffers[i].uri.empty() || model.buffers[i].uri.starts_with("data:") ? 0 : model.buffers[i].data.size();
+            allocated += model.buffers[i].data.size();
+        }
+        for (size_t i = 0; mapped && i < mapped_loader.getBufferUris().size(); i++) {
+            read += mapped_loader.getBufferUris()[i].empty() ? 0 : mapped_loader.getBuffers()[i].size();
+        }
+        for (const auto& image : model.images) {
+            allocated += image.image.size();
+        }
+        parse_scope.setBytes(error_code ? 0 : read, allocated);
+    }
+    parse_scope.End();
+
+    for (const auto& extension : model.extensionsRequired) {
+        if (std::ranges::find(SUPPORTED_REQUIRED_EXTENSIONS, extension) == SUPPORTED_REQUIRED_EXTENSIONS.end()) {
+            std::println("WARNING : Required glTF extension {} is not supported : {}", extension, filename);
+        }
+    }
+
+    this->sampleMemory();
+
+    // before anything is released, release_source frees the model the uris are read from
+    std::vector<std::string> dependencies{};
+    if (options.use_cache) {
+        dependencies = ModelCache::collectDependencies(model, mapped ? &mapped_loader.getBufferUris() : nullptr);
+    }
+
+    std::optional<TangentCache> tangent_cache{};
+    if (options.use_tangent_cache) {
+        tangent_cache  = options.tangent_cache_directory.empty() ? TangentCache{} : TangentCache{ options.tangent_cache_directory };
+        m_tangentCache = &*tangent_cache;
+    }
+    m_loadOptions   = &options;
+    m_loadCallbacks = callbacks;
+
+    m_bufferData.clear();
+    if (mapped) {
+        m_bufferData = mapped_loader.getBuffers();
+    }
+    else {
+        m_bufferData.reserve(model.buffers.size());
+        for (const auto& buffer : model.buffers) {
+            m_bufferData.emplace_back(buffer.data.data(), buffer.data.size());
+        }
+    }
+    this->decodeMeshoptViews(model, options.parallel);
+    this->sampleMemory();
+
+    auto publish = [callbacks](ModelLoadStage stage) {
+        if (callbacks != nullptr && callbacks->on_stage) {
+            callbacks->on_stage(stage);
+        }
+    };
+
+    // cheapest parts first, a staged load publishes them while the geometry and the textures are still on the way
     this->loadNodes(model);
     this->loadSceneRoots(model);
     this->loadSkins(model);
-    this->loadMeshes(model);
     this->loadMaterials(model);
-    this->loadTextures(model);
     this->loadAnimations(model);
+
+    TexturePackingPlan packing = options.pack_channels ? TexturePacker::createPlan(model) : TexturePacker::createIdentityPlan(model.textures.size());
+    TexturePacker::remapMaterials(m_asset->materials, packing);
+    m_loadStatistics.packed_textures = packing.merged;
+
+    if (callbacks != nullptr) {
+        this->loadMeshBounds(model);
+        m_asset->textures.resize(packing.sources.size()); // empty until loadTextures(), the count is part of the hierarchy
+        publish(ModelLoadStage::HIERARCHY);
+    }
+
+    if (!this->isLoadCancelled()) {
+        this->loadMeshes(model, options.parallel);
+        this->sampleMemory();
+
+        if (options.release_source) { // only the images are read from here on
+            m_bufferData.clear();
+            m_decodedBuffers.clear();
+            for (auto& buffer : model.buffers) {
+                std::vector<unsigned char>().swap(buffer.data);
+            }
+            mapped_loader.releaseMappings();
+        }
+        publish(ModelLoadStage::GEOMETRY);
+    }
+    if (!this->isLoadCancelled()) {
+        this->loadTextures(model, packing, options.parallel);
+        this->sampleMemory();
+        publish(ModelLoadStage::LOW_RES_TEXTURES);
+    }
+    bool cancelled = this->isLoadCancelled();
+
+    m_bufferData.clear();
+    m_decodedBuffers.clear();
+    m_tangentCache  = nullptr;
+    m_loadOptions   = nullptr;
+    m_loadCallbacks = nullptr;
+
+    if (options.release_source) {
+        model = tinygltf::Model{};
+        mapped_loader.releaseMappings();
+    }
+
+    if (cancelled) { // the model is left partially loaded, the stream drops it
+        m_profiler = nullptr;
+        return;
+    }
+
+    if (options.report_load) {
+        this->reportLoadStatistics(filename);
+    }
+
+    this->finishMemoryStatistics(process_peak);
+
+    if (options.use_cache) {
+        LoadProfileScope save_scope(m_profiler, "cacheSave");
+        cache.Save(*this, path, options, dependencies);
+    }
+    this->finishProfile(options);
+    publish(ModelLoadStage::TEXTURES); // last, the receiver may take the textures out of the model
+}
+
+void Model::reportLoadStatistics(const std::string& filename) const {
+    if (m_loadStatistics.meshopt_views > 0) {
+        std::println("Meshopt : {} bufferViews, {:.2f} MB -> {:.2f} MB in {:.2f} ms : {}",
+                     m_loadStatistics.meshopt_views,
+                     static_cast<double>(m_loadStatistics.meshopt_compressed_bytes) / (1024.0 * 1024.0),
+                     static_cast<double>(m_loadStatistics.meshopt_decoded_bytes) / (1024.0 * 1024.0),
+                     m_loadStatistics.meshopt_decode_ms,
+                     filename);
+    }
+    if (m_loadStatistics.tangent_primitives > 0) {
+        std::println("Tangents : {} primitives, {} from cache, generation {:.2f} ms, cache saved {:.2f} ms : {}",
+                     m_loadStatistics.tangent_primitives,
+                     m_loadStatistics.tangent_cache_hits,
+                     m_loadStatistics.tangent_generation_ms,
+                     m_loadStatistics.tangent_cache_saved_ms,
+                     filename);
+    }
+    if (m_loadStatistics.welded_vertices > 0) {
+        std::println("Welding : {} vertices removed : {}", m_loadStatistics.welded_vertices, filename);
+    }
+    if (m_loadStatistics.meshlets > 0) {
+        std::println("Meshlets : {} : {}", m_loadStatistics.meshlets, filename);
+    }
+    if (m_loadStatistics.lods > 0) {
+        std::println("LODs : {} levels, {} triangles over {} full detail ones : {}",
+                     m_loadStatistics.lods,
+                     m_loadStatistics.lod_triangles,
+                     m_loadStatistics.lod0_triangles,
+                     filename);
+    }
+    if (m_loadStatistics.compact_primitives > 0) {
+        std::println("Compact vertices : {} primitives, {:.2f} MB saved : {}",
+                     m_loadStatistics.compact_primitives,
+                     static_cast<double>(m_loadStatistics.compact_bytes_saved) / (1024.0 * 1024.0),
+                     filename);
+    }
+    if (m_loadStatistics.packed_textures > 0) {
+        std::println("Channel packing : {} textures merged, {} left : {}", m_loadStatistics.packed_textures, m_asset->textures.size(), filename);
+    }
+    this->reportTextureSharing(filename);
+    if (!m_loadStatistics.texture_compression.empty()) {
+        std::print("Texture compression : {}\n{}", filename, TextureCompressor::getSummary(m_loadStatistics.texture_compression));
+    }
+    if (!m_loadStatistics.vertex_cache.empty()) {
+        VertexCacheStatistics before{};
+        VertexCacheStatistics after{};
+        for (const auto& cache_statistics : m_loadStatistics.vertex_cache) {
+            before.triangles += cache_statistics.before.triangles;
+            before.vertices += cache_statistics.before.vertices;
+            before.vertices_transformed += cache_statistics.before.vertices_transformed;
+            after.vertices_transformed += cache_statistics.after.vertices_transformed;
+        }
+        std::println("Vertex cache : {} primitives, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f} : {}",
+                     m_loadStatistics.vertex_cache.size(),
+                     static_cast<double>(before.vertices_transformed) / static_cast<double>(std::max<size_t>(before.triangles, 1)),
+                     static_cast<double>(after.vertices_transformed) / static_cast<double>(std::max<size_t>(before.triangles, 1)),
+                     static_cast<double>(before.vertices_transformed) / static_cast<double>(std::max<size_t>(before.vertices, 1)),
+                     static_cast<double>(after.vertices_transformed) / static_cast<double>(std::max<size_t>(before.vertices, 1)),
+                     filename);
+    }
 }
 
-void Model::Draw(const Shader& shader, float time) {
-    shader.Bind();
+void Model::reportTextureSharing(const std::string& filename) const {
+    size_t shared = m_loadStatistics.shared_textures_local + m_loadStatistics.shared_textures_registry;
+    if (shared == 0) {
+        return;
+    }
 
-    if (!m_animations.empty()) {
-        size_t animation_index = 1;
+    TextureRegistryStatistics registry = TextureRegistry::getGlobal().getStatistics();
+    std::println("Texture sharing : {} of {} textures shared, {} within the file, {} from other models, {:.2f} MB saved, {} unique textures in the registry : {}",
+                 shared,
+                 m_asset->textures.size(),
+                 m_loadStatistics.shared_textures_local,
+                 m_loadStatistics.shared_textures_registry,
+                 static_cast<double>(m_loadStatistics.shared_texture_bytes) / (1024.0 * 1024.0),
+                 registry.entries,
+                 filename);
+}
 
-        float duration = m_animations[animation_index].samplers[0].times.back();
+void Model::sampleMemory() {
+    m_loadStatistics.rss_peak = std::max(m_loadStatistics.rss_peak, ProcessMemory::getResidentBytes());
+}
 
-        for (const auto& s : m_animations[animation_index].samplers) {
-            for (const auto& t : s.times) {
-                duration = std::max(duration, t);
+void Model::finishMemoryStatistics(size_t process_peak) {
+    m_loadStatistics.rss_end  = ProcessMemory::getResidentBytes();
+    m_loadStatistics.rss_peak = std::max(m_loadStatistics.rss_peak, m_loadStatistics.rss_end);
+    if (size_t peak = ProcessMemory::getPeakResidentBytes(); peak > process_peak) { // the process peak was reached during this load
+        m_loadStatistics.rss_peak = peak;
+    }
+    m_loadStatistics.cpu_bytes = Model::countCpuBytes(*m_asset);
+
+    if (m_reportMemory) {
+        std::println("Memory : {:.2f} MB resident at the start, {:.2f} MB peak, {:.2f} MB at the end, {:.2f} MB of CPU data : {}",
+                     static_cast<double>(m_loadStatistics.rss_start) / (1024.0 * 1024.0),
+                     static_cast<double>(m_loadStatistics.rss_peak) / (1024.0 * 1024.0),
+                     static_cast<double>(m_loadStatistics.rss_end) / (1024.0 * 1024.0),
+                     static_cast<double>(m_loadStatistics.cpu_bytes) / (1024.0 * 1024.0),
+                     m_name);
+    }
+}
+
+size_t Model::countCpuBytes(const ModelAsset& asset) {
+    size_t bytes = 0;
+    for (const auto& mesh : asset.meshes) {
+        for (const auto& primitive : mesh.primitives) {
+            bytes += Model::countPrimitiveBytes(primitive);
+        }
+    }
+    for (const auto& texture : asset.textures) {
+        if (texture != nullptr && texture->getBytes() != nullptr) {
+            bytes += texture->getByteSize(); // shared ones count for every model using them
+        }
+    }
+    return bytes;
+}
+
+size_t Model::countPrimitiveBytes(const Primitive& primitive) {
+    auto index_bytes = [](const Indices& indices) {
+        return std::visit([](const auto& values) { return values.size() * sizeof(values[0]); }, indices);
+    };
+
+    size_t bytes = 0;
+    bytes += primitive.vertices.size() * sizeof(Vertex);
+    bytes += primitive.compact_vertices.size() * sizeof(CompactVertex);
+    bytes += index_bytes(primitive.indices);
+    for (const auto& lod : primitive.lods) {
+        bytes += index_bytes(lod.indices);
+    }
+    bytes += primitive.meshlets.size() * sizeof(Meshlet);
+    bytes += primitive.meshlet_vertices.size() * sizeof(uint32_t);
+    bytes += primitive.meshlet_triangles.size();
+    return bytes;
+}
+
+size_t Model::getAccessorBytes(const tinygltf::Model& model, int accessor_index) {
+    if (accessor_index < 0 || static_cast<size_t>(accessor_index) >= model.accessors.size()) {
+        return 0;
+    }
+    const tinygltf::Accessor& accessor = model.accessors[accessor_index];
+    return accessor.count * std::max(tinygltf::GetComponentSizeInBytes(accessor.componentType), 0) * std::max(tinygltf::GetNumComponentsInType(accessor.type), 0);
+}
+
+void Model::finishProfile(const ModelLoadOptions& options) {
+    if (m_profiler == nullptr) {
+        return;
+    }
+
+    m_loadStatistics.profile = m_profiler->takeEvents();
+    m_profiler               = nullptr;
+
+    std::print("Load profile : {}\n{}", m_name, LoadProfiler::getSummary(m_loadStatistics.profile));
+    if (!options.profile_trace.empty() && LoadProfiler::writeChromeTrace(options.profile_trace, m_loadStatistics.profile)) {
+        std::println("Load trace : {}", options.profile_trace.string());
+    }
+}
+
+bool Model::isLoadCancelled() const {
+    return m_loadCallbacks != nullptr && m_loadCallbacks->is_cancelled && m_loadCallbacks->is_cancelled();
+}
+
+void Model::decodeMeshoptViews(tinygltf::Model& model, bool parallel) {
+    using Clock = std::chrono::steady_clock;
+
+    struct MeshoptView {
+        tinygltf::BufferView*    buffer_view;
+        std::span<const uint8_t> source;
+        size_t                   count;
+        size_t                   stride;
+        MeshoptDecoder::Mode     mode;
+        MeshoptDecoder::Filter   filter;
+    };
+
+    std::vector<MeshoptView> views{};
+    for (auto& buffer_view : model.bufferViews) {
+        auto it = buffer_view.extensions.find(MESHOPT_EXTENSION);
+        if (it == buffer_view.extensions.end()) {
+            continue;
+        }
+
+        const tinygltf::Value& extension = it->second;
+        auto                   number    = [&](const char* key) -> size_t {
+            if (!extension.Has(key) || !extension.Get(key).IsNumber() || extension.Get(key).GetNumberAsDouble() < 0.0) {
+                return 0;
             }
+            return static_cast<size_t>(extension.Get(key).GetNumberAsDouble());
+        };
+        auto string = [&](const char* key) -> std::string {
+            return extension.Has(key) && extension.Get(key).IsString() ? extension.Get(key).Get<std::string>() : std::string{};
+        };
+
+        size_t buffer      = number("buffer");
+        size_t byte_offset = number("byteOffset");
+        size_t byte_length = number("byteLength");
+        if (buffer >= m_bufferData.size() || byte_offset > m_bufferData[buffer].size() || byte_length > m_bufferData[buffer].size() - byte_offset) {
+            throw std::runtime_error("EXT_meshopt_compression data is out of its buffer bounds");
         }
 
-        time = fmod(time, duration);
+        // the decoded view is count * byteStride bytes, allocated from these before anything is decoded
+        size_t count       = number("count");
+        size_t byte_stride = number("byteStride");
+        if (byte_stride == 0 || byte_stride > 256) {
+            throw std::runtime_error("EXT_meshopt_compression byteStride must be 1 to 256");
+        }
+        if (count > SIZE_MAX / byte_stride || count * byte_stride != buffer_view.byteLength) {
+            throw std::runtime_error("EXT_meshopt_compression count * byteStride does not match the bufferView byteLength");
+        }
+
+        views.push_back({ &buffer_view,
+                          m_bufferData[buffer].subspan(byte_offset, byte_length),
+                          count,
+                          byte_stride,
+                          MeshoptDecoder::parseMode(string("mode")),
+                          MeshoptDecoder::parseFilter(string("filter")) });
+    }
 
-        this->applyAnimationToNodes(animation_index, time); // play the first animation
+    if (views.empty()) {
+        return;
     }
 
-    this->updateNodeTransforms();
+    LoadProfileScope scope(m_profiler, "decodeMeshopt");
+    auto             start = Clock::now();
+
+    m_decodedBuffers.resize(views.size());
+    auto decode_task = [&](size_t index) {
+        const MeshoptView& view = views[index];
+        m_decodedBuffers[index].resize(view.count * view.stride);
+        MeshoptDecoder::decode(m_decodedBuffers[index].data(), view.count, view.stride, view.source.data(), view.source.size(), view.mode, view.filter);
+    };
 
-    if (!m_animations.empty()) {
-        this->updateSkinMatrices();
+    if (parallel) {
+        ThreadPool::getGlobal().parallelFor(views.size(), decode_task);
     }
+    else {
+        for (size_t i = 0; i < views.size(); i++) {
+            decode_task(i);
+        }
+    }
+
+    // every decoded view becomes a buffer of its own, the accessors read it like an uncompressed one
+    for (size_t i = 0; i < views.size(); i++) {
+        tinygltf::BufferView& buffer_view = *views[i].buffer_view;
 
-    for (int i : m_sceneRoots) {
-        drawNode(m_nodes[i], shader);
+        buffer_view.buffer     = static_cast<int>(m_bufferData.size());
+        buffer_view.byteOffset = 0;
+        buffer_view.byteLength = m_decodedBuffers[i].size();
+        buffer_view.byteStride = views[i].mode == MeshoptDecoder::Mode::ATTRIBUTES ? views[i].stride : 0;
+        m_bufferData.emplace_back(m_decodedBuffers[i].data(), m_decodedBuffers[i].size());
+
+        m_loadStatistics.meshopt_compressed_bytes += views[i].source.size();
+        m_loadStatistics.meshopt_decoded_bytes += m_decodedBuffers[i].size();
     }
+
+    m_loadStatistics.meshopt_views     = views.size();
+    m_loadStatistics.meshopt_decode_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    scope.setBytes(m_loadStatistics.meshopt_compressed_bytes, m_loadStatistics.meshopt_decoded_bytes);
 }
 
 void Model::loadNodes(const tinygltf::Model& model) {
-    m_nodes.resize(model.nodes.size());
+    LoadProfileScope scope(m_profiler, "loadNodes");
+    scope.setBytes(0, model.nodes.size() * sizeof(Node));
+
+    m_asset->nodes.resize(model.nodes.size());
     for (size_t i = 0; i < model.nodes.size(); i++) {
         const tinygltf::Node& node      = model.nodes[i];
-        auto&                 this_node = m_nodes[i];
+        auto&                 this_node = m_asset->nodes[i];
 
         this_node.camera   = node.camera;
         this_node.name     = node.name;
@@ -157,6 +671,25 @@ void Model::loadNodes(const tinygltf::Model& model) {
             this_node.local_matrix = glm::translate(glm::mat4(1.0F), this_node.translation) * glm::mat4_cast(this_node.rotation) * glm::scale(glm::mat4(1.0F), this_node.scale);
         }
         this_node.weights = node.weights;
+
+        // MSFT_lod : one coverage per level, the node itself first, kept only when it matches the level count
+        this_node.lods = node.lods;
+        if (!node.lods.empty() && node.extras.Has("MSFT_screencoverage")) {
+            const tinygltf::Value& coverage = node.extras.Get("MSFT_screencoverage");
+            if (coverage.IsArray() && coverage.ArrayLen() == node.lods.size() + 1) {
+                for (size_t j = 0; j < coverage.ArrayLen(); j++) {
+                    this_node.screen_coverage.push_back(static_cast<float>(coverage.Get(j).GetNumberAsDouble()));
+                }
+            }
+            else {
+                std::println("WARNING : MSFT_screencoverage of node {} does not match its {} LOD levels", i, node.lods.size());
+            }
+        }
+        for (int lod : this_node.lods) {
+            if (lod < 0 || static_cast<size_t>(lod) >= model.nodes.size()) {
+                throw std::runtime_error("MSFT_lod node index is out of range");
+            }
+        }
     }
 }
 
@@ -167,193 +700,330 @@ void Model::loadSceneRoots(const tinygltf::Model& model) {
         scene_index = 0;
     }
     if (scene_index >= 0) {
-        m_sceneRoots = model.scenes[scene_index].nodes;
+        m_asset->scene_roots = model.scenes[scene_index].nodes;
     }
 }
 
 void Model::loadSkins(const tinygltf::Model& model) {
-    m_skins.resize(model.skins.size());
+    LoadProfileScope scope(m_profiler, "loadSkins");
+    size_t           read      = 0;
+    size_t           allocated = model.skins.size() * sizeof(Skin);
+
+    m_asset->skins.resize(model.skins.size());
     for (size_t i = 0; i < model.skins.size(); i++) {
         const tinygltf::Skin& skin      = model.skins[i];
-        auto&                 this_skin = m_skins[i];
+        auto&                 this_skin = m_asset->skins[i];
 
         this_skin.name = skin.name;
 
-        size_t accessor_index = skin.inverseBindMatrices;
-        this->readAttribute(model, accessor_index, this_skin.inverse_bind_matrices);
+        if (skin.inverseBindMatrices >= 0) {
+            this->getAccessorView<glm::mat4>(model, skin.inverseBindMatrices).copyTo(this_skin.inverse_bind_matrices);
+        }
+        else { // identity matrices by the spec
+            this_skin.inverse_bind_matrices.assign(skin.joints.size(), glm::mat4(1.0F));
+        }
 
         this_skin.skeleton = skin.skeleton;
         this_skin.joints   = skin.joints;
-        this_skin.bone_final_matrices.resize(JOINTS_COUNT);
+
+        read += Model::getAccessorBytes(model, skin.inverseBindMatrices);
+        allocated += (this_skin.inverse_bind_matrices.size() * sizeof(glm::mat4)) + (this_skin.joints.size() * sizeof(int));
     }
+    scope.setBytes(read, allocated);
 }
 
-void Model::loadMeshes(const tinygltf::Model& model) {
-    m_meshes.resize(model.meshes.size());
+void Model::loadMeshBounds(const tinygltf::Model& model) {
+    m_asset->meshes.resize(model.meshes.size());
     for (size_t i = 0; i < model.meshes.size(); i++) {
         const tinygltf::Mesh& mesh      = model.meshes[i];
-        auto&                 this_mesh = m_meshes[i];
+        auto&                 this_mesh = m_asset->meshes[i];
 
-        this_mesh.name = mesh.name;
-        this->loadPrimitives(model, this_mesh.primitives, mesh.primitives);
+        this_mesh.name    = mesh.name;
         this_mesh.weights = mesh.weights;
+        this_mesh.primitives.resize(mesh.primitives.size());
+        for (size_t j = 0; j < mesh.primitives.size(); j++) {
+            const tinygltf::Primitive& primitive      = mesh.primitives[j];
+            auto&                      this_primitive = this_mesh.primitives[j];
+
+            this_primitive.material = primitive.material;
+            this_primitive.mode     = getRenderMode(primitive.mode);
+
+            // min / max are required on POSITION accessors, a sphere around the box is enough for a placeholder
+            auto position = primitive.attributes.find("POSITION");
+            if (position == primitive.attributes.end()) {
+                continue;
+            }
+            // runs before any accessor is read, the mapped and SAX loaders leave the indices unchecked
+            if (position->second < 0 || static_cast<size_t>(position->second) >= model.accessors.size()) {
+                throw std::runtime_error("Accessor index is out of range");
+            }
+            const tinygltf::Accessor& accessor = model.accessors[position->second];
+            if (accessor.minValues.size() < 3 || accessor.maxValues.size() < 3) {
+                continue;
+            }
+            glm::vec3 min{};
+            glm::vec3 max{};
+            readVector(min, accessor.minValues);
+            readVector(max, accessor.maxValues);
+            this_primitive.bounds_center = (min + max) * 0.5F;
+            this_primitive.bounds_radius = glm::length(max - min) * 0.5F;
+        }
     }
 }
 
-void Model::loadPrimitives(const tinygltf::Model& model, std::vector<Primitive>& this_primitives, const std::vector<tinygltf::Primitive>& primitives) {
-    this_primitives.resize(primitives.size());
-    for (size_t i = 0; i < primitives.size(); i++) {
-        const tinygltf::Primitive& primitive      = primitives[i];
-        auto&                      this_primitive = this_primitives[i];
-
-        loadIndices(model, this_primitive, this_primitive.indices, primitive); // indices go first
-        loadVertices(model, this_primitive.vertices, this_primitive.indices, primitive);
-        this_primitive.material = primitive.material;
-
-        switch (primitive.mode) {
-            case TINYGLTF_MODE_POINTS:
-                this_primitive.mode = RenderMode::POINTS;
-                break;
-            case TINYGLTF_MODE_LINE:
-                this_primitive.mode = RenderMode::LINES;
-                break;
-            case TINYGLTF_MODE_LINE_LOOP:
-                this_primitive.mode = RenderMode::LINE_LOOP;
-                break;
-            case TINYGLTF_MODE_LINE_STRIP:
-                this_primitive.mode = RenderMode::LINE_STRIP;
-                break;
-            case TINYGLTF_MODE_TRIANGLES:
-                this_primitive.mode = RenderMode::TRIANGLES;
-                break;
-            case TINYGLTF_MODE_TRIANGLE_STRIP:
-                this_primitive.mode = RenderMode::TRIANGLE_STRIP;
-                break;
-            case TINYGLTF_MODE_TRIANGLE_FAN:
-                this_primitive.mode = RenderMode::TRIANGLE_FAN;
-                break;
-            default:
-                assert(false);
-                break;
-        }
-    }
-}
-
-void Model::loadVertices(const tinygltf::Model& model, Vertices& this_vertices, Indices& this_indices, const tinygltf::Primitive& primitive) {
-
-    auto read_attribute = [&](const std::string& attribute_name, auto& data) {
-        auto it = primitive.attributes.find(attribute_name);
-        if (it == primitive.attributes.end()) {
-            data.clear();
-            return;
-        }
-        this->readAttribute(model, it->second, data);
+void Model::loadMeshes(const tinygltf::Model& model, bool parallel) {
+    struct PrimitiveTask {
+        const tinygltf::Primitive* primitive;
+        Primitive*                 this_primitive;
+        size_t                     mesh_index;
+        size_t                     primitive_index;
+        ModelLoadStatistics        statistics;
     };
 
-    std::vector<glm::vec3> positions{};
-    read_attribute("POSITION", positions);
+    LoadProfileScope scope(m_profiler, "loadMeshes");
 
-    std::vector<glm::vec3> normals{};
-    read_attribute("NORMAL", normals);
+    // every primitive gets its slot up front, so the output order never depends on the thread timing
+    std::vector<PrimitiveTask> tasks{};
 
-    std::vector<glm::vec4> tangents{};
-    read_attribute("TANGENT", tangents);
+    m_asset->meshes.clear(); // drops the loadMeshBounds() placeholders
+    m_asset->meshes.resize(model.meshes.size());
+    for (size_t i = 0; i < model.meshes.size(); i++) {
+        const tinygltf::Mesh& mesh      = model.meshes[i];
+        auto&                 this_mesh = m_asset->meshes[i];
 
-    std::vector<glm::vec2> texture_coords{};
-    read_attribute("TEXCOORD_0", texture_coords);
+        this_mesh.name    = mesh.name;
+        this_mesh.weights = mesh.weights;
+        this_mesh.primitives.resize(mesh.primitives.size());
+        for (size_t j = 0; j < mesh.primitives.size(); j++) {
+            tasks.push_back({ &mesh.primitives[j], &this_mesh.primitives[j], i, j, {} });
+        }
+    }
 
-    std::vector<glm::u16vec4> joints{};
-    read_attribute("JOINTS_0", joints);
+    auto load_task = [&](size_t index) {
+        PrimitiveTask&   task = tasks[index];
+        LoadProfileScope primitive_scope(m_profiler, "primitive");
 
-    std::vector<glm::uvec4> weights{};
-    read_attribute("WEIGHTS_0", weights);
+        this->loadPrimitive(model, *task.this_primitive, *task.primitive, task.statistics);
 
-    size_t vertices_count = positions.size();
-    this_vertices.resize(vertices_count);
+        if (primitive_scope.isActive()) {
+            size_t read = Model::getAccessorBytes(model, task.primitive->indices);
+            for (const auto& [name, accessor] : task.primitive->attributes) {
+                read += Model::getAccessorBytes(model, accessor);
+            }
+            primitive_scope.setDetail(std::format("mesh {} primitive {}", task.mesh_index, task.primitive_index));
+            primitive_scope.setBytes(read, Model::countPrimitiveBytes(*task.this_primitive));
+        }
+    };
 
-    if (tangents.empty()) {
-        tangents.resize(vertices_count);
+    if (parallel) {
+        ThreadPool::getGlobal().parallelFor(tasks.size(), load_task);
+    }
+    else {
+        for (size_t i = 0; i < tasks.size(); i++) {
+            load_task(i);
+        }
+    }
 
-        std::vector<uint32_t> indices_u32{};
+    size_t read      = 0;
+    size_t allocated = 0;
+    for (const auto& task : tasks) { // summed here, the tasks never share counters
+        if (scope.isActive()) {
+            read += Model::getAccessorBytes(model, task.primitive->indices);
+            for (const auto& [name, accessor] : task.primitive->attributes) {
+                read += Model::getAccessorBytes(model, accessor);
+            }
+            allocated += Model::countPrimitiveBytes(*task.this_primitive);
+        }
 
-        if (!std::holds_alternative<std::vector<uint32_t>>(this_indices)) {
-            std::visit([&](auto const& indices) {
-                indices_u32.reserve(indices.size());
-                for (auto v : indices) {
-                    indices_u32.emplace_back(static_cast<uint32_t>(v));
-                }
-            },
-                       this_indices);
+        m_loadStatistics.tangent_primitives += task.statistics.tangent_primitives;
+        m_loadStatistics.tangent_cache_hits += task.statistics.tangent_cache_hits;
+        m_loadStatistics.tangent_generation_ms += task.statistics.tangent_generation_ms;
+        m_loadStatistics.tangent_cache_saved_ms += task.statistics.tangent_cache_saved_ms;
+        m_loadStatistics.welded_vertices += task.statistics.welded_vertices;
+        m_loadStatistics.compact_primitives += task.statistics.compact_primitives;
+        m_loadStatistics.compact_bytes_saved += task.statistics.compact_bytes_saved;
+        m_loadStatistics.meshlets += task.statistics.meshlets;
+        m_loadStatistics.lods += task.statistics.lods;
+        m_loadStatistics.lod_triangles += task.statistics.lod_triangles;
+        m_loadStatistics.lod0_triangles += task.statistics.lod0_triangles;
+
+        for (PrimitiveCacheStatistics cache_statistics : task.statistics.vertex_cache) {
+            cache_statistics.mesh      = task.mesh_index;
+            cache_statistics.primitive = task.primitive_index;
+            m_loadStatistics.vertex_cache.push_back(cache_statistics);
         }
-        else {
-            indices_u32 = std::get<std::vector<uint32_t>>(this_indices);
+    }
+    scope.setBytes(read, allocated);
+}
+
+void Model::loadPrimitive(const tinygltf::Model& model, Primitive& this_primitive, const tinygltf::Primitive& primitive, ModelLoadStatistics& statistics) {
+    loadIndices(model, this_primitive, this_primitive.indices, primitive); // indices go first
+    loadVertices(model, this_primitive.vertices, this_primitive.indices, primitive, statistics);
+    this_primitive.material = primitive.material;
+    this_primitive.mode     = getRenderMode(primitive.mode);
+
+    if (m_loadOptions->weld_vertices) { // after tangent generation, MikkTSpace may split vertices that were shared
+        statistics.welded_vertices += PrimitiveOptimizer::weldVertices(this_primitive);
+    }
+
+    PrimitiveOptimizer::computeBounds(this_primitive);
+
+    if (!m_loadOptions->lod_ratios.empty() && this_primitive.mode == RenderMode::TRIANGLES) { // before the reordering, it reorders the levels too
+        size_t lods = PrimitiveOptimizer::generateLods(this_primitive, m_loadOptions->lod_ratios, m_loadOptions->lod_max_error);
+        if (lods > 0) {
+            statistics.lods += lods;
+            statistics.lod0_triangles += this_primitive.index_count / 3;
+            for (const PrimitiveLod& lod : this_primitive.lods) {
+                statistics.lod_triangles += std::visit([](const auto& indices) { return indices.size() / 3; }, lod.indices);
+            }
         }
+    }
 
-        if (positions.empty() || normals.empty() || texture_coords.empty() || indices_u32.empty()) {
-            std::cerr << "WARNING : Skip tangent generation : missing data" << '\n';
+    if ((m_loadOptions->optimize_vertex_cache || m_loadOptions->optimize_overdraw) && this_primitive.mode == RenderMode::TRIANGLES) {
+        PrimitiveCacheStatistics cache_statistics{};
+        cache_statistics.before = PrimitiveOptimizer::analyzeVertexCache(this_primitive);
+
+        if (m_loadOptions->optimize_overdraw) {
+            PrimitiveOptimizer::optimizeOverdraw(this_primitive);
         }
         else {
-            for (uint32_t idx : indices_u32) {
-                if (idx >= positions.size() || idx >= normals.size() || idx >= texture_coords.size()) {
-                    std::cerr << "Bad index " << idx << "\n";
-                    assert(false);
-                }
-            }
-
-            MikkUserData userdata{
-                .positions      = &positions,
-                .normals        = &normals,
-                .texture_coords = &texture_coords,
-                .tangents       = &tangents,
-                .indices        = &indices_u32
-            };
+            PrimitiveOptimizer::optimizeVertexCache(this_primitive);
+        }
+        PrimitiveOptimizer::optimizeVertexFetch(this_primitive);
 
-            SMikkTSpaceInterface iface   = {};
-            iface.m_getNumFaces          = getNumberFaces;
-            iface.m_getNumVerticesOfFace = getNumberVerticesOfFace;
-            iface.m_getPosition          = getPosition;
-            iface.m_getNormal            = getNormal;
-            iface.m_getTexCoord          = getTextureCoord;
-            iface.m_setTSpaceBasic       = setTSpaceBasic;
+        cache_statistics.after = PrimitiveOptimizer::analyzeVertexCache(this_primitive);
+        statistics.vertex_cache.push_back(cache_statistics);
+    }
 
-            SMikkTSpaceContext context = {};
-            context.m_pInterface       = &iface;
-            context.m_pUserData        = &userdata;
+    if (m_loadOptions->build_meshlets) {
+        statistics.meshlets += PrimitiveOptimizer::buildMeshlets(this_primitive);
+    }
 
-            genTangSpaceDefault(&context);
+    if (m_loadOptions->compact_vertices) { // last, every pass above works on the full Vertex
+        size_t vertices_count = this_primitive.vertices.size();
+        if (PrimitiveOptimizer::compactVertices(this_primitive)) {
+            statistics.compact_primitives++;
+            statistics.compact_bytes_saved += vertices_count * (sizeof(Vertex) - sizeof(CompactVertex));
         }
     }
+}
 
-    for (size_t i = 0; i < vertices_count; i++) {
-        auto& v    = this_vertices[i];
-        v.position = positions[i];
-        if (i < normals.size()) {
-            v.normal = normals[i];
-        }
-        if (i < tangents.size()) {
-            v.tangent = tangents[i];
+void Model::loadVertices(const tinygltf::Model& model, Vertices& this_vertices, const Indices& this_indices, const tinygltf::Primitive& primitive, ModelLoadStatistics& statistics) {
+
+    auto attribute_view = [&]<typename T>(const std::string& attribute_name, T /*type tag*/) {
+        auto it = primitive.attributes.find(attribute_name);
+        if (it == primitive.attributes.end()) {
+            return AccessorView<T>{};
         }
-        if (i < texture_coords.size()) {
-            v.texture_coord = texture_coords[i];
+        return this->getAccessorView<T>(model, it->second);
+    };
+
+    auto positions      = attribute_view("POSITION", glm::vec3{});
+    auto normals        = attribute_view("NORMAL", glm::vec3{});
+    auto tangents       = attribute_view("TANGENT", glm::vec4{});
+    auto texture_coords = attribute_view("TEXCOORD_0", glm::vec2{});
+    auto joints         = attribute_view("JOINTS_0", glm::u16vec4{});
+    auto weights        = attribute_view("WEIGHTS_0", glm::vec4{});
+
+    size_t vertices_count = positions.size();
+    this_vertices.resize(vertices_count);
+
+    // every attribute is converted straight into the interleaved vertices, no per-attribute vectors
+    Vertex* vertices = this_vertices.data();
+    positions.copyTo(&vertices->position, sizeof(Vertex));
+    normals.first(vertices_count).copyTo(&vertices->normal, sizeof(Vertex));
+    tangents.first(vertices_count).copyTo(&vertices->tangent, sizeof(Vertex));
+    texture_coords.first(vertices_count).copyTo(&vertices->texture_coord, sizeof(Vertex));
+    joints.first(vertices_count).copyTo(&vertices->joints, sizeof(Vertex));
+    weights.first(vertices_count).copyTo(&vertices->weights, sizeof(Vertex));
+
+    if (tangents.empty()) {
+        if (positions.empty() || normals.empty() || texture_coords.empty() || std::visit([](const auto& indices) { return indices.empty(); }, this_indices)) {
+            std::cerr << "WARNING : Skip tangent generation : missing data" << '\n';
         }
-        if (i < joints.size()) {
-            v.joints = joints[i];
+        else {
+            size_t max_index = std::visit([](const auto& indices) { return static_cast<size_t>(std::ranges::max(indices)); }, this_indices);
+            if (max_index >= positions.size() || max_index >= normals.size() || max_index >= texture_coords.size()) { // MikkTSpace would read past the vertices
+                throw std::runtime_error("Primitive index is out of its vertex attributes");
+            }
+
+            this->generateTangents(this_vertices, this_indices, statistics);
         }
-        if (i < weights.size()) {
-            v.weights = weights[i];
+    }
+}
+
+void Model::generateTangents(Vertices& this_vertices, const Indices& this_indices, ModelLoadStatistics& statistics) const {
+    using Clock = std::chrono::steady_clock;
+
+    statistics.tangent_primitives++;
+
+    LoadProfileScope scope(m_profiler, "tangents");
+    scope.setBytes(this_vertices.size() * sizeof(Vertex), 0);
+
+    auto     start = Clock::now();
+    uint64_t key   = 0;
+
+    if (m_tangentCache != nullptr) {
+        key = TangentCache::computeKey(this_vertices, this_indices);
+
+        double generation_ms = 0.0;
+        if (m_tangentCache->Load(key, this_vertices, generation_ms)) {
+            double lookup_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            statistics.tangent_cache_hits++;
+            statistics.tangent_cache_saved_ms += std::max(generation_ms - lookup_ms, 0.0);
+            if (scope.isActive()) {
+                scope.setDetail("cache hit");
+            }
+            return;
         }
     }
+
+    auto generation_start = Clock::now();
+
+    // the callbacks read the indices in their own width, no u32 copy
+    std::visit([&](const auto& indices) {
+        using Index = typename std::decay_t<decltype(indices)>::value_type;
+
+        MikkUserData<Index> userdata{
+            .vertices = &this_vertices,
+            .indices  = &indices
+        };
+
+        SMikkTSpaceInterface iface   = {};
+        iface.m_getNumFaces          = getNumberFaces<Index>;
+        iface.m_getNumVerticesOfFace = getNumberVerticesOfFace;
+        iface.m_getPosition          = getPosition<Index>;
+        iface.m_getNormal            = getNormal<Index>;
+        iface.m_getTexCoord          = getTextureCoord<Index>;
+        iface.m_setTSpaceBasic       = setTSpaceBasic<Index>;
+
+        SMikkTSpaceContext context = {};
+        context.m_pInterface       = &iface;
+        context.m_pUserData        = &userdata;
+
+        genTangSpaceDefault(&context);
+    },
+               this_indices);
+
+    double generation_ms = std::chrono::duration<double, std::milli>(Clock::now() - generation_start).count();
+    statistics.tangent_generation_ms += generation_ms;
+
+    if (m_tangentCache != nullptr) {
+        m_tangentCache->Save(key, this_vertices, generation_ms);
+    }
 }
 
-void Model::loadIndices(const tinygltf::Model& model, Primitive& this_primitive, Indices& this_indices, const tinygltf::Primitive& primitive) {
-    if (primitive.indices < 0) {
+void Model::loadIndices(const tinygltf::Model& model, Primitive& this_primitive, Indices& this_indices, const tinygltf::Primitive& primitive) const {
+    if (primitive.indices < 0 || static_cast<size_t>(primitive.indices) >= model.accessors.size()) {
         throw std::runtime_error("Primitive has no indices");
     }
 
-    const tinygltf::Accessor&   accessor    = model.accessors[primitive.indices];
+    const tinygltf::Accessor& accessor = model.accessors[primitive.indices];
+    if (accessor.type != TINYGLTF_TYPE_SCALAR) {
+        throw std::runtime_error("Index accessor is not SCALAR");
+    }
+    const uint8_t*              data_ptr    = this->getAccessorData(model, accessor); // every index below lies inside the buffer
     const tinygltf::BufferView& buffer_view = model.bufferViews[accessor.bufferView];
-    const tinygltf::Buffer&     buffer      = model.buffers[buffer_view.buffer];
-    const uint8_t*              data_ptr    = buffer.data.data() + buffer_view.byteOffset + accessor.byteOffset;
 
     switch (accessor.componentType) {
         case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
@@ -412,44 +1082,275 @@ void Model::loadIndices(const tinygltf::Model& model, Primitive& this_primitive,
     }
 }
 
-void Model::loadTextures(const tinygltf::Model& model) {
-    m_textures.resize(model.textures.size());
-    for (size_t i = 0; i < model.textures.size(); i++) {
-        const tinygltf::Texture& texture = model.textures[i];
-        const tinygltf::Image&   image   = model.images[texture.source];
-        tinygltf::Sampler        sampler{};
+void Model::loadTextures(tinygltf::Model& model, const TexturePackingPlan& packing, bool parallel) {
+    LoadProfileScope scope(m_profiler, "loadTextures");
+
+    // how the materials use a texture decides its color space, mips and block format
+    struct TextureUse {
+        tinygltf::Sampler          sampler{};
+        Texture::TextureColorSpace color_space{ Texture::TextureColorSpace::LINEAR };
+        float                      alpha_cutoff{ -1.0F }; // MASK base color : its mips keep the alpha test coverage
+        bool                       color_alpha{ false };  // some material blends or masks with it
+        bool                       normal_only{ true };   // roles of the texture, they pick the block format
+        bool                       occlusion_only{ true };
+        bool                       used{ false };
+
+        uint64_t key{ 0 };   // ModelLoadOptions::share_textures : TextureRegistry key
+        size_t   first{ 0 }; // first texture of the file with the same key, the texture itself if none
+    };
+
+    std::vector<TextureUse> uses(packing.sources.size());
+    for (size_t i = 0; i < uses.size(); i++) {
+        const tinygltf::Texture& texture = model.textures[packing.sources[i][0].texture];
+        TextureUse&              use     = uses[i];
 
         if (texture.sampler >= 0) {
-            sampler = model.samplers[texture.sampler];
+            use.sampler = model.samplers[texture.sampler];
         }
         else { // default settings
-            sampler.minFilter = TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_LINEAR;
-            sampler.magFilter = TINYGLTF_TEXTURE_FILTER_LINEAR;
-            sampler.wrapS     = TINYGLTF_TEXTURE_WRAP_REPEAT;
-            sampler.wrapT     = TINYGLTF_TEXTURE_WRAP_REPEAT;
+            use.sampler.minFilter = TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_LINEAR;
+            use.sampler.magFilter = TINYGLTF_TEXTURE_FILTER_LINEAR;
+            use.sampler.wrapS     = TINYGLTF_TEXTURE_WRAP_REPEAT;
+            use.sampler.wrapT     = TINYGLTF_TEXTURE_WRAP_REPEAT;
+        }
+
+        int texture_index = static_cast<int>(i); // the materials are already remapped to the model textures
+        for (const auto& material : m_asset->materials) {
+            bool base_color = material.pbr_metallic_roughness.base_color_texture.index == texture_index;
+            bool emissive   = material.emissive_texture.index == texture_index;
+            bool normal     = material.normal_texture.index == texture_index;
+            bool occlusion  = material.occlusion_texture.index == texture_index;
+            bool other      = base_color || emissive || material.pbr_metallic_roughness.metallic_roughness_texture.index == texture_index;
+
+            if (base_color || emissive) {
+                use.color_space = Texture::TextureColorSpace::SRGB;
+            }
+            if (base_color && material.alpha_mode == Material::AlphaMode::MASK) {
+                use.alpha_cutoff = static_cast<float>(material.alpha_cutoff);
+            }
+            use.color_alpha    = use.color_alpha || (base_color && material.alpha_mode != Material::AlphaMode::OPAQUE);
+            use.normal_only    = use.normal_only && !other && !occlusion;
+            use.occlusion_only = use.occlusion_only && !other && !normal;
+            use.used           = use.used || other || normal || occlusion;
         }
+        use.first = i;
+    }
+
+    if (m_loadOptions->share_textures) {
+        LoadProfileScope hash_scope(m_profiler, "hashTextures");
 
-        int                        gltf_texture_index  = static_cast<int>(i);
-        Texture::TextureColorSpace texture_color_space = Texture::TextureColorSpace::LINEAR;
+        // everything that changes the texels : the image bytes ( encoded or not ), the sampler, the roles and the texture options
+        uint64_t options_hash = HASH_SEED;
+        options_hash          = hashCombine(options_hash, m_loadOptions->generate_mipmaps);
+        options_hash          = hashCombine(options_hash, static_cast<uint64_t>(m_loadOptions->mip_filter));
+        options_hash          = hashCombine(options_hash, static_cast<uint64_t>(m_loadOptions->texture_compression));
 
-        for (auto& material : m_materials) {
-            if (material.pbr_metallic_roughness.base_color_texture.index == gltf_texture_index ||
-                material.emissive_texture.index == gltf_texture_index) {
+        std::unordered_map<uint64_t, size_t> first_use{};
+        size_t                               hashed = 0;
+        for (size_t i = 0; i < uses.size(); i++) {
+            TextureUse& use = uses[i];
 
-                texture_color_space = Texture::TextureColorSpace::SRGB;
+            uint64_t key = options_hash;
+            for (const auto& source : packing.sources[i]) {
+                const tinygltf::Image& image = model.images[model.textures[source.texture].source];
+
+                key = hashCombine(key, hashBytes(image.image.data(), image.image.size()));
+                key = hashCombine(key, (static_cast<uint64_t>(image.width) << 32) | static_cast<uint32_t>(image.height));
+                key = hashCombine(key, (static_cast<uint64_t>(image.component) << 8) | source.channels);
+                hashed += image.image.size();
             }
+            key = hashCombine(key, (static_cast<uint64_t>(use.sampler.minFilter) << 32) | static_cast<uint32_t>(use.sampler.magFilter));
+            key = hashCombine(key, (static_cast<uint64_t>(use.sampler.wrapS) << 32) | static_cast<uint32_t>(use.sampler.wrapT));
+            key = hashCombine(key, static_cast<uint64_t>(use.color_space));
+            key = hashCombine(key, std::bit_cast<uint32_t>(use.alpha_cutoff));
+            key = hashCombine(key, (use.color_alpha ? 1U : 0U) | (use.normal_only ? 2U : 0U) | (use.occlusion_only ? 4U : 0U) | (use.used ? 8U : 0U));
+
+            use.key   = key;
+            use.first = first_use.try_emplace(key, i).first->second;
         }
+        hash_scope.setBytes(hashed, 0);
+    }
 
-        auto& this_texture = m_textures[i];
-        this_texture.Create(image, sampler, texture_color_space);
+    m_asset->textures.resize(packing.sources.size());
+
+    // an image used by one texture only can be moved into it
+    std::vector<size_t> image_users(model.images.size(), 0);
+    size_t              read = 0;
+    for (size_t i = 0; i < packing.sources.size(); i++) {
+        for (const auto& source : packing.sources[i]) {
+            int image = model.textures[source.texture].source;
+            if (uses[i].first == i && image >= 0 && static_cast<size_t>(image) < image_users.size()) {
+                image_users[image]++;
+                read += model.images[image].image.size();
+            }
+        }
+    }
+
+    std::vector<TextureCompressionReport> reports(packing.sources.size());
+    std::vector<uint8_t>                  from_registry(packing.sources.size(), 0); // written by the loading threads, no std::vector<bool>
+
+    // images are still encoded here ( Texture::storeEncodedImage ), so this is where the decoding happens
+    // encoded images are decoded, the ones tinygltf already decoded are copied or moved
+    auto decode_texture = [&](Texture& target, size_t gltf_texture, const tinygltf::Sampler& sampler, Texture::TextureColorSpace texture_color_space) {
+        tinygltf::Image& image = model.images[model.textures[gltf_texture].source];
+        bool             move  = m_loadOptions->release_source && image_users[model.textures[gltf_texture].source] == 1;
+
+        LoadProfileScope texture_scope(m_profiler, image.as_is ? "decodeTexture" : move ? "moveTexture" : "copyTexture");
+        size_t           read = image.image.size();
+        if (move) {
+            target.Create(std::move(image), sampler, texture_color_space);
+        }
+        else {
+            target.Create(std::as_const(image), sampler, texture_color_space);
+        }
+        if (texture_scope.isActive()) {
+            texture_scope.setDetail(std::format("texture {} {}x{}", gltf_texture, target.getWidth(), target.getHeight()));
+            texture_scope.setBytes(read, static_cast<size_t>(target.getWidth()) * target.getHeight() * target.getComponents());
+        }
+    };
+
+    auto load_texture = [&](size_t i) {
+        const TextureUse& use     = uses[i];
+        const auto&       sources = packing.sources[i];
+        if (use.first != i) {
+            return; // the same texture again, filled in below
+        }
+
+        if (m_loadOptions->share_textures) {
+            if (std::shared_ptr<Texture> shared = TextureRegistry::getGlobal().Find(use.key)) { // another model loaded it
+                m_asset->textures[i] = std::move(shared);
+                from_registry[i]     = 1;
+                return;
+            }
+        }
+
+        auto  texture      = std::make_shared<Texture>();
+        auto& this_texture = *texture;
+        if (sources.size() == 1 && sources[0].channels == 0) {
+            decode_texture(this_texture, sources[0].texture, use.sampler, use.color_space);
+        }
+        else { // channel-split files, every part fills its channels of one RGBA texture ( TexturePacker )
+            LoadProfileScope pack_scope(m_profiler, "packTexture");
+
+            std::vector<Texture> parts(sources.size());
+            for (size_t k = 0; k < sources.size(); k++) {
+                decode_texture(parts[k], sources[k].texture, use.sampler, Texture::TextureColorSpace::LINEAR);
+            }
+
+            unsigned int width  = parts[0].getWidth();
+            unsigned int height = parts[0].getHeight();
+            size_t       texels = static_cast<size_t>(width) * height;
+            TextureBytes bytes  = Texture::allocateBytes(texels * 4);
+            std::fill_n(bytes.get(), texels * 4, static_cast<unsigned char>(255));
+            for (size_t k = 0; k < sources.size(); k++) {
+                if (parts[k].getBytes() != nullptr && parts[k].getWidth() == width && parts[k].getHeight() == height) {
+                    TexturePacker::pack(bytes.get(), texels, parts[k].getBytes(), parts[k].getComponents(), sources[k].channels);
+                }
+            }
+            this_texture.Create(width, height, 4, std::move(bytes), use.sampler, use.color_space);
+
+            if (pack_scope.isActive()) {
+                pack_scope.setDetail(std::format("texture {} from {} files", i, sources.size()));
+                pack_scope.setBytes(0, texels * 4);
+            }
+        }
+
+        if (m_loadCallbacks != nullptr && m_loadCallbacks->on_reduced_texture) {
+            m_loadCallbacks->on_reduced_texture(i, this_texture.createReduced(m_loadOptions->reduced_texture_size));
+        }
+
+        auto min_filter = this_texture.getMinFilter();
+        bool compress   = m_loadOptions->texture_compression != TextureCompression::NONE;
+        if ((m_loadOptions->generate_mipmaps || compress) && min_filter != Texture::TextureMinFilter::NEAREST && min_filter != Texture::TextureMinFilter::LINEAR) {
+            LoadProfileScope mip_scope(m_profiler, "generateMips");
+
+            MipOptions mip_options{};
+            mip_options.filter       = m_loadOptions->mip_filter;
+            mip_options.srgb         = use.color_space == Texture::TextureColorSpace::SRGB;
+            mip_options.wrap_s       = this_texture.getWrapS() != Texture::TextureWrap::CLAMP_TO_EDGE;
+            mip_options.wrap_t       = this_texture.getWrapT() != Texture::TextureWrap::CLAMP_TO_EDGE;
+            mip_options.alpha_cutoff = use.alpha_cutoff;
+            mip_options.parallel     = parallel;
+            this_texture.generateMipmaps(mip_options);
+
+            if (mip_scope.isActive()) {
+                mip_scope.setDetail(std::format("texture {} {} levels", i, this_texture.getMipLevels()));
+                mip_scope.setBytes(this_texture.getMipSize(0), this_texture.getByteSize() - this_texture.getMipSize(0));
+            }
+        }
+
+        if (compress) {
+            LoadProfileScope compress_scope(m_profiler, "compressTexture");
+
+            // normal maps keep x and y ( the shader rebuilds z ), occlusion keeps red, the rest is color
+            BlockFormat format = BlockFormat::BC7;
+            if (use.used && use.normal_only) {
+                format = BlockFormat::BC5;
+            }
+            else if (use.used && use.occlusion_only) {
+                format = BlockFormat::BC4;
+            }
+            else if (m_loadOptions->texture_compression == TextureCompression::FAST) {
+                format = use.color_alpha && this_texture.getComponents() == 4 ? BlockFormat::BC3 : BlockFormat::BC1;
+            }
+
+            size_t source_bytes = this_texture.getByteSize();
+            reports[i]          = this_texture.compress(format, parallel, m_loadOptions->compression_psnr);
+            reports[i].texture  = i;
+            if (compress_scope.isActive()) {
+                compress_scope.setDetail(std::format("texture {} {}", i, TextureCompressor::getName(format)));
+                compress_scope.setBytes(source_bytes, this_texture.getByteSize());
+            }
+        }
+
+        if (m_loadOptions->share_textures) { // another thread may have loaded the same texture for another model meanwhile
+            texture = TextureRegistry::getGlobal().Publish(use.key, std::move(texture));
+        }
+        m_asset->textures[i] = std::move(texture);
+    };
+
+    if (parallel) {
+        ThreadPool::getGlobal().parallelFor(packing.sources.size(), load_texture);
+    }
+    else {
+        for (size_t i = 0; i < packing.sources.size(); i++) {
+            load_texture(i);
+        }
+    }
+
+    size_t allocated = 0;
+    for (size_t i = 0; i < uses.size(); i++) {
+        const auto& texture = m_asset->textures[uses[i].first];
+        if (uses[i].first != i) {
+            m_asset->textures[i] = texture;
+            m_loadStatistics.shared_textures_local++;
+            m_loadStatistics.shared_texture_bytes += texture->getByteSize();
+        }
+        else if (from_registry[i] != 0) {
+            m_loadStatistics.shared_textures_registry++;
+            m_loadStatistics.shared_texture_bytes += texture->getByteSize();
+        }
+        else {
+            allocated += texture->getByteSize();
+        }
+    }
+    scope.setBytes(read, allocated);
+
+    for (auto& report : reports) {
+        if (report.compressed_bytes > 0) {
+            m_loadStatistics.texture_compression.push_back(report);
+        }
     }
 }
 
 void Model::loadMaterials(const tinygltf::Model& model) {
-    m_materials.resize(model.materials.size());
+    LoadProfileScope scope(m_profiler, "loadMaterials");
+    scope.setBytes(0, model.materials.size() * sizeof(Material));
+
+    m_asset->materials.resize(model.materials.size());
     for (size_t i = 0; i < model.materials.size(); i++) {
         const tinygltf::Material& material      = model.materials[i];
-        auto&                     this_material = m_materials[i];
+        auto&                     this_material = m_asset->materials[i];
 
         this_material.name = material.name;
         Model::readVector(this_material.emissive_factor, material.emissiveFactor);
@@ -491,10 +1392,14 @@ void Model::loadMaterials(const tinygltf::Model& model) {
 }
 
 void Model::loadAnimations(const tinygltf::Model& model) {
-    m_animations.resize(model.animations.size());
+    LoadProfileScope scope(m_profiler, "loadAnimations");
+    size_t           read      = 0;
+    size_t           allocated = model.animations.size() * sizeof(Animation);
+
+    m_asset->animations.resize(model.animations.size());
     for (size_t i = 0; i < model.animations.size(); i++) {
         const tinygltf::Animation& animation      = model.animations[i];
-        auto&                      this_animation = m_animations[i];
+        auto&                      this_animation = m_asset->animations[i];
 
         this_animation.channels.resize(animation.channels.size());
 
@@ -513,8 +1418,8 @@ void Model::loadAnimations(const tinygltf::Model& model) {
             const tinygltf::AnimationSampler& sampler      = animation.samplers[j];
             auto&                             this_sampler = this_animation.samplers[j];
 
-            Model::readAccessorFloat(model, sampler.input, this_sampler.times);
-            Model::readAccessorVec4(model, sampler.output, this_sampler.values);
+            this->getAccessorView<float>(model, sampler.input).copyTo(this_sampler.times);
+            this->getAccessorView<glm::vec4>(model, sampler.output).copyTo(this_sampler.values);
 
             if (sampler.interpolation == "LINEAR") {
                 this_sampler.interpolation = AnimationSampler::InterpolationMode::LINEAR;
@@ -525,146 +1430,13 @@ void Model::loadAnimations(const tinygltf::Model& model) {
             else if (sampler.interpolation == "CUBICSPLINE") {
                 this_sampler.interpolation = AnimationSampler::InterpolationMode::CUBICSPLINE;
             }
-        }
-    }
-}
-
-void Model::applyAnimationToNodes(int index, float time) {
-    const Animation& animation = m_animations[index];
-
-    for (const AnimationChannel& channel : animation.channels) {
-        const AnimationSampler& sampler = animation.samplers[channel.sampler];
-
-        if (sampler.times.size() < 2 || sampler.values.size() < 2) {
-            continue;
-        }
-
-        int k1 = 0;
-        while (k1 < sampler.times.size() - 1 && time > sampler.times[k1 + 1]) {
-            k1++;
-        }
-
-        int k2 = std::min<int>(k1 + 1, sampler.times.size() - 1);
-
-        glm::vec4 v1 = sampler.values[k1];
-        glm::vec4 v2 = sampler.values[k2];
-
-        float t = (time - sampler.times[k1]) / (sampler.times[k2] - sampler.times[k1]);
-        t       = glm::clamp(t, 0.0F, 1.0F);
 
-        Node& node = m_nodes[channel.target_node];
-
-        if (channel.target_path == "rotation") {
-            glm::quat q1(v1.w, v1.x, v1.y, v1.z);
-            glm::quat q2(v2.w, v2.x, v2.y, v2.z);
-            node.rotation = glm::normalize(glm::slerp(q1, q2, t));
-        }
-        else if (channel.target_path == "translation") {
-            node.translation = glm::mix(glm::vec3(v1), glm::vec3(v2), t);
-        }
-        else if (channel.target_path == "scale") {
-            node.scale = glm::mix(glm::vec3(v1), glm::vec3(v2), t);
+            read += Model::getAccessorBytes(model, sampler.input) + Model::getAccessorBytes(model, sampler.output);
+            allocated += (this_sampler.times.size() * sizeof(float)) + (this_sampler.values.size() * sizeof(glm::vec4));
         }
+        allocated += this_animation.channels.size() * sizeof(AnimationChannel);
     }
-}
-
-void Model::updateNodeTransforms() {
-    for (int root : m_sceneRoots) {
-        this->updateNodeRecursive(root, glm::mat4(1.0F));
-    }
-}
-
-void Model::updateNodeRecursive(int index, const glm::mat4& parent) {
-    Node& node = m_nodes[index];
-
-    node.local_matrix =
-        glm::translate(glm::mat4(1.0F), node.translation) *
-        glm::mat4_cast(node.rotation) *
-        glm::scale(glm::mat4(1.0F), node.scale);
-
-    node.global_matrix = parent * node.local_matrix;
-
-    for (int child : node.children) {
-        this->updateNodeRecursive(child, node.global_matrix);
-    }
-}
-
-void Model::updateSkinMatrices() {
-    for (Skin& skin : m_skins) {
-        for (size_t i = 0; i < skin.joints.size(); i++) {
-            int         joint_node_index = skin.joints[i];
-            const Node& joint_node       = m_nodes[joint_node_index];
-
-            skin.bone_final_matrices[i] = joint_node.global_matrix * skin.inverse_bind_matrices[i];
-        }
-    }
-}
-
-void Model::drawNode(const Node& node, const Shader& shader) {
-    if (node.mesh >= 0) {
-        this->drawMesh(m_meshes[node.mesh], node.skin, shader, node.global_matrix);
-    }
-
-    for (int child : node.children) {
-        this->drawNode(m_nodes[child], shader);
-    }
-}
-
-void Model::drawMesh(const Mesh& mesh, int skin_index, const Shader& shader, const glm::mat4& matrix) {
-    if (skin_index >= 0) {
-        const Skin& skin = m_skins[skin_index];
-        shader.setUniformMat4Array("u_bones", skin.bone_final_matrices.data(), JOINTS_COUNT);
-        shader.setUniformInt("u_isAnimated", 1);
-    }
-    else {
-        shader.setUniformInt("u_isAnimated", 0);
-    }
-
-    shader.setUniformMat4("u_model", matrix);
-
-    for (const Primitive& primitive : mesh.primitives) {
-        this->drawPrimitive(primitive, shader);
-    }
-}
-
-void Model::drawPrimitive(const Primitive& primitive, const Shader& shader) {
-    /*const Material& material = m_materials[primitive.material];
-
-    this->bindMaterial(material, shader);
-
-    primitive.vao.Bind();
-
-    if (primitive.index_count > 0) {
-        glDrawElements(GL_TRIANGLES, primitive.index_count, primitive.index_type, (void*) primitive.index_offset);
-    }
-    else {
-        glDrawArrays(GL_TRIANGLES, 0, primitive.vertices.size());
-    }*/
-}
-
-void Model::bindMaterial(const Material& material, const Shader& shader) {
-    shader.setUniformVec4("u_baseColorFactor", material.pbr_metallic_roughness.base_color_factor);
-    shader.setUniformFloat("u_metallicFactor", material.pbr_metallic_roughness.metallic_factor);
-    shader.setUniformFloat("u_roughnessFactor", material.pbr_metallic_roughness.roughness_factor);
-
-    int slot = 0;
-
-    bindTexture(shader, "u_baseColorTex", material.pbr_metallic_roughness.base_color_texture.index, slot++);                 // 0
-    bindTexture(shader, "u_metallicRoughnessTex", material.pbr_metallic_roughness.metallic_roughness_texture.index, slot++); // 1
-    bindTexture(shader, "u_normalTex", material.normal_texture.index, slot++);                                               // 2
-    bindTexture(shader, "u_occlusionTex", material.occlusion_texture.index, slot++);                                         // 3
-    bindTexture(shader, "u_emissiveTex", material.emissive_texture.index, slot++);                                           // 4
-}
-
-void Model::bindTexture(const Shader& shader, const std::string& uniform, int texture_index, int slot) {
-    /*shader.setUniformInt(uniform.c_str(), slot);
-
-    if (texture_index < 0) {
-        return;
-    }
-
-    glActiveTexture(GL_TEXTURE0 + slot);
-    m_textures[texture_index].Bind();*/
+    scope.setBytes(read, allocated);
 }
 
 void Model::readVector(glm::vec2& dst, const std::vector<double>& src) {
@@ -695,119 +1467,32 @@ void Model::readVector(glm::quat& dst, const std::vector<double>& src) {
     dst = glm::quat(static_cast<float>(src[0]), static_cast<float>(src[1]), static_cast<float>(src[2]), static_cast<float>(src[3]));
 }
 
-float Model::readComponentAsFloat(const uint8_t* data, int component_type, bool normalized) {
-    switch (component_type) {
-        case TINYGLTF_COMPONENT_TYPE_FLOAT:
-            return *reinterpret_cast<const float*>(data);
-
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-            uint16_t v = *reinterpret_cast<const uint16_t*>(data);
-            return normalized ? (float) v / 65535.0F : (float) v;
-        }
-
-        case TINYGLTF_COMPONENT_TYPE_SHORT: {
-            int16_t v = *reinterpret_cast<const int16_t*>(data);
-            return normalized ? glm::clamp((float) v / 32767.0F, -1.0F, 1.0F) : (float) v;
-        }
-
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
-            uint8_t v = *data;
-            return normalized ? (float) v / 255.0F : (float) v;
-        }
-
-        case TINYGLTF_COMPONENT_TYPE_BYTE: {
-            int8_t v = *reinterpret_cast<const int8_t*>(data);
-            return normalized ? glm::clamp((float) v / 127.0F, -1.0F, 1.0F) : (float) v;
-        }
-
-        default:
-            std::cerr << "WARNING : Unsupported component type : " << component_type << "\n";
-            return 0.0F;
-            break;
+const uint8_t* Model::getAccessorData(const tinygltf::Model& model, const tinygltf::Accessor& accessor) const {
+    if (accessor.bufferView < 0 || static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size()) {
+        throw std::runtime_error("Accessor without a bufferView is not supported");
     }
-}
-
-void Model::readAccessorVec4(const tinygltf::Model& model, int accessor_index, std::vector<glm::vec4>& out) {
-    const auto& accessor    = model.accessors[accessor_index];
-    const auto& buffer_view = model.bufferViews[accessor.bufferView];
-    const auto& buffer      = model.buffers[buffer_view.buffer];
-
-    const uint8_t* data = buffer.data.data() + buffer_view.byteOffset + accessor.byteOffset;
-
-    int num_components{};
-
-    switch (accessor.type) {
-        case TINYGLTF_TYPE_SCALAR:
-            num_components = 1;
-            break;
-        case TINYGLTF_TYPE_VEC2:
-            num_components = 2;
-            break;
-        case TINYGLTF_TYPE_VEC3:
-            num_components = 3;
-            break;
-        case TINYGLTF_TYPE_VEC4:
-            num_components = 4;
-            break;
-        default:
-            num_components = 0;
-            std::cerr << "ERROR : Unsupported accessor type!\n";
-            return;
-            break;
+    const tinygltf::BufferView& buffer_view = model.bufferViews[accessor.bufferView];
+    if (buffer_view.buffer < 0 || static_cast<size_t>(buffer_view.buffer) >= m_bufferData.size()) {
+        throw std::runtime_error("BufferView is out of the buffers");
     }
+    const std::span<const uint8_t>& buffer = m_bufferData[buffer_view.buffer];
 
-    size_t component_size{};
-
-    switch (accessor.componentType) {
-        case TINYGLTF_COMPONENT_TYPE_FLOAT:
-            component_size = 4;
-            break;
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-            component_size = 2;
-            break;
-        case TINYGLTF_COMPONENT_TYPE_SHORT:
-            component_size = 2;
-            break;
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-            component_size = 1;
-            break;
-        case TINYGLTF_COMPONENT_TYPE_BYTE:
-            component_size = 1;
-            break;
-        default:
-            component_size = 0;
-            std::cerr << "ERROR : Unsupported component size!\n";
-            return;
-            break;
+    int component_size = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+    int num_components = tinygltf::GetNumComponentsInType(accessor.type);
+    if (component_size <= 0 || num_components <= 0) {
+        throw std::runtime_error("Unsupported accessor type");
     }
 
-    size_t stride = (buffer_view.byteStride != 0U) ? buffer_view.byteStride : num_components * component_size;
-
-    out.resize(accessor.count);
-
-    for (size_t i = 0; i < accessor.count; i++) {
-
-        glm::vec4 v(0.0F);
-
-        const uint8_t* element = data + (i * stride);
-
-        for (int component = 0; component < num_components; component++) {
-            v[component] = readComponentAsFloat(
-                element + (component * component_size),
-                accessor.componentType,
-                accessor.normalized);
-        }
-
-        out[i] = v;
+    // the mapped and SAX loaders hand over the buffers unchecked : every element must lie inside the buffer
+    auto   element_size = static_cast<size_t>(component_size * num_components);
+    size_t stride       = buffer_view.byteStride != 0 ? buffer_view.byteStride : element_size;
+    size_t offset       = buffer_view.byteOffset + accessor.byteOffset;
+    if (offset < buffer_view.byteOffset || offset > buffer.size()) {
+        throw std::runtime_error("Accessor is out of its buffer bounds");
     }
-}
-
-void Model::readAccessorFloat(const tinygltf::Model& model, int accessor_index, std::vector<float>& out) {
-    std::vector<glm::vec4> tmp;
-    readAccessorVec4(model, accessor_index, tmp);
-
-    out.resize(tmp.size());
-    for (size_t i = 0; i < tmp.size(); i++) {
-        out[i] = tmp[i].x;
+    if (accessor.count != 0 && (buffer.size() - offset < element_size || (accessor.count - 1) > (buffer.size() - offset - element_size) / stride)) {
+        throw std::runtime_error("Accessor is out of its buffer bounds");
     }
+
+    return buffer.data() + offset;
 }
@@ -1,8 +1,14 @@
 #pragma once
+#include <functional>
+#include <memory>
 #include <print>
+#include <span>
 #include <string>
 
+#include "AccessorView.hpp"
+#include "LoadProfiler.hpp"
 #include "Texture.hpp"
+#include "TexturePacker.hpp"
 #include "Material.hpp"
 #include "Shader.hpp"
 #include "VertexBuffers.hpp"
@@ -25,10 +31,53 @@ enum class RenderIndexType {
     UNSIGNED_INT,
 };
 
+// cluster of up to MAX_VERTICES vertices / MAX_TRIANGLES triangles of a Primitive, with bounds for CPU culling
+struct Meshlet {
+    static constexpr uint32_t MAX_VERTICES  = 64;
+    static constexpr uint32_t MAX_TRIANGLES = 124;
+
+    uint32_t vertex_offset{ 0 };   // into Primitive::meshlet_vertices
+    uint32_t triangle_offset{ 0 }; // into Primitive::meshlet_triangles, in triangles
+    uint32_t vertex_count{ 0 };
+    uint32_t triangle_count{ 0 };
+
+    glm::vec3 center{ 0.0F }; // bounding sphere, primitive space
+    float     radius{ 0.0F };
+
+    glm::vec3 cone_apex{ 0.0F }; // every triangle faces away from a camera inside the cone
+    glm::vec3 cone_axis{ 0.0F };
+    float     cone_cutoff{ 1.0F }; // sin of the cone half-angle, 1 - never backface-culled
+
+    Meshlet()  = default;
+    ~Meshlet() = default;
+};
+
+// coarser index list of a Primitive, over the same vertices ( MeshSimplifier keeps only existing vertices )
+struct PrimitiveLod {
+    Indices indices;       // same index type as the primitive
+    float   error{ 0.0F }; // how far the surface may be from the full detail one, primitive space
+
+    PrimitiveLod()  = default;
+    ~PrimitiveLod() = default;
+};
+
 struct Primitive {
     Vertices vertices;
     Indices  indices;
 
+    std::vector<PrimitiveLod> lods;                  // coarser levels, lods[0] is LOD 1. Empty unless generated ( ModelLoadOptions::lod_ratios )
+    glm::vec3                 bounds_center{ 0.0F }; // bounding sphere, primitive space
+    float                     bounds_radius{ 0.0F };
+
+    CompactVertices compact_vertices;        // used instead of vertices when not empty ( vertices is empty then )
+    glm::vec3       position_offset{ 0.0F }; // compact_vertices position = position_offset + unorm16 * position_scale
+    glm::vec3       position_scale{ 1.0F };
+    bool            compact{ false };        // drawn from compact_vertices, stays set after Model::releaseUploadedData() frees them
+
+    std::vector<Meshlet>  meshlets;          // empty unless built ( ModelLoadOptions::build_meshlets )
+    std::vector<uint32_t> meshlet_vertices;  // vertex index of every meshlet vertex
+    std::vector<uint8_t>  meshlet_triangles; // 3 meshlet-local vertex indices per triangle
+
     int             material{ -1 };
     RenderMode      mode{ RenderMode::TRIANGLES }; // triangles by default
     RenderIndexType index_type{};
@@ -94,11 +143,13 @@ struct Node {
     glm::vec3 scale{ 1, 1, 1 };
     glm::vec3 translation{ 0, 0, 0 };
 
-    glm::mat4 local_matrix{ 1.0F };
-    glm::mat4 global_matrix{ 1.0F };
+    glm::mat4 local_matrix{ 1.0F }; // rest pose, the glTF matrix if the node has one. ModelInstance keeps the animated pose
 
     std::vector<double> weights;
 
+    std::vector<int>   lods;            // MSFT_lod : nodes drawn instead of this one, finest first
+    std::vector<float> screen_coverage; // MSFT_screencoverage : smallest screen height share of every level, this node included
+
     Node()  = default;
     ~Node() = default;
 };
@@ -109,130 +160,246 @@ struct Skin {
     int                    skeleton{ -1 }; // the index of the node used as a skeleton root
     std::vector<int>       joints;         // indices of skeleton nodes
 
-    std::vector<glm::mat4> bone_final_matrices;
-
     Skin()  = default;
     ~Skin() = default;
 };
 
+struct ModelLoadOptions {
+    bool                  memory_map{ false };   // map the .glb/.bin files, parse the JSON once with GltfSaxParser and read accessors straight from the mapping
+    bool                  sax_parser{ false };   // same as memory_map, the mapped load always reads the JSON with GltfSaxParser
+    bool                  use_cache{ false };    // load from / bake into the binary model cache
+    bool                  share_assets{ false }; // Initialize() : reuse the ModelAsset of a Model loaded from the same file ( AssetCache )
+    bool                  parallel{ true };      // load primitives and decode textures on ThreadPool::getGlobal()
+    std::filesystem::path cache_directory{};     // empty - ModelCache::getDefaultDirectory()
+
+    bool                  use_tangent_cache{ false };  // reuse MikkTSpace output of earlier loads
+    std::filesystem::path tangent_cache_directory{};   // empty - TangentCache::getDefaultDirectory()
+
+    bool weld_vertices{ false };         // merge bit-identical vertices and narrow the index type ( PrimitiveOptimizer )
+    bool optimize_vertex_cache{ false }; // reorder triangles for the post-transform cache, then vertices by first use
+    bool optimize_overdraw{ false };     // like optimize_vertex_cache, with the triangle clusters sorted front to back
+    bool compact_vertices{ false };      // store CompactVertex ( 28 bytes ) instead of Vertex ( 72 bytes )
+    bool build_meshlets{ false };        // split triangle lists into Meshlet clusters for MeshletCulling
+
+    std::vector<float> lod_ratios{};          // index count of every generated LOD relative to the full one, e.g. { 0.5, 0.25, 0.125 }
+    float              lod_max_error{ 0.05F }; // largest LOD error relative to the primitive bounding radius
+
+    unsigned int reduced_texture_size{ 64 }; // ModelStream : longest side of the low resolution textures published before the full ones
+
+    bool      generate_mipmaps{ false };          // build the mip chain of every mipmapped texture on the CPU ( MipGenerator ), baked into the cache
+    MipFilter mip_filter{ MipFilter::KAISER };
+
+    bool pack_channels{ false }; // "@channels=R/G/B" split images of one texture are packed back into one RGBA texture ( TexturePacker )
+    bool share_textures{ false }; // one Texture per image content, sampler and role, within the file and across models ( TextureRegistry )
+
+    TextureCompression texture_compression{ TextureCompression::NONE }; // BC formats by material role ( TextureCompressor ), mip chains are built on the CPU first
+    bool               compression_psnr{ false };                       // also measure every compressed texture against its pixels, decodes level 0 again
+
+    bool release_source{ false };   // free the glTF buffers once the geometry is converted and every encoded image once it is decoded
+    bool release_cpu_data{ false }; // the renderer drops vertices, indices and texels once they are uploaded ( Model::releaseUploadedData ), shared textures keep theirs
+    bool report_memory{ false };    // print the resident set size at the start, peak and end of the load and after the release
+    bool report_load{ false };      // print what every load pass did ( meshopt, tangents, welding, LODs, texture sharing and compression, ... )
+
+    bool                  profile{ false }; // time every load phase into ModelLoadStatistics::profile and print a summary table
+    std::filesystem::path profile_trace{};  // with profile, the phases are also written there as a Chrome trace-event JSON
+
+    ModelLoadOptions()  = default;
+    ~ModelLoadOptions() = default;
+};
+
+// post-transform cache numbers of an index buffer, from a FIFO cache simulation
+struct VertexCacheStatistics {
+    size_t triangles{ 0 };
+    size_t vertices{ 0 };             // unique vertices the triangles refer to
+    size_t vertices_transformed{ 0 }; // cache misses
+    float  acmr{ 0 };                 // average cache miss ratio : transformed / triangles, 0.5 .. 3
+    float  atvr{ 0 };                 // average transform to vertex ratio : transformed / vertices, 1 is ideal
+
+    VertexCacheStatistics()  = default;
+    ~VertexCacheStatistics() = default;
+};
+
+struct PrimitiveCacheStatistics {
+    size_t                mesh{ 0 };
+    size_t                primitive{ 0 };
+    VertexCacheStatistics before{};
+    VertexCacheStatistics after{};
+
+    PrimitiveCacheStatistics()  = default;
+    ~PrimitiveCacheStatistics() = default;
+};
+
+// filled by Model::Initialize, all zero after a model cache or asset cache hit but the rss_*, cpu_bytes* and shared_texture* ones after a model cache hit
+struct ModelLoadStatistics {
+    size_t tangent_primitives{ 0 };     // primitives without TANGENT
+    size_t tangent_cache_hits{ 0 };     // of them, restored from the tangent cache
+    double tangent_generation_ms{ 0 };  // time spent in MikkTSpace ( summed over threads )
+    double tangent_cache_saved_ms{ 0 }; // generation time of the cache hits minus their lookup time
+
+    size_t welded_vertices{ 0 };     // vertices removed by PrimitiveOptimizer::weldVertices
+    size_t compact_primitives{ 0 };  // primitives stored as CompactVertex
+    size_t compact_bytes_saved{ 0 }; // vertex bytes saved by them
+    size_t meshlets{ 0 };
+
+    size_t lods{ 0 };           // generated PrimitiveLod levels
+    size_t lod_triangles{ 0 };  // triangles in them
+    size_t lod0_triangles{ 0 }; // full detail triangles of the primitives that got them
+
+    size_t meshopt_views{ 0 };            // EXT_meshopt_compression bufferViews decoded
+    size_t meshopt_compressed_bytes{ 0 }; // their compressed size
+    size_t meshopt_decoded_bytes{ 0 };    // their size after decoding
+    double meshopt_decode_ms{ 0 };        // wall time of the decoding
+
+    size_t rss_start{ 0 };          // resident set size when the load started ( ProcessMemory )
+    size_t rss_peak{ 0 };           // highest during the load, exact if the process peak rose, else the highest of the samples between the steps
+    size_t rss_end{ 0 };            // when the load returned
+    size_t rss_released{ 0 };       // after the last releaseUploadedData()
+    size_t cpu_bytes{ 0 };          // vertices, indices, meshlets and texels the asset held when the load returned
+    size_t cpu_bytes_released{ 0 }; // of them, dropped by releaseUploadedData()
+
+    size_t packed_textures{ 0 }; // glTF textures merged into another one by ModelLoadOptions::pack_channels
+
+    size_t shared_textures_local{ 0 };    // ModelLoadOptions::share_textures : textures that are another texture of the same file
+    size_t shared_textures_registry{ 0 }; // textures another model had already loaded ( TextureRegistry ), after a model cache hit too
+    size_t shared_texture_bytes{ 0 };     // texels neither decoded nor stored again because of them, their GPU copies are shared as well
+
+    std::vector<PrimitiveCacheStatistics> vertex_cache; // one per optimized primitive
+    std::vector<LoadProfileEvent>         profile;      // ModelLoadOptions::profile : every timed phase, by start time
+
+    std::vector<TextureCompressionReport> texture_compression; // ModelLoadOptions::texture_compression : one per compressed texture
+
+    ModelLoadStatistics()  = default;
+    ~ModelLoadStatistics() = default;
+};
+
+// parts of a model a staged load ( ModelStream ) publishes, in this order
+enum class ModelLoadStage {
+    NONE,
+    HIERARCHY,        // nodes, scene roots, skins, materials, animations, meshes with primitive bounds but no geometry, empty textures
+    GEOMETRY,         // every primitive
+    LOW_RES_TEXTURES, // every texture, reduced to ModelLoadOptions::reduced_texture_size
+    TEXTURES,         // every texture at full resolution, the load is complete
+};
+
+// hooks of a staged load, called on the loading threads
+struct ModelLoadCallbacks {
+    std::function<void(ModelLoadStage stage)>              on_stage;           // the stage's members are final from here on
+    std::function<void(size_t texture, Texture&& reduced)> on_reduced_texture; // right after the texture is decoded, from any thread
+    std::function<bool()>                                  is_cancelled;       // checked between the stages
+
+    ModelLoadCallbacks()  = default;
+    ~ModelLoadCallbacks() = default;
+};
+
+// everything loaded from one glTF file. Never changes after the load, shared by every ModelInstance drawing it and
+// by every Model loaded from the same file ( AssetCache )
+// written only by the load that created it, read-only once a Model hands it out through getAsset()
+struct ModelAsset {
+    std::vector<Node>      nodes; // rest pose
+    std::vector<int>       scene_roots;
+    std::vector<Skin>      skins;
+    std::vector<Mesh>      meshes;
+    std::vector<Material>  materials;
+    std::vector<Animation> animations;
+
+    std::vector<std::shared_ptr<Texture>> textures; // shared by the models using the same images with ModelLoadOptions::share_textures
+
+    ModelAsset()  = default;
+    ~ModelAsset() = default;
+};
+
+class TangentCache; // forward declaration
+
+// loads a glTF file into a ModelAsset, ModelInstance draws and animates it
 class Model {
+    friend class AssetCache;
+    friend class ModelCache;
+    friend class ModelStream;
+
 public:
     Model() = default;
     ~Model() { this->Release(); }
 
     void Release();
-    void Initialize(const std::filesystem::path& path);
-    void Draw(const Shader& shader, float time);
+    void Initialize(const std::filesystem::path& path, const ModelLoadOptions& options = {});
+
+    inline const std::vector<Mesh>&                     getMeshes() const noexcept { return m_asset->meshes; }
+    inline const std::vector<std::shared_ptr<Texture>>& getTextures() const noexcept { return m_asset->textures; } // nullptr until loaded
+    inline const ModelLoadStatistics&                   getLoadStatistics() const noexcept { return m_loadStatistics; }
 
-    inline const std::vector<Mesh>& getMeshes() const noexcept { return m_meshes; }
-    inline const std::vector<Texture>& getTextures() const noexcept { return m_textures; }
+    // models loaded through the same AssetCache entry return the same pointer, the renderers key their GPU copies by it
+    inline std::shared_ptr<const ModelAsset> getAsset() const noexcept { return m_asset; }
+
+    // renderers call it once the GPU copies exist, does nothing unless ModelLoadOptions::release_cpu_data
+    // geometry - every primitive's vertices and indices ( the counts, bounds and meshlets stay ), textures - their texels
+    // the asset cannot be uploaded again afterwards, by this model or by any other one sharing it
+    void releaseUploadedData(bool geometry, std::span<const size_t> textures);
 
 private:
+    // Initialize() with callbacks == nullptr, ModelStream runs it on a worker with its hooks
+    void        load(const std::filesystem::path& path, const ModelLoadOptions& options, const ModelLoadCallbacks* callbacks);
+    bool        isLoadCancelled() const;
+    void        decodeMeshoptViews(tinygltf::Model& model, bool parallel);
     void        loadNodes(const tinygltf::Model& model);
     void        loadSceneRoots(const tinygltf::Model& model);
     void        loadSkins(const tinygltf::Model& model);
-    void        loadMeshes(const tinygltf::Model& model);
-    void        loadPrimitives(const tinygltf::Model& model, std::vector<Primitive>& this_primitives, const std::vector<tinygltf::Primitive>& primitives);
-    void        loadVertices(const tinygltf::Model& model, Vertices& this_vertices, Indices& this_indices, const tinygltf::Primitive& primitive);
-    static void loadIndices(const tinygltf::Model& model, Primitive& this_primitive, Indices& this_indices, const tinygltf::Primitive& primitive);
+    void        loadMeshBounds(const tinygltf::Model& model); // placeholder meshes : no geometry, bounds from the POSITION min / max
+    void        loadMeshes(const tinygltf::Model& model, bool parallel);
+    void        loadPrimitive(const tinygltf::Model& model, Primitive& this_primitive, const tinygltf::Primitive& primitive, ModelLoadStatistics& statistics);
+    void        loadVertices(const tinygltf::Model& model, Vertices& this_vertices, const Indices& this_indices, const tinygltf::Primitive& primitive, ModelLoadStatistics& statistics);
+    void        generateTangents(Vertices& this_vertices, const Indices& this_indices, ModelLoadStatistics& statistics) const;
+    void        loadIndices(const tinygltf::Model& model, Primitive& this_primitive, Indices& this_indices, const tinygltf::Primitive& primitive) const;
     void        loadMaterials(const tinygltf::Model& model);
-    void        loadTextures(const tinygltf::Model& model);
+    void        loadTextures(tinygltf::Model& model, const TexturePackingPlan& packing, bool parallel); // with release_source, moves the images out of the model
     void        loadAnimations(const tinygltf::Model& model);
 
 private:
-    void applyAnimationToNodes(int index, float time);
-    void updateNodeTransforms();
-    void updateNodeRecursive(int index, const glm::mat4& parent);
-    void updateSkinMatrices();
-    void drawNode(const Node& node, const Shader& shader);
-    void drawMesh(const Mesh& mesh, int skin_index, const Shader& shader, const glm::mat4& matrix);
-    void drawPrimitive(const Primitive& primitive, const Shader& shader);
-    void bindMaterial(const Material& material, const Shader& shader);
-    void bindTexture(const Shader& shader, const std::string& uniform, int texture_index, int slot);
-
-private:
+    // typed view of an accessor inside m_bufferData, throws if it does not fit into its buffer
     template <typename T>
-        requires(std::is_same_v<T, glm::vec2> ||
-                 std::is_same_v<T, glm::vec3> ||
-                 std::is_same_v<T, glm::vec4> ||
-                 std::is_same_v<T, glm::uvec4> ||
-                 std::is_same_v<T, glm::u16vec4> ||
-                 std::is_same_v<T, glm::mat4>)
-    void readAttribute(const tinygltf::Model& model, size_t accessor_index, std::vector<T>& out) {
-        const tinygltf::Accessor&   accessor    = model.accessors[accessor_index];
-        const tinygltf::BufferView& buffer_view = model.bufferViews[accessor.bufferView];
-        const tinygltf::Buffer&     buffer      = model.buffers[buffer_view.buffer];
-
-        const uint8_t* data_ptr       = buffer.data.data() + buffer_view.byteOffset + accessor.byteOffset;
-        int            component_size = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-        int            num_components = tinygltf::GetNumComponentsInType(accessor.type);
-
-        auto   element_size = static_cast<size_t>(component_size * num_components);
-        size_t stride       = buffer_view.byteStride != 0 ? buffer_view.byteStride : element_size;
-
-        out.resize(accessor.count);
-
-        if (fastCopy<T>(accessor, buffer_view, buffer, out)) {
-            return;
+    AccessorView<T> getAccessorView(const tinygltf::Model& model, int accessor_index) const {
+        if (accessor_index < 0 || static_cast<size_t>(accessor_index) >= model.accessors.size()) {
+            throw std::runtime_error("Accessor index is out of range");
         }
+        const tinygltf::Accessor& accessor = model.accessors[accessor_index];
+        const uint8_t*            data     = this->getAccessorData(model, accessor); // checks the whole accessor against its buffer
 
-        for (size_t i = 0; i < accessor.count; i++) {
-            const uint8_t* p = data_ptr + (i * stride);
-
-            if constexpr (std::is_same_v<T, glm::vec2>) {
-                const auto* f = reinterpret_cast<const float*>(p);
-                out[i]        = glm::vec2(f[0], f[1]);
-            }
-            else if constexpr (std::is_same_v<T, glm::vec3>) {
-                const auto* f = reinterpret_cast<const float*>(p);
-                out[i]        = glm::vec3(f[0], f[1], f[2]);
-            }
-            else if constexpr (std::is_same_v<T, glm::vec4>) {
-                const auto* f = reinterpret_cast<const float*>(p);
-                out[i]        = glm::vec4(f[0], f[1], f[2], f[3]);
-            }
-            else if constexpr (std::is_same_v<T, glm::u16vec4>) {
-                const auto* ptr = reinterpret_cast<const uint16_t*>(p);
-                out[i]          = glm::u16vec4(ptr[0], ptr[1], ptr[2], ptr[3]);
-            }
-            else if constexpr (std::is_same_v<T, glm::mat4>) {
-                glm::mat4 m{};
-                memcpy(glm::value_ptr(m), data_ptr + (i * stride), sizeof(glm::mat4));
-                out[i] = m;
-            }
-        }
-    }
+        const tinygltf::BufferView& buffer_view    = model.bufferViews[accessor.bufferView];
+        int                         num_components = tinygltf::GetNumComponentsInType(accessor.type);
+        size_t                      stride         = buffer_view.byteStride != 0 ? buffer_view.byteStride : static_cast<size_t>(tinygltf::GetComponentSizeInBytes(accessor.componentType) * num_components);
 
-    template <typename T>
-    [[nodiscard]] bool fastCopy(const tinygltf::Accessor& accessor, const tinygltf::BufferView& buffer_view, const tinygltf::Buffer& buffer, std::vector<T>& out) {
-        if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT) {
-            size_t element_size = sizeof(T);
-            size_t stride       = buffer_view.byteStride ? buffer_view.byteStride : element_size;
-            if (stride == element_size) {
-                const uint8_t* src = buffer.data.data() + buffer_view.byteOffset + accessor.byteOffset;
-                out.resize(accessor.count);
-                memcpy(out.data(), src, accessor.count * element_size);
-                return true;
-            }
-        }
-        return false;
+        return { data, accessor.count, stride, accessor.componentType, accessor.normalized, num_components };
     }
 
+    static size_t countCpuBytes(const ModelAsset& asset);      // vertices, indices, meshlets and texels
+    static size_t countPrimitiveBytes(const Primitive& primitive);
+    void          sampleMemory();                              // raises rss_peak to the current resident set size
+    void          finishMemoryStatistics(size_t process_peak); // process_peak - ProcessMemory::getPeakResidentBytes() when the load started
+
+    static size_t getAccessorBytes(const tinygltf::Model& model, int accessor_index); // 0 without an accessor
+    void          finishProfile(const ModelLoadOptions& options);                     // moves the events into the statistics, prints and writes them
+    void          reportLoadStatistics(const std::string& filename) const; // ModelLoadOptions::report_load, the same numbers as ModelLoadStatistics
+    void          reportTextureSharing(const std::string& filename) const;
+
     static void readVector(glm::vec2& dst, const std::vector<double>& src);
     static void readVector(glm::vec3& dst, const std::vector<double>& src);
     static void readVector(glm::vec4& dst, const std::vector<double>& src);
     static void readVector(glm::quat& dst, const std::vector<double>& src);
 
-    static float readComponentAsFloat(const uint8_t* data, int component_type, bool normalized);
-    static void  readAccessorVec4(const tinygltf::Model& model, int accessor_index, std::vector<glm::vec4>& out);
-    static void  readAccessorFloat(const tinygltf::Model& model, int accessor_index, std::vector<float>& out);
+    // first element of the accessor inside m_bufferData, throws unless every element of it fits into its buffer
+    const uint8_t* getAccessorData(const tinygltf::Model& model, const tinygltf::Accessor& accessor) const;
 
 private:
-    std::vector<Node>      m_nodes;
-    std::vector<int>       m_sceneRoots;
-    std::vector<Skin>      m_skins;
-    std::vector<Mesh>      m_meshes;
-    std::vector<Material>  m_materials;
-    std::vector<Texture>   m_textures;
-    std::vector<Animation> m_animations;
+    std::shared_ptr<ModelAsset> m_asset{ std::make_shared<ModelAsset>() }; // a new one on every load()
+
+    ModelLoadStatistics m_loadStatistics;
+    std::string         m_name;                    // file name, for the memory report
+    bool                m_releaseCpuData{ false }; // ModelLoadOptions::release_cpu_data of the load
+    bool                m_reportMemory{ false };   // ModelLoadOptions::report_memory of the load
+
+    std::vector<std::span<const uint8_t>> m_bufferData;               // glTF buffers ( heap or mapped ). Valid only during Initialize()
+    std::vector<std::vector<uint8_t>>     m_decodedBuffers;           // decoded EXT_meshopt_compression bufferViews, m_bufferData views them
+    const TangentCache*                   m_tangentCache{ nullptr };  // valid only during Initialize()
+    const ModelLoadOptions*               m_loadOptions{ nullptr };   // valid only during Initialize()
+    const ModelLoadCallbacks*             m_loadCallbacks{ nullptr }; // valid only during a staged load
+    LoadProfiler*                         m_profiler{ nullptr };      // valid only during Initialize() with ModelLoadOptions::profile
 };
@@ -0,0 +1,721 @@
+#include "ModelCache.hpp"
+
+#include <bit>
+#include <charconv>
+#include <fstream>
+
+#include "Model.hpp"
+#include "MappedFile.hpp"
+#include "Hash.hpp"
+#include "TextureRegistry.hpp"
+
+static constexpr char   CACHE_MAGIC[8]  = { 'S', 'K', 'M', 'C', 'A', 'C', 'H', 'E' };
+static constexpr size_t CACHE_ALIGNMENT = 16;
+
+struct CacheHeader {
+    char     magic[8]{};
+    uint32_t format_version{};
+    uint32_t loader_version{};
+    uint64_t source_hash{};  // canonical source path
+    uint64_t options_hash{}; // ModelCache::hashOptions
+    uint64_t content_hash{}; // source file + dependencies
+    uint64_t file_size{};
+    uint32_t dependency_count{};
+    uint32_t reserved{};
+};
+
+class CacheWriter {
+public:
+    CacheWriter()  = default;
+    ~CacheWriter() = default;
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        this->write<uint64_t>(values.size());
+        this->align();
+        const auto* bytes = reinterpret_cast<const uint8_t*>(values.data());
+        m_bytes.insert(m_bytes.end(), bytes, bytes + (values.size() * sizeof(T)));
+    }
+
+    void writeBytes(const uint8_t* data, size_t size) {
+        this->write<uint64_t>(size);
+        this->align();
+        m_bytes.insert(m_bytes.end(), data, data + size);
+    }
+
+    void writeString(const std::string& string) {
+        this->write<uint64_t>(string.size());
+        m_bytes.insert(m_bytes.end(), string.begin(), string.end());
+    }
+
+    void align() {
+        m_bytes.resize((m_bytes.size() + CACHE_ALIGNMENT - 1) & ~(CACHE_ALIGNMENT - 1));
+    }
+
+    inline std::vector<uint8_t>& getBytes() noexcept { return m_bytes; }
+
+private:
+    std::vector<uint8_t> m_bytes;
+};
+
+class CacheReader {
+public:
+    explicit CacheReader(std::span<const uint8_t> bytes) : m_bytes(bytes) {}
+    ~CacheReader() = default;
+
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        memcpy(&value, this->take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void readArray(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto count = this->read<uint64_t>();
+        this->align();
+        if (count > this->getRemaining() / sizeof(T)) {
+            throw std::runtime_error("Model cache array is out of bounds");
+        }
+        values.resize(count);
+        memcpy(values.data(), this->take(count * sizeof(T)), count * sizeof(T));
+    }
+
+    // element count of a container whose elements take at least min_bytes each in the file
+    // a broken count fails here instead of sizing the container
+    size_t readCount(size_t min_bytes) {
+        auto count = this->read<uint64_t>();
+        if (count > this->getRemaining() / min_bytes) {
+            throw std::runtime_error("Model cache count is out of bounds");
+        }
+        return count;
+    }
+
+    // last - the highest enumerator, anything above it is a broken file
+    template <typename T>
+    T readEnum(T last) {
+        static_assert(std::is_enum_v<T>);
+        auto value = this->read<std::underlying_type_t<T>>();
+        if (value < 0 || value > static_cast<std::underlying_type_t<T>>(last)) {
+            throw std::runtime_error("Invalid enum value in model cache");
+        }
+        return static_cast<T>(value);
+    }
+
+    bool readBool() {
+        auto value = this->read<uint8_t>();
+        if (value > 1) {
+            throw std::runtime_error("Invalid bool value in model cache");
+        }
+        return value != 0;
+    }
+
+    inline size_t getRemaining() const noexcept { return m_offset < m_bytes.size() ? m_bytes.size() - m_offset : 0; }
+
+    std::span<const uint8_t> readBytes() {
+        auto size = this->read<uint64_t>();
+        this->align();
+        return { this->take(size), size };
+    }
+
+    std::string readString() {
+        auto        size = this->read<uint64_t>();
+        const auto* data = reinterpret_cast<const char*>(this->take(size));
+        return { data, size };
+    }
+
+    void align() {
+        m_offset = (m_offset + CACHE_ALIGNMENT - 1) & ~(CACHE_ALIGNMENT - 1);
+    }
+
+private:
+    const uint8_t* take(size_t size) {
+        if (m_offset > m_bytes.size() || size > m_bytes.size() - m_offset) {
+            throw std::runtime_error("Model cache is truncated");
+        }
+        const uint8_t* data = m_bytes.data() + m_offset;
+        m_offset += size;
+        return data;
+    }
+
+private:
+    std::span<const uint8_t> m_bytes;
+    size_t                   m_offset{ 0 };
+};
+
+// the indices a cache file stores must stay inside the containers they point into, -1 for none where allowed
+static void checkIndex(int index, size_t size, bool optional) {
+    if ((index < 0 && !(optional && index == -1)) || (index >= 0 && static_cast<size_t>(index) >= size)) {
+        throw std::runtime_error("Model cache index is out of bounds");
+    }
+}
+
+static void validateReferences(const std::vector<Node>&                     nodes,
+                               const std::vector<int>&                      scene_roots,
+                               const std::vector<Skin>&                     skins,
+                               const std::vector<Mesh>&                     meshes,
+                               const std::vector<Material>&                 materials,
+                               const std::vector<std::shared_ptr<Texture>>& textures,
+                               const std::vector<Animation>&                animations) {
+    for (const Node& node : nodes) {
+        checkIndex(node.skin, skins.size(), true);
+        checkIndex(node.mesh, meshes.size(), true);
+        for (int child : node.children) {
+            checkIndex(child, nodes.size(), false);
+        }
+        for (int lod : node.lods) {
+            checkIndex(lod, nodes.size(), false);
+        }
+    }
+    for (int root : scene_roots) {
+        checkIndex(root, nodes.size(), false);
+    }
+    for (const Skin& skin : skins) {
+        checkIndex(skin.skeleton, nodes.size(), true);
+        for (int joint : skin.joints) {
+            checkIndex(joint, nodes.size(), false);
+        }
+    }
+
+    for (const Mesh& mesh : meshes) {
+        for (const Primitive& primitive : mesh.primitives) {
+            checkIndex(primitive.material, materials.size(), true);
+            if (primitive.indices.index() != static_cast<size_t>(primitive.index_type) || primitive.index_count > std::visit([](const auto& indices) { return indices.size(); }, primitive.indices)) {
+                throw std::runtime_error("Model cache indices do not match their primitive");
+            }
+        }
+    }
+
+    for (const Material& material : materials) {
+        for (int texture : { material.pbr_metallic_roughness.base_color_texture.index,
+                             material.pbr_metallic_roughness.metallic_roughness_texture.index,
+                             material.normal_texture.index,
+                             material.occlusion_texture.index,
+                             material.emissive_texture.index }) {
+            checkIndex(texture, textures.size(), true);
+        }
+        for (int lod : material.lods) {
+            checkIndex(lod, materials.size(), false);
+        }
+    }
+
+    for (const Animation& animation : animations) {
+        for (const AnimationChannel& channel : animation.channels) {
+            checkIndex(channel.sampler, animation.samplers.size(), false);
+            checkIndex(channel.target_node, nodes.size(), true); // glTF allows channels without a node
+        }
+    }
+}
+
+static uint64_t hashSourcePath(const std::filesystem::path& source) {
+    std::error_code error{};
+    auto            canonical = std::filesystem::weakly_canonical(source, error);
+    auto            string    = (error ? source : canonical).generic_u8string();
+    return hashBytes(string.data(), string.size());
+}
+
+std::filesystem::path ModelCache::getDefaultDirectory() {
+    std::error_code error{};
+    auto            temp = std::filesystem::temp_directory_path(error);
+    if (error) {
+        temp = std::filesystem::current_path();
+    }
+    return temp / "SkeletonAnimationTestAdventure" / "ModelCache";
+}
+
+std::filesystem::path ModelCache::getCachePath(const std::filesystem::path& source, const ModelLoadOptions& options) const {
+    uint64_t name_hash = hashCombine(hashSourcePath(source), ModelCache::hashOptions(options));
+
+    char name[17]{};
+    std::to_chars(name, name + 16, name_hash, 16);
+    return m_directory / (std::string(name) + ".skmcache");
+}
+
+uint64_t ModelCache::hashOptions(const ModelLoadOptions& options) {
+    uint64_t hash = HASH_SEED;
+    hash          = hashCombine(hash, options.weld_vertices);
+    hash          = hashCombine(hash, options.optimize_vertex_cache);
+    hash          = hashCombine(hash, options.optimize_overdraw);
+    hash          = hashCombine(hash, options.compact_vertices);
+    hash          = hashCombine(hash, options.build_meshlets);
+    hash          = hashBytes(options.lod_ratios.data(), options.lod_ratios.size() * sizeof(float), hash);
+    hash          = hashCombine(hash, std::bit_cast<uint32_t>(options.lod_max_error));
+    hash          = hashCombine(hash, options.generate_mipmaps);
+    hash          = hashCombine(hash, static_cast<uint64_t>(options.mip_filter));
+    hash          = hashCombine(hash, options.pack_channels);
+    hash          = hashCombine(hash, options.share_textures);
+    hash          = hashCombine(hash, static_cast<uint64_t>(options.texture_compression));
+    return hash;
+}
+
+std::vector<std::string> ModelCache::collectDependencies(const tinygltf::Model& model, const std::vector<std::string>* buffer_uris) {
+    std::vector<std::string> dependencies{};
+
+    auto add_uri = [&](const std::string& uri, bool decoded) {
+        if (uri.empty() || tinygltf::IsDataURI(uri)) {
+            return;
+        }
+        std::string decoded_uri = uri;
+        if (!decoded) {
+            tinygltf::URIDecode(uri, &decoded_uri, nullptr);
+        }
+        dependencies.emplace_back(std::move(decoded_uri));
+    };
+
+    if (buffer_uris != nullptr) {
+        for (const auto& uri : *buffer_uris) {
+            add_uri(uri, true);
+        }
+    }
+    else {
+        for (const auto& buffer : model.buffers) {
+            add_uri(buffer.uri, false);
+        }
+    }
+
+    for (const auto& image : model.images) {
+        add_uri(image.uri, false);
+    }
+
+    return dependencies;
+}
+
+uint64_t ModelCache::hashContent(const std::filesystem::path& source, const std::vector<std::string>& dependencies) {
+    auto hash_file = [](const std::filesystem::path& path) -> uint64_t {
+        MappedFile file{};
+        if (!file.Initialize(path)) {
+            return 0; // missing or empty, still a valid state to compare against
+        }
+        return hashBytes(file.bytes());
+    };
+
+    uint64_t hash = hashCombine(HASH_SEED, hash_file(source));
+    for (const auto& dependency : dependencies) {
+        hash = hashCombine(hash, hashString(dependency));
+        hash = hashCombine(hash, hash_file(source.parent_path() / std::filesystem::u8path(dependency)));
+    }
+    return hash;
+}
+
+void ModelCache::Save(const Model& model, const std::filesystem::path& source, const ModelLoadOptions& options, const std::vector<std::string>& dependencies) const {
+    // a texture without its texels would be cached as an empty one, Load() rejects it and the cache never hits
+    for (const auto& texture : model.m_asset->textures) {
+        if (texture != nullptr && texture->getBytes() == nullptr && texture->getByteSize() > 0) {
+            std::println("WARNING : Model cache not written, the texels of a texture were released : {}", source.string());
+            return;
+        }
+    }
+
+    CacheWriter writer{};
+
+    CacheHeader header{};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.format_version   = FORMAT_VERSION;
+    header.loader_version   = LOADER_VERSION;
+    header.source_hash      = hashSourcePath(source);
+    header.options_hash     = ModelCache::hashOptions(options);
+    header.content_hash     = ModelCache::hashContent(source, dependencies);
+    header.dependency_count = static_cast<uint32_t>(dependencies.size());
+    writer.write(header);
+
+    for (const auto& dependency : dependencies) {
+        writer.writeString(dependency);
+    }
+
+    // nodes
+    writer.write<uint64_t>(model.m_asset->nodes.size());
+    for (const Node& node : model.m_asset->nodes) {
+        writer.write(node.camera);
+        writer.write(node.skin);
+        writer.write(node.mesh);
+        writer.write(node.light);
+        writer.write(node.emitter);
+        writer.writeString(node.name);
+        writer.writeArray(node.children);
+        writer.write(node.rotation);
+        writer.write(node.scale);
+        writer.write(node.translation);
+        writer.write(node.local_matrix);
+        writer.writeArray(node.weights);
+        writer.writeArray(node.lods);
+        writer.writeArray(node.screen_coverage);
+    }
+
+    writer.writeArray(model.m_asset->scene_roots);
+
+    // skins
+    writer.write<uint64_t>(model.m_asset->skins.size());
+    for (const Skin& skin : model.m_asset->skins) {
+        writer.writeString(skin.name);
+        writer.writeArray(skin.inverse_bind_matrices);
+        writer.write(skin.skeleton);
+        writer.writeArray(skin.joints);
+    }
+
+    // meshes
+    writer.write<uint64_t>(model.m_asset->meshes.size());
+    for (const Mesh& mesh : model.m_asset->meshes) {
+        writer.writeString(mesh.name);
+        writer.writeArray(mesh.weights);
+        writer.write<uint64_t>(mesh.primitives.size());
+        for (const Primitive& primitive : mesh.primitives) {
+            writer.write(primitive.material);
+            writer.write(primitive.mode);
+            writer.write(primitive.index_type);
+            writer.write<uint64_t>(primitive.index_count);
+            writer.write<uint64_t>(primitive.index_offset);
+            writer.writeArray(primitive.vertices);
+            writer.writeArray(primitive.compact_vertices);
+            writer.write(primitive.position_offset);
+            writer.write(primitive.position_scale);
+            writer.writeArray(primitive.meshlets);
+            writer.writeArray(primitive.meshlet_vertices);
+            writer.writeArray(primitive.meshlet_triangles);
+            writer.write<uint32_t>(static_cast<uint32_t>(primitive.indices.index()));
+            std::visit([&](const auto& indices) { writer.writeArray(indices); }, primitive.indices);
+            writer.write(primitive.bounds_center);
+            writer.write(primitive.bounds_radius);
+            writer.write<uint64_t>(primitive.lods.size());
+            for (const PrimitiveLod& lod : primitive.lods) {
+                writer.write(lod.error);
+                writer.write<uint32_t>(static_cast<uint32_t>(lod.indices.index()));
+                std::visit([&](const auto& indices) { writer.writeArray(indices); }, lod.indices);
+            }
+        }
+    }
+
+    // materials
+    writer.write<uint64_t>(model.m_asset->materials.size());
+    for (const Material& material : model.m_asset->materials) {
+        writer.writeString(material.name);
+        writer.write(material.emissive_factor);
+        writer.write(material.alpha_mode);
+        writer.write(material.alpha_cutoff);
+        writer.write(material.double_sided);
+        writer.writeArray(material.lods);
+        writer.write(material.pbr_metallic_roughness);
+        writer.write(material.normal_texture);
+        writer.write(material.occlusion_texture);
+        writer.write(material.emissive_texture);
+    }
+
+    // textures ( decoded ), one used again by the file is stored as the index of its first use
+    const auto& textures = model.m_asset->textures;
+    writer.write<uint64_t>(textures.size());
+    for (size_t i = 0; i < textures.size(); i++) {
+        auto first = std::find(textures.begin(), textures.begin() + static_cast<ptrdiff_t>(i), textures[i]);
+        writer.write<int64_t>(first != textures.begin() + static_cast<ptrdiff_t>(i) ? first - textures.begin() : -1);
+        if (first != textures.begin() + static_cast<ptrdiff_t>(i)) {
+            continue;
+        }
+
+        const Texture& texture = *textures[i];
+        writer.write(texture.getRegistryKey());
+        writer.write(texture.getWidth());
+        writer.write(texture.getHeight());
+        writer.write(texture.getComponents());
+        writer.write(texture.getInternalFormat());
+        writer.write(texture.getDataFormat());
+        writer.write(texture.getMinFilter());
+        writer.write(texture.getMagFilter());
+        writer.write(texture.getWrapS());
+        writer.write(texture.getWrapT());
+        writer.write(texture.getMipLevels());
+        size_t size = texture.getBytes() != nullptr ? texture.getByteSize() : 0; // the whole mip chain
+        writer.writeBytes(texture.getBytes(), size);
+    }
+
+    // animations
+    writer.write<uint64_t>(model.m_asset->animations.size());
+    for (const Animation& animation : model.m_asset->animations) {
+        writer.write<uint64_t>(animation.channels.size());
+        for (const AnimationChannel& channel : animation.channels) {
+            writer.write(channel.sampler);
+            writer.write(channel.target_node);
+            writer.writeString(channel.target_path);
+        }
+        writer.write<uint64_t>(animation.samplers.size());
+        for (const AnimationSampler& sampler : animation.samplers) {
+            writer.writeArray(sampler.times);
+            writer.writeArray(sampler.values);
+            writer.write(sampler.interpolation);
+        }
+    }
+
+    auto& bytes = writer.getBytes();
+
+    header.file_size = bytes.size();
+    memcpy(bytes.data(), &header, sizeof(CacheHeader));
+
+    std::filesystem::path path      = this->getCachePath(source, options);
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+
+    try {
+        std::filesystem::create_directories(m_directory);
+
+        { // write next to the target and swap, a half-written cache is never visible
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Failed to open " + temp_path.string());
+            }
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!file) {
+                throw std::runtime_error("Failed to write " + temp_path.string());
+            }
+        }
+
+        std::filesystem::rename(temp_path, path);
+    }
+    catch (const std::exception& e) {
+        std::println("WARNING : Failed to save model cache : {}", e.what());
+
+        std::error_code error{};
+        std::filesystem::remove(temp_path, error);
+    }
+}
+
+bool ModelCache::Load(Model& model, const std::filesystem::path& source, const ModelLoadOptions& options) const {
+    MappedFile file{};
+    if (!file.Initialize(this->getCachePath(source, options))) {
+        return false;
+    }
+
+    try {
+        CacheReader reader(file.bytes());
+
+        auto header = reader.read<CacheHeader>();
+        if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+            header.format_version != FORMAT_VERSION ||
+            header.loader_version != LOADER_VERSION ||
+            header.file_size != file.size() ||
+            header.source_hash != hashSourcePath(source) ||
+            header.options_hash != ModelCache::hashOptions(options)) {
+            return false;
+        }
+
+        if (header.dependency_count > reader.getRemaining() / sizeof(uint64_t)) {
+            return false;
+        }
+        std::vector<std::string> dependencies(header.dependency_count);
+        for (auto& dependency : dependencies) {
+            dependency = reader.readString();
+        }
+
+        if (header.content_hash != ModelCache::hashContent(source, dependencies)) {
+            return false; // the source changed, the next regular load rebuilds the cache
+        }
+
+        // read into locals first, a broken file must not leave a half-filled model
+        // every count is bounded by the bytes its elements need at least, every enum is checked : a broken file is a miss
+        constexpr size_t NODE_BYTES      = (5 * sizeof(int)) + (5 * sizeof(uint64_t)) + sizeof(glm::quat) + (2 * sizeof(glm::vec3)) + sizeof(glm::mat4);
+        constexpr size_t SKIN_BYTES      = (3 * sizeof(uint64_t)) + sizeof(int);
+        constexpr size_t MESH_BYTES      = 3 * sizeof(uint64_t);
+        constexpr size_t PRIMITIVE_BYTES = (3 * sizeof(int)) + sizeof(uint32_t) + (9 * sizeof(uint64_t)) + (3 * sizeof(glm::vec3)) + sizeof(float);
+        constexpr size_t LOD_BYTES       = sizeof(float) + sizeof(uint32_t) + sizeof(uint64_t);
+        constexpr size_t MATERIAL_BYTES  = (2 * sizeof(uint64_t)) + sizeof(glm::vec3) + sizeof(int) + sizeof(double) + sizeof(bool) +
+                                          sizeof(Material::PbrMetallicRoughness) + sizeof(Material::NormalTextureInfo) + sizeof(Material::OcclusionTextureInfo) + sizeof(Material::TextureInfo);
+        constexpr size_t TEXTURE_BYTES   = sizeof(int64_t);
+        constexpr size_t ANIMATION_BYTES = 2 * sizeof(uint64_t);
+        constexpr size_t CHANNEL_BYTES   = (2 * sizeof(int)) + sizeof(uint64_t);
+        constexpr size_t SAMPLER_BYTES   = (2 * sizeof(uint64_t)) + sizeof(int);
+
+        std::vector<Node>                     nodes(reader.readCount(NODE_BYTES));
+        std::vector<int>                      scene_roots{};
+        std::vector<Skin>                     skins{};
+        std::vector<Mesh>                     meshes{};
+        std::vector<Material>                 materials{};
+        std::vector<std::shared_ptr<Texture>> textures{};
+        std::vector<Animation>                animations{};
+
+        for (Node& node : nodes) {
+            node.camera  = reader.read<int>();
+            node.skin    = reader.read<int>();
+            node.mesh    = reader.read<int>();
+            node.light   = reader.read<int>();
+            node.emitter = reader.read<int>();
+            node.name    = reader.readString();
+            reader.readArray(node.children);
+            node.rotation     = reader.read<glm::quat>();
+            node.scale        = reader.read<glm::vec3>();
+            node.translation  = reader.read<glm::vec3>();
+            node.local_matrix = reader.read<glm::mat4>();
+            reader.readArray(node.weights);
+            reader.readArray(node.lods);
+            reader.readArray(node.screen_coverage);
+        }
+
+        reader.readArray(scene_roots);
+
+        skins.resize(reader.readCount(SKIN_BYTES));
+        for (Skin& skin : skins) {
+            skin.name = reader.readString();
+            reader.readArray(skin.inverse_bind_matrices);
+            skin.skeleton = reader.read<int>();
+            reader.readArray(skin.joints);
+        }
+
+        auto read_indices = [&](Indices& indices) {
+            switch (reader.read<uint32_t>()) {
+                case 0:
+                    reader.readArray(indices.emplace<std::vector<uint8_t>>());
+                    break;
+                case 1:
+                    reader.readArray(indices.emplace<std::vector<uint16_t>>());
+                    break;
+                case 2:
+                    reader.readArray(indices.emplace<std::vector<uint32_t>>());
+                    break;
+                default:
+                    throw std::runtime_error("Invalid index type in model cache");
+            }
+        };
+
+        meshes.resize(reader.readCount(MESH_BYTES));
+        for (Mesh& mesh : meshes) {
+            mesh.name = reader.readString();
+            reader.readArray(mesh.weights);
+            mesh.primitives.resize(reader.readCount(PRIMITIVE_BYTES));
+            for (Primitive& primitive : mesh.primitives) {
+                primitive.material     = reader.read<int>();
+                primitive.mode         = reader.readEnum(RenderMode::TRIANGLE_FAN);
+                primitive.index_type   = reader.readEnum(RenderIndexType::UNSIGNED_INT);
+                primitive.index_count  = reader.read<uint64_t>();
+                primitive.index_offset = reader.read<uint64_t>();
+                reader.readArray(primitive.vertices);
+                reader.readArray(primitive.compact_vertices);
+                primitive.position_offset = reader.read<glm::vec3>();
+                primitive.position_scale  = reader.read<glm::vec3>();
+                primitive.compact         = !primitive.compact_vertices.empty();
+                reader.readArray(primitive.meshlets);
+                reader.readArray(primitive.meshlet_vertices);
+                reader.readArray(primitive.meshlet_triangles);
+
+                read_indices(primitive.indices);
+                primitive.bounds_center = reader.read<glm::vec3>();
+                primitive.bounds_radius = reader.read<float>();
+                primitive.lods.resize(reader.readCount(LOD_BYTES));
+                for (PrimitiveLod& lod : primitive.lods) {
+                    lod.error = reader.read<float>();
+                    read_indices(lod.indices);
+                }
+            }
+        }
+
+        materials.resize(reader.readCount(MATERIAL_BYTES));
+        for (Material& material : materials) {
+            material.name            = reader.readString();
+            material.emissive_factor = reader.read<glm::vec3>();
+            material.alpha_mode      = reader.readEnum(Material::AlphaMode::BLEND);
+            material.alpha_cutoff    = reader.read<double>();
+            material.double_sided    = reader.readBool();
+            reader.readArray(material.lods);
+            material.pbr_metallic_roughness = reader.read<Material::PbrMetallicRoughness>();
+            material.normal_texture         = reader.read<Material::NormalTextureInfo>();
+            material.occlusion_texture      = reader.read<Material::OcclusionTextureInfo>();
+            material.emissive_texture       = reader.read<Material::TextureInfo>();
+        }
+
+        size_t shared_local    = 0;
+        size_t shared_registry = 0;
+        size_t shared_bytes    = 0;
+
+        textures.resize(reader.readCount(TEXTURE_BYTES));
+        for (size_t i = 0; i < textures.size(); i++) {
+            auto first = reader.read<int64_t>();
+            if (first >= 0) {
+                if (static_cast<size_t>(first) >= i) {
+                    throw std::runtime_error("Model cache texture reference is out of bounds");
+                }
+                textures[i] = textures[first];
+                shared_local++;
+                shared_bytes += textures[i]->getByteSize();
+                continue;
+            }
+
+            auto key             = reader.read<uint64_t>();
+            auto width           = reader.read<unsigned int>();
+            auto height          = reader.read<unsigned int>();
+            auto components      = reader.read<unsigned int>();
+            auto internal_format = reader.readEnum(Texture::TextureInternalFormat::BC7_SRGB);
+            auto data_format     = reader.readEnum(Texture::TextureDataFormat::RED);
+            auto min_filter      = reader.readEnum(Texture::TextureMinFilter::LINEAR_MIPMAP_LINEAR);
+            auto mag_filter      = reader.readEnum(Texture::TextureMagFilter::LINEAR);
+            auto wrap_s          = reader.readEnum(Texture::TextureWrap::REPEAT);
+            auto wrap_t          = reader.readEnum(Texture::TextureWrap::REPEAT);
+            auto mip_levels      = reader.read<unsigned int>();
+            auto pixels          = reader.readBytes();
+
+            // the level sizes below come from these, the pixels must hold exactly that chain
+            if (components == 0 || components > 4 || mip_levels == 0 || mip_levels > static_cast<unsigned int>(std::bit_width(std::max({ width, height, 1U })))) {
+                throw std::runtime_error("Invalid texture layout in model cache");
+            }
+
+            bool share = options.share_textures && key != 0;
+            if (share) {
+                if (std::shared_ptr<Texture> shared = TextureRegistry::getGlobal().Find(key)) { // another model loaded it, the pixels are skipped
+                    textures[i] = std::move(shared);
+                    shared_registry++;
+                    shared_bytes += textures[i]->getByteSize();
+                    continue;
+                }
+            }
+
+            auto bytes = Texture::allocateBytes(pixels.size());
+            std::copy(pixels.begin(), pixels.end(), bytes.get());
+
+            auto texture = std::make_shared<Texture>();
+            texture->Create(width, height, components, std::move(bytes), internal_format, data_format, min_filter, mag_filter, wrap_s, wrap_t, mip_levels);
+            if (texture->getByteSize() != pixels.size()) {
+                throw std::runtime_error("Model cache texture size does not match its layout");
+            }
+            textures[i] = share ? TextureRegistry::getGlobal().Publish(key, std::move(texture)) : std::move(texture);
+        }
+
+        animations.resize(reader.readCount(ANIMATION_BYTES));
+        for (Animation& animation : animations) {
+            animation.channels.resize(reader.readCount(CHANNEL_BYTES));
+            for (AnimationChannel& channel : animation.channels) {
+                channel.sampler     = reader.read<int>();
+                channel.target_node = reader.read<int>();
+                channel.target_path = reader.readString();
+            }
+            animation.samplers.resize(reader.readCount(SAMPLER_BYTES));
+            for (AnimationSampler& sampler : animation.samplers) {
+                reader.readArray(sampler.times);
+                reader.readArray(sampler.values);
+                sampler.interpolation = reader.readEnum(AnimationSampler::InterpolationMode::CUBICSPLINE);
+            }
+        }
+
+        validateReferences(nodes, scene_roots, skins, meshes, materials, textures, animations);
+
+        model.m_asset->nodes       = std::move(nodes);
+        model.m_asset->scene_roots = std::move(scene_roots);
+        model.m_asset->skins       = std::move(skins);
+        model.m_asset->meshes      = std::move(meshes);
+        model.m_asset->materials   = std::move(materials);
+        model.m_asset->textures    = std::move(textures);
+        model.m_asset->animations  = std::move(animations);
+
+        model.m_loadStatistics.shared_textures_local    = shared_local;
+        model.m_loadStatistics.shared_textures_registry = shared_registry;
+        model.m_loadStatistics.shared_texture_bytes     = shared_bytes;
+    }
+    catch (const std::exception& e) {
+        std::println("WARNING : Broken model cache, rebuilding : {}", e.what());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "tiny_gltf.h"
+
+class Model;             // forward declaration
+struct ModelLoadOptions; // forward declaration
+
+// Baked binary form of everything Model builds from a glTF
+// One file per source path and set of output-affecting load options. A cache entry is used only if the source file
+// and every file it references ( external .bin, images ) hash to the same content hash and the loader version matches,
+// otherwise it is rebuilt by the next regular load
+//
+// Layout : header, dependency table, payload. Every array in the payload is 16-byte aligned from the file start,
+// so the mapped file can be read with plain memcpy
+class ModelCache {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 8; // bump when the file layout changes
+    static constexpr uint32_t LOADER_VERSION = 2; // bump when Model::Initialize starts producing different data
+
+public:
+    ModelCache() = default;
+    explicit ModelCache(std::filesystem::path directory) : m_directory(std::move(directory)) {}
+    ~ModelCache() = default;
+
+    // false if there is no valid entry for the source. The model is left untouched then
+    bool Load(Model& model, const std::filesystem::path& source, const ModelLoadOptions& options) const;
+    void Save(const Model& model, const std::filesystem::path& source, const ModelLoadOptions& options, const std::vector<std::string>& dependencies) const;
+
+    // relative uris of the external files a glTF depends on
+    // buffer_uris overrides model.buffers ( the mapped loader leaves them empty )
+    static std::vector<std::string> collectDependencies(const tinygltf::Model& model, const std::vector<std::string>* buffer_uris);
+
+    static std::filesystem::path getDefaultDirectory();
+
+    [[nodiscard]] std::filesystem::path getCachePath(const std::filesystem::path& source, const ModelLoadOptions& options) const;
+
+    // hash of the load options that change what Model::Initialize produces ( not memory_map, parallel ... )
+    static uint64_t hashOptions(const ModelLoadOptions& options);
+
+private:
+    static uint64_t hashContent(const std::filesystem::path& source, const std::vector<std::string>& dependencies);
+
+private:
+    std::filesystem::path m_directory{ ModelCache::getDefaultDirectory() };
+};
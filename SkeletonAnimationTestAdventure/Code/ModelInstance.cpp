@@ -0,0 +1,347 @@
+#include "ModelInstance.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "LodSelection.hpp"
+#include "TextureStreamer.hpp"
+
+void ModelInstance::Release() {
+    m_asset.reset();
+    m_translations.clear();
+    m_rotations.clear();
+    m_scales.clear();
+    m_globalMatrices.clear();
+    m_skinMatrices.clear();
+    m_skinOffsets.clear();
+
+    m_animation = -1;
+    m_time      = 0.0F;
+    m_duration  = 0.0F;
+    m_speed     = 1.0F;
+    m_loop      = true;
+}
+
+void ModelInstance::Initialize(std::shared_ptr<const ModelAsset> asset) {
+    this->Release();
+    m_asset = std::move(asset);
+    if (m_asset == nullptr) {
+        return;
+    }
+
+    const std::vector<Node>& nodes = m_asset->nodes;
+    m_translations.resize(nodes.size());
+    m_rotations.resize(nodes.size());
+    m_scales.resize(nodes.size());
+    m_globalMatrices.assign(nodes.size(), glm::mat4(1.0F));
+
+    m_skinOffsets.resize(m_asset->skins.size());
+    size_t joint_count = 0;
+    for (size_t i = 0; i < m_asset->skins.size(); i++) {
+        m_skinOffsets[i] = joint_count;
+        joint_count += m_asset->skins[i].joints.size();
+    }
+    m_skinMatrices.assign(joint_count, glm::mat4(1.0F));
+
+    this->Update(0.0F);
+}
+
+void ModelInstance::playAnimation(int animation, bool loop, float speed) {
+    m_animation = -1;
+    m_time      = 0.0F;
+    m_duration  = 0.0F;
+    m_speed     = speed;
+    m_loop      = loop;
+
+    if (m_asset == nullptr || animation < 0 || static_cast<size_t>(animation) >= m_asset->animations.size()) {
+        return;
+    }
+
+    m_animation = animation;
+    for (const AnimationSampler& sampler : m_asset->animations[animation].samplers) {
+        if (!sampler.times.empty()) {
+            m_duration = std::max(m_duration, sampler.times.back());
+        }
+    }
+}
+
+void ModelInstance::setTime(float time) {
+    if (m_duration <= 0.0F) {
+        m_time = 0.0F;
+    }
+    else if (m_loop) {
+        m_time = std::fmod(time, m_duration);
+        m_time = m_time < 0.0F ? m_time + m_duration : m_time;
+    }
+    else {
+        m_time = std::clamp(time, 0.0F, m_duration);
+    }
+}
+
+void ModelInstance::Update(float delta_time) {
+    if (m_asset == nullptr) {
+        return;
+    }
+
+    // rest pose first, the animation overrides the nodes it targets
+    const std::vector<Node>& nodes = m_asset->nodes;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        m_translations[i] = nodes[i].translation;
+        m_rotations[i]    = nodes[i].rotation;
+        m_scales[i]       = nodes[i].scale;
+    }
+
+    if (m_animation >= 0) {
+        this->setTime(m_time + (delta_time * m_speed));
+        this->sampleAnimation();
+    }
+
+    this->updateGlobalMatrices();
+    this->updateSkinMatrices();
+}
+
+void ModelInstance::Draw(const Shader& shader, const LodView* lod_view) const {
+    if (m_asset == nullptr) {
+        return;
+    }
+
+    shader.Bind();
+    for (int root : m_asset->scene_roots) {
+        this->drawNode(root, glm::mat4(1.0F), shader, lod_view);
+    }
+}
+
+void ModelInstance::requestTextures(TextureStreamer& streamer, const LodView& lod_view) const {
+    if (m_asset == nullptr) {
+        return;
+    }
+
+    for (int root : m_asset->scene_roots) {
+        this->requestNodeTextures(root, glm::mat4(1.0F), streamer, lod_view);
+    }
+}
+
+std::span<const glm::mat4> ModelInstance::getSkinMatrices(int skin) const {
+    if (m_asset == nullptr || skin < 0 || static_cast<size_t>(skin) >= m_skinOffsets.size()) {
+        return {};
+    }
+    return std::span<const glm::mat4>(m_skinMatrices).subspan(m_skinOffsets[skin], m_asset->skins[skin].joints.size());
+}
+
+void ModelInstance::sampleAnimation() {
+    const Animation& animation = m_asset->animations[m_animation];
+
+    for (const AnimationChannel& channel : animation.channels) {
+        const AnimationSampler& sampler = animation.samplers[channel.sampler];
+
+        if (sampler.times.size() < 2 || sampler.values.size() < 2) {
+            continue;
+        }
+
+        size_t k1 = 0;
+        while (k1 < sampler.times.size() - 1 && m_time > sampler.times[k1 + 1]) {
+            k1++;
+        }
+
+        size_t k2 = std::min(k1 + 1, sampler.times.size() - 1);
+
+        glm::vec4 v1 = sampler.values[k1];
+        glm::vec4 v2 = sampler.values[k2];
+
+        float t = (m_time - sampler.times[k1]) / (sampler.times[k2] - sampler.times[k1]);
+        t       = glm::clamp(t, 0.0F, 1.0F);
+
+        auto node = static_cast<size_t>(channel.target_node);
+
+        if (channel.target_path == "rotation") {
+            glm::quat q1(v1.w, v1.x, v1.y, v1.z);
+            glm::quat q2(v2.w, v2.x, v2.y, v2.z);
+            m_rotations[node] = glm::normalize(glm::slerp(q1, q2, t));
+        }
+        else if (channel.target_path == "translation") {
+            m_translations[node] = glm::mix(glm::vec3(v1), glm::vec3(v2), t);
+        }
+        else if (channel.target_path == "scale") {
+            m_scales[node] = glm::mix(glm::vec3(v1), glm::vec3(v2), t);
+        }
+    }
+}
+
+void ModelInstance::updateGlobalMatrices() {
+    for (int root : m_asset->scene_roots) {
+        this->updateGlobalRecursive(root, glm::mat4(1.0F));
+    }
+}
+
+void ModelInstance::updateGlobalRecursive(int index, const glm::mat4& parent) {
+    m_globalMatrices[index] = parent * this->getLocalMatrix(index);
+
+    for (int child : m_asset->nodes[index].children) {
+        this->updateGlobalRecursive(child, m_globalMatrices[index]);
+    }
+}
+
+void ModelInstance::updateSkinMatrices() {
+    for (size_t i = 0; i < m_asset->skins.size(); i++) {
+        const Skin& skin    = m_asset->skins[i];
+        glm::mat4*  palette = m_skinMatrices.data() + m_skinOffsets[i];
+
+        for (size_t j = 0; j < skin.joints.size(); j++) {
+            palette[j] = m_globalMatrices[skin.joints[j]] * skin.inverse_bind_matrices[j];
+        }
+    }
+}
+
+glm::mat4 ModelInstance::getLocalMatrix(int index) const {
+    return glm::translate(glm::mat4(1.0F), m_translations[index]) *
+           glm::mat4_cast(m_rotations[index]) *
+           glm::scale(glm::mat4(1.0F), m_scales[index]);
+}
+
+void ModelInstance::drawNode(int index, const glm::mat4& parent, const Shader& shader, const LodView* lod_view) const {
+    const Node& node       = m_asset->nodes[index];
+    int         drawn_node = index;
+    glm::mat4   matrix     = m_globalMatrices[index];
+    size_t      node_lod   = 0;
+
+    if (lod_view != nullptr && !node.lods.empty() && node.mesh >= 0) {
+        node_lod = LodSelection::selectNodeLod(node, LodSelection::getScreenCoverage(m_asset->meshes[node.mesh], matrix, *lod_view));
+        if (node_lod > 0) {
+            // MSFT_lod nodes are outside the scene tree, they take this node's place under its parent
+            drawn_node = node.lods[node_lod - 1];
+            matrix     = parent * this->getLocalMatrix(drawn_node);
+        }
+    }
+
+    if (m_asset->nodes[drawn_node].mesh >= 0) {
+        this->drawMesh(m_asset->meshes[m_asset->nodes[drawn_node].mesh], m_asset->nodes[drawn_node].skin, shader, matrix, lod_view, node_lod);
+    }
+
+    for (int child : node.children) {
+        this->drawNode(child, m_globalMatrices[index], shader, lod_view);
+    }
+}
+
+void ModelInstance::drawMesh(const Mesh& mesh, int skin_index, const Shader& shader, const glm::mat4& matrix, const LodView* lod_view, size_t node_lod) const {
+    std::span<const glm::mat4> palette = this->getSkinMatrices(skin_index);
+    if (!palette.empty()) {
+        shader.setUniformMat4Array("u_bones", palette.data(), static_cast<unsigned int>(std::min(palette.size(), JOINTS_COUNT)));
+        shader.setUniformInt("u_isAnimated", 1);
+    }
+    else {
+        shader.setUniformInt("u_isAnimated", 0);
+    }
+
+    shader.setUniformMat4("u_model", matrix);
+
+    for (const Primitive& primitive : mesh.primitives) {
+        size_t lod = lod_view != nullptr ? LodSelection::selectPrimitiveLod(primitive, matrix, *lod_view) : 0;
+        this->drawPrimitive(primitive, shader, lod, this->getLodMaterial(primitive.material, std::max(node_lod, lod)));
+    }
+}
+
+void ModelInstance::drawPrimitive(const Primitive& primitive, const Shader& shader, size_t lod, int material_index) const {
+    // per primitive, a mesh may mix CompactVertex and Vertex primitives ( decoded by default.vert )
+    shader.setUniformInt("u_compactVertices", primitive.compact ? 1 : 0);
+    if (primitive.compact) {
+        shader.setUniformVec3("u_positionOffset", primitive.position_offset);
+        shader.setUniformVec3("u_positionScale", primitive.position_scale);
+    }
+
+    /*const Material& material = m_asset->materials[material_index];
+
+    this->bindMaterial(material, shader);
+
+    primitive.vao.Bind();
+
+    if (lod > 0) { // LOD indices follow the full ones in the same element buffer ( OpenGLPrimitiveLod )
+        glDrawElements(GL_TRIANGLES, primitive.lods[lod - 1].index_count, primitive.index_type, (void*) primitive.lods[lod - 1].index_offset);
+    }
+    else if (primitive.index_count > 0) {
+        glDrawElements(GL_TRIANGLES, primitive.index_count, primitive.index_type, (void*) primitive.index_offset);
+    }
+    else {
+        glDrawArrays(GL_TRIANGLES, 0, primitive.vertices.size());
+    }*/
+}
+
+void ModelInstance::requestNodeTextures(int index, const glm::mat4& parent, TextureStreamer& streamer, const LodView& lod_view) const {
+    const Node& node       = m_asset->nodes[index];
+    int         drawn_node = index;
+    glm::mat4   matrix     = m_globalMatrices[index];
+    size_t      node_lod   = 0;
+
+    // the same levels drawNode() picks
+    if (!node.lods.empty() && node.mesh >= 0) {
+        node_lod = LodSelection::selectNodeLod(node, LodSelection::getScreenCoverage(m_asset->meshes[node.mesh], matrix, lod_view));
+        if (node_lod > 0) {
+            drawn_node = node.lods[node_lod - 1];
+            matrix     = parent * this->getLocalMatrix(drawn_node);
+        }
+    }
+
+    if (m_asset->nodes[drawn_node].mesh >= 0) {
+        for (const Primitive& primitive : m_asset->meshes[m_asset->nodes[drawn_node].mesh].primitives) {
+            size_t lod      = LodSelection::selectPrimitiveLod(primitive, matrix, lod_view);
+            int    material = this->getLodMaterial(primitive.material, std::max(node_lod, lod));
+            if (material < 0) {
+                continue;
+            }
+
+            // the texture spans the primitive, one texel per pixel of its projected bounding sphere is enough
+            float           screen_size   = LodSelection::getScreenCoverage(primitive.bounds_center, primitive.bounds_radius, matrix, lod_view) * lod_view.viewport_height;
+            const Material& this_material = m_asset->materials[material];
+            for (int texture : { this_material.pbr_metallic_roughness.base_color_texture.index,
+                                 this_material.pbr_metallic_roughness.metallic_roughness_texture.index,
+                                 this_material.normal_texture.index,
+                                 this_material.occlusion_texture.index,
+                                 this_material.emissive_texture.index }) {
+                if (texture >= 0 && static_cast<size_t>(texture) < m_asset->textures.size() && m_asset->textures[texture] != nullptr) {
+                    streamer.requestTexture(*m_asset->textures[texture], screen_size);
+                }
+            }
+        }
+    }
+
+    for (int child : node.children) {
+        this->requestNodeTextures(child, m_globalMatrices[index], streamer, lod_view);
+    }
+}
+
+int ModelInstance::getLodMaterial(int material_index, size_t lod) const {
+    if (material_index < 0 || lod == 0) {
+        return material_index;
+    }
+
+    // MSFT_lod on a material : lods[i] is used for level i + 1, the last one for every level past it
+    const std::vector<int>& lods = m_asset->materials[material_index].lods;
+    if (lods.empty()) {
+        return material_index;
+    }
+    return lods[std::min(lod, lods.size()) - 1];
+}
+
+void ModelInstance::bindMaterial(const Material& material, const Shader& shader) const {
+    shader.setUniformVec4("u_baseColorFactor", material.pbr_metallic_roughness.base_color_factor);
+    shader.setUniformFloat("u_metallicFactor", material.pbr_metallic_roughness.metallic_factor);
+    shader.setUniformFloat("u_roughnessFactor", material.pbr_metallic_roughness.roughness_factor);
+
+    int slot = 0;
+
+    bindTexture(shader, "u_baseColorTex", material.pbr_metallic_roughness.base_color_texture.index, slot++);                 // 0
+    bindTexture(shader, "u_metallicRoughnessTex", material.pbr_metallic_roughness.metallic_roughness_texture.index, slot++); // 1
+    bindTexture(shader, "u_normalTex", material.normal_texture.index, slot++);                                               // 2
+    bindTexture(shader, "u_occlusionTex", material.occlusion_texture.index, slot++);                                         // 3
+    bindTexture(shader, "u_emissiveTex", material.emissive_texture.index, slot++);                                           // 4
+}
+
+void ModelInstance::bindTexture(const Shader& shader, const std::string& uniform, int texture_index, int slot) const {
+    /*shader.setUniformInt(uniform.c_str(), slot);
+
+    if (texture_index < 0) {
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + slot);
+    m_textures[texture_index].Bind();*/
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Model.hpp"
+
+struct LodView;         // forward declaration
+class TextureStreamer; // forward declaration
+
+// one drawn copy of a ModelAsset : the local pose, the global matrices, the skin palettes and the animation playback
+// The asset is shared and never written, an instance pays only for its pose buffers ( 104 bytes per node, 64 per joint )
+//
+//  instance.Initialize(model.getAsset());
+//  instance.playAnimation(0);
+//  every frame : instance.Update(delta_time); instance.Draw(shader, &lod_view);
+//  with texture streaming : instance.requestTextures(streamer, lod_view); streamer.Update();
+class ModelInstance {
+public:
+    ModelInstance() = default;
+    explicit ModelInstance(std::shared_ptr<const ModelAsset> asset) { this->Initialize(std::move(asset)); }
+    ~ModelInstance() { this->Release(); }
+
+    void Release();
+    void Initialize(std::shared_ptr<const ModelAsset> asset); // rest pose, no animation playing
+
+    // animation - index into ModelAsset::animations, -1 stops the playback and goes back to the rest pose
+    void playAnimation(int animation, bool loop = true, float speed = 1.0F);
+    // playback position in seconds, wrapped into the animation when looping, clamped otherwise. Applied by the next Update()
+    void setTime(float time);
+    // advances the playback and recomputes the pose, once per frame before Draw()
+    void Update(float delta_time);
+
+    // lod_view - camera for the LOD selection, nullptr draws the full detail levels
+    void Draw(const Shader& shader, const LodView* lod_view = nullptr) const;
+    // the screen size of every texture the visible levels draw with, before TextureStreamer::Update()
+    void requestTextures(TextureStreamer& streamer, const LodView& lod_view) const;
+
+    inline const std::shared_ptr<const ModelAsset>& getAsset() const noexcept { return m_asset; }
+    inline std::span<const glm::mat4>               getGlobalMatrices() const noexcept { return m_globalMatrices; }
+    std::span<const glm::mat4>                      getSkinMatrices(int skin) const; // joint matrices of the skin, in Skin::joints order
+
+    inline int   getAnimation() const noexcept { return m_animation; }
+    inline float getTime() const noexcept { return m_time; }
+    inline float getDuration() const noexcept { return m_duration; }
+
+private:
+    void      sampleAnimation();
+    void      updateGlobalMatrices();
+    void      updateGlobalRecursive(int index, const glm::mat4& parent);
+    void      updateSkinMatrices();
+    glm::mat4 getLocalMatrix(int index) const;
+
+private:
+    void drawNode(int index, const glm::mat4& parent, const Shader& shader, const LodView* lod_view) const;
+    void requestNodeTextures(int index, const glm::mat4& parent, TextureStreamer& streamer, const LodView& lod_view) const;
+    void drawMesh(const Mesh& mesh, int skin_index, const Shader& shader, const glm::mat4& matrix, const LodView* lod_view, size_t node_lod) const;
+    void drawPrimitive(const Primitive& primitive, const Shader& shader, size_t lod, int material_index) const;
+    int  getLodMaterial(int material_index, size_t lod) const;
+    void bindMaterial(const Material& material, const Shader& shader) const;
+    void bindTexture(const Shader& shader, const std::string& uniform, int texture_index, int slot) const;
+
+private:
+    std::shared_ptr<const ModelAsset> m_asset;
+
+    // local pose, one entry per node
+    std::vector<glm::vec3> m_translations;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::vec3> m_scales;
+
+    std::vector<glm::mat4> m_globalMatrices; // one per node, identity for nodes outside the scene
+    std::vector<glm::mat4> m_skinMatrices;   // every skin's joints back to back
+    std::vector<size_t>    m_skinOffsets;    // first m_skinMatrices entry of every skin
+
+    int   m_animation{ -1 };
+    float m_time{ 0.0F };     // seconds into the animation
+    float m_duration{ 0.0F }; // last key time of the animation
+    float m_speed{ 1.0F };
+    bool  m_loop{ true };
+};
@@ -0,0 +1,202 @@
+#include "ModelStream.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include "ThreadPool.hpp"
+
+void ModelStream::Release() {
+    m_cancelled = true;
+    if (m_done.valid()) {
+        m_done.wait();
+    }
+    m_done = {};
+    m_staging.reset();
+
+    std::lock_guard lock(m_mutex);
+    m_hierarchy.reset();
+    m_geometry.clear();
+    m_reducedTextures.clear();
+    m_fullTextures.clear();
+    m_statistics      = {};
+    m_hasGeometry     = false;
+    m_hasFullTextures = false;
+    m_nextFullTexture = 0;
+    m_error.clear();
+
+    m_stage     = ModelLoadStage::NONE;
+    m_cancelled = false;
+    m_failed    = false;
+}
+
+void ModelStream::Initialize(const std::filesystem::path& path, const ModelLoadOptions& options) {
+    this->Release();
+
+    m_path    = path;
+    m_options = options;
+    m_staging = std::make_unique<Model>();
+
+    m_callbacks.on_stage           = [this](ModelLoadStage stage) { this->publishStage(stage); };
+    m_callbacks.on_reduced_texture = [this](size_t texture, Texture&& reduced) { this->publishReducedTexture(texture, std::move(reduced)); };
+    m_callbacks.is_cancelled       = [this]() { return m_cancelled.load(); };
+
+    // the stream outlives the task, Release() waits for it
+    auto promise = std::make_shared<std::promise<void>>();
+    m_done       = promise->get_future();
+    ThreadPool::getGlobal().Submit([this, promise]() {
+        this->load();
+        promise->set_value();
+    });
+}
+
+ModelStreamUpdate ModelStream::Update(Model& model, size_t max_full_textures) {
+    ModelStreamUpdate update{};
+    std::lock_guard   lock(m_mutex);
+
+    if (m_hierarchy != nullptr) {
+        model.m_asset = std::move(m_hierarchy->m_asset); // the later parts are written into this one, no other model has it yet
+        m_hierarchy.reset();
+        model.m_name           = m_path.filename().string();
+        model.m_releaseCpuData = m_options.release_cpu_data;
+        model.m_reportMemory   = m_options.report_memory;
+        update.hierarchy       = true;
+    }
+
+    if (m_hasGeometry) {
+        model.m_asset->meshes = std::move(m_geometry);
+        m_geometry.clear();
+        m_hasGeometry   = false;
+        update.geometry = true;
+    }
+
+    for (auto& [texture, reduced] : m_reducedTextures) {
+        if (texture < model.m_asset->textures.size()) {
+            model.m_asset->textures[texture] = std::make_shared<Texture>(std::move(reduced));
+            update.textures.push_back(texture);
+        }
+    }
+    m_reducedTextures.clear();
+
+    if (m_hasFullTextures) {
+        size_t count = max_full_textures == 0 ? m_fullTextures.size() : std::min(m_fullTextures.size(), m_nextFullTexture + max_full_textures);
+
+        model.m_asset->textures.resize(std::max(model.m_asset->textures.size(), m_fullTextures.size()));
+        for (; m_nextFullTexture < count; m_nextFullTexture++) {
+            model.m_asset->textures[m_nextFullTexture] = std::move(m_fullTextures[m_nextFullTexture]);
+            update.textures.push_back(m_nextFullTexture);
+        }
+
+        if (m_nextFullTexture == m_fullTextures.size()) {
+            model.m_loadStatistics = m_statistics;
+            m_fullTextures.clear();
+            m_hasFullTextures = false;
+        }
+    }
+
+    return update;
+}
+
+void ModelStream::Wait() const {
+    if (m_done.valid()) {
+        m_done.wait();
+    }
+}
+
+bool ModelStream::isFinished() const {
+    std::lock_guard lock(m_mutex);
+    return m_stage == ModelLoadStage::TEXTURES && m_hierarchy == nullptr && !m_hasGeometry && m_reducedTextures.empty() && !m_hasFullTextures;
+}
+
+std::string ModelStream::getError() const {
+    std::lock_guard lock(m_mutex);
+    return m_error;
+}
+
+void ModelStream::load() {
+    try {
+        m_staging->load(m_path, m_options, &m_callbacks);
+    }
+    catch (const std::exception& exception) {
+        std::println("ERROR : Failed to stream model : {}\n{}", m_path.string(), exception.what());
+
+        std::lock_guard lock(m_mutex);
+        m_error  = exception.what();
+        m_failed = true;
+    }
+    catch (...) { // runs on a ThreadPool worker, nothing may escape
+        std::println("ERROR : Failed to stream model : {}\nunknown exception", m_path.string());
+
+        std::lock_guard lock(m_mutex);
+        m_error  = "unknown exception";
+        m_failed = true;
+    }
+    m_staging.reset(); // everything worth keeping was published
+}
+
+void ModelStream::publishStage(ModelLoadStage stage) {
+    Model& staging = *m_staging;
+
+    // copies and moves happen outside the lock, Update() on the main thread never waits for them
+    switch (stage) {
+        case ModelLoadStage::HIERARCHY: {
+            auto hierarchy          = std::make_unique<Model>();
+            ModelAsset& asset = *hierarchy->m_asset;
+            asset.nodes       = staging.m_asset->nodes;
+            asset.scene_roots = staging.m_asset->scene_roots;
+            asset.skins       = staging.m_asset->skins;
+            asset.meshes      = ModelStream::copyMeshBounds(staging.m_asset->meshes);
+            asset.materials   = staging.m_asset->materials;
+            asset.animations  = staging.m_asset->animations;
+            asset.textures.resize(staging.m_asset->textures.size()); // nullptr until a reduced or the full one arrives
+
+            std::lock_guard lock(m_mutex);
+            m_hierarchy = std::move(hierarchy);
+            break;
+        }
+        case ModelLoadStage::GEOMETRY: {
+            // ModelCache::Save() still needs the staging meshes
+            std::vector<Mesh> geometry = m_options.use_cache ? staging.m_asset->meshes : std::move(staging.m_asset->meshes);
+
+            std::lock_guard lock(m_mutex);
+            m_geometry    = std::move(geometry);
+            m_hasGeometry = true;
+            break;
+        }
+        case ModelLoadStage::TEXTURES: { // published after the cache save, nothing reads the staging model anymore
+            std::lock_guard lock(m_mutex);
+            m_fullTextures    = std::move(staging.m_asset->textures);
+            m_statistics      = staging.m_loadStatistics;
+            m_hasFullTextures = true;
+            m_nextFullTexture = 0;
+            break;
+        }
+        default: // LOW_RES_TEXTURES arrive one by one, publishReducedTexture()
+            break;
+    }
+
+    m_stage = stage;
+}
+
+void ModelStream::publishReducedTexture(size_t texture, Texture&& reduced) {
+    std::lock_guard lock(m_mutex);
+    m_reducedTextures.emplace_back(texture, std::move(reduced));
+}
+
+std::vector<Mesh> ModelStream::copyMeshBounds(const std::vector<Mesh>& meshes) {
+    std::vector<Mesh> result(meshes.size());
+    for (size_t i = 0; i < meshes.size(); i++) {
+        result[i].name    = meshes[i].name;
+        result[i].weights = meshes[i].weights;
+        result[i].primitives.resize(meshes[i].primitives.size());
+        for (size_t j = 0; j < meshes[i].primitives.size(); j++) {
+            const Primitive& primitive = meshes[i].primitives[j];
+            Primitive&       bounds    = result[i].primitives[j];
+
+            bounds.bounds_center = primitive.bounds_center;
+            bounds.bounds_radius = primitive.bounds_radius;
+            bounds.material      = primitive.material;
+            bounds.mode          = primitive.mode;
+        }
+    }
+    return result;
+}
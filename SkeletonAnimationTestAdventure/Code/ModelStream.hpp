@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Model.hpp"
+
+// what one ModelStream::Update changed in the model
+struct ModelStreamUpdate {
+    bool                hierarchy{ false }; // everything but the geometry and the texels is new, meshes are placeholders with bounds only
+    bool                geometry{ false };  // every mesh was replaced by the loaded one
+    std::vector<size_t> textures;           // texture indices replaced, by a low resolution or the full resolution one
+
+    [[nodiscard]] bool empty() const noexcept { return !hierarchy && !geometry && textures.empty(); }
+
+    ModelStreamUpdate()  = default;
+    ~ModelStreamUpdate() = default;
+};
+
+// Model::Initialize on ThreadPool::getGlobal(), handed over in ModelLoadStage order
+// The loading thread only ever touches its own staging model, the parts move into the drawn model in Update()
+//
+//  stream.Initialize(path, options);
+//  every frame : renderer->updateModel(model, stream.Update(model));
+class ModelStream {
+public:
+    ModelStream() = default;
+    ~ModelStream() { this->Release(); }
+
+    void Release(); // cancels a running load and waits for it
+    void Initialize(const std::filesystem::path& path, const ModelLoadOptions& options = {});
+
+    // main thread : moves what the load published since the last call into model
+    // max_full_textures - full resolution textures handed over per call, spreads their uploads over several frames. 0 - all of them
+    ModelStreamUpdate Update(Model& model, size_t max_full_textures = 1);
+
+    void Wait() const; // until the loading thread is done, Update() may still have parts to hand over
+
+    [[nodiscard]] bool        isFinished() const; // loaded and everything handed over
+    [[nodiscard]] bool        hasFailed() const noexcept { return m_failed; }
+    [[nodiscard]] std::string getError() const;
+
+    // last stage the loading thread published
+    [[nodiscard]] ModelLoadStage getStage() const noexcept { return m_stage; }
+
+    ModelStream(const ModelStream&)            = delete;
+    ModelStream& operator=(const ModelStream&) = delete;
+
+private:
+    void load();
+    void publishStage(ModelLoadStage stage);
+    void publishReducedTexture(size_t texture, Texture&& reduced);
+
+    static std::vector<Mesh> copyMeshBounds(const std::vector<Mesh>& meshes);
+
+private:
+    std::filesystem::path  m_path;
+    ModelLoadOptions       m_options;
+    ModelLoadCallbacks     m_callbacks;
+    std::unique_ptr<Model> m_staging; // written by the loading thread only
+    std::future<void>      m_done;
+
+    std::atomic<ModelLoadStage> m_stage{ ModelLoadStage::NONE };
+    std::atomic<bool>           m_cancelled{ false };
+    std::atomic<bool>           m_failed{ false };
+
+    // published by the loading thread, not handed over yet
+    mutable std::mutex                      m_mutex;
+    std::unique_ptr<Model>                  m_hierarchy;       // HIERARCHY, in Model form
+    std::vector<Mesh>                       m_geometry;        // GEOMETRY
+    std::vector<std::pair<size_t, Texture>> m_reducedTextures; // LOW_RES_TEXTURES, as they get decoded
+    std::vector<std::shared_ptr<Texture>>   m_fullTextures;    // TEXTURES
+    ModelLoadStatistics                     m_statistics;      // TEXTURES
+    bool                                    m_hasGeometry{ false };
+    bool                                    m_hasFullTextures{ false };
+    size_t                                  m_nextFullTexture{ 0 }; // m_fullTextures below it are handed over
+    std::string                             m_error;
+};
@@ -10,7 +10,11 @@ public:
     void Release() override;
     void Initialize(GLFWwindow* p_window) override;
 
-    inline void loadModel(const Model& model) override { this->m_resourceManager.loadModel(model); }
+    inline void loadModel(Model& model) override { this->m_resourceManager.loadModel(model); }
+    inline void updateModel(Model& model, const ModelStreamUpdate& update) override { this->m_resourceManager.updateModel(model, update); }
+    inline void unloadModel(const Model& model) override { this->m_resourceManager.unloadModel(model); }
+
+    inline TextureStreamer* enableTextureStreaming(const TextureStreamingOptions& options) override { return this->m_resourceManager.enableTextureStreaming(options); }
 
     void onResize(uint32_t width, uint32_t height) override;
 
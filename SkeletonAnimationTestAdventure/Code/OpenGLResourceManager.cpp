@@ -1,22 +1,247 @@
 #include "OpenGLResourceManager.hpp"
 
-void OpenGLResourceManager::loadModel(const Model& model) {
-    const auto& meshes = model.getMeshes();
-    for (const auto& mesh : meshes) {
+#include <algorithm>
+
+// first fit in the free runs, appended to the deque when none is large enough. The slots are default constructed
+template <typename T>
+static size_t allocateSlots(std::deque<T>& slots, std::vector<OpenGLFreeSlots>& free_slots, size_t count) {
+    auto it = std::ranges::find_if(free_slots, [&](const OpenGLFreeSlots& run) { return run.count >= count; });
+    if (count > 0 && it != free_slots.end()) {
+        size_t first = it->first;
+        it->first += count;
+        it->count -= count;
+        if (it->count == 0) {
+            free_slots.erase(it);
+        }
+        return first;
+    }
+
+    size_t first = slots.size();
+    for (size_t i = 0; i < count; i++) {
+        slots.emplace_back(); // a deque never moves its elements, the GL objects stay where they are
+    }
+    return first;
+}
+
+// the slots must be reset already. A run reaching the end of the deque shrinks it instead
+template <typename T>
+static void freeSlots(std::deque<T>& slots, std::vector<OpenGLFreeSlots>& free_slots, size_t first, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    auto it   = free_slots.insert(std::ranges::upper_bound(free_slots, first, {}, &OpenGLFreeSlots::first), OpenGLFreeSlots{});
+    it->first = first;
+    it->count = count;
+
+    auto next = it + 1;
+    if (next != free_slots.end() && it->first + it->count == next->first) {
+        it->count += next->count;
+        free_slots.erase(next);
+    }
+    if (it != free_slots.begin()) {
+        auto previous = it - 1;
+        if (previous->first + previous->count == it->first) {
+            previous->count += it->count;
+            it = free_slots.erase(it) - 1;
+        }
+    }
+
+    if (it + 1 == free_slots.end() && it->first + it->count == slots.size()) {
+        while (slots.size() > it->first) {
+            slots.pop_back();
+        }
+        free_slots.pop_back();
+    }
+}
+
+void OpenGLResourceManager::loadModel(Model& model) {
+    if (OpenGLModelRange* range = this->findRange(model)) { // same file loaded through AssetCache, or the same model again
+        this->addResident(model, *range);
+        return;
+    }
+
+    OpenGLModelRange& range = this->createSlots(model);
+
+    size_t slot = range.first_primitive;
+    for (const auto& mesh : model.getMeshes()) {
         for (const auto& primitive : mesh.primitives) {
-            this->createPrimitive(primitive);
+            this->createPrimitive(m_primitives[slot++], primitive);
+        }
+    }
+
+    const auto&         textures = model.getTextures();
+    std::vector<size_t> uploaded(textures.size());
+    for (size_t i = 0; i < textures.size(); i++) {
+        this->setTexture(range.first_texture + i, textures[i]);
+        uploaded[i] = i;
+    }
+
+    // streamed textures are uploaded again from their CPU levels after an eviction
+    model.releaseUploadedData(true, m_streamer == nullptr ? std::span<const size_t>(uploaded) : std::span<const size_t>{});
+}
+
+void OpenGLResourceManager::updateModel(Model& model, const ModelStreamUpdate& update) {
+    if (update.hierarchy) { // new slots, drawn as placeholders until the geometry and the textures arrive
+        this->createSlots(model);
+    }
+
+    const OpenGLModelRange* range = this->findRange(model);
+    if (range == nullptr) {
+        return; // nothing to fill before the hierarchy
+    }
+
+    if (update.geometry) {
+        size_t slot = range->first_primitive;
+        for (const auto& mesh : model.getMeshes()) {
+            for (const auto& primitive : mesh.primitives) {
+                if (slot < range->first_primitive + range->primitive_count && !m_primitives[slot].resident) {
+                    this->createPrimitive(m_primitives[slot], primitive);
+                }
+                slot++;
+            }
         }
     }
 
     const auto& textures = model.getTextures();
-    for (const auto& texture : textures) {
-        this->createTexture(texture);
+    for (size_t texture : update.textures) {
+        if (texture < range->texture_count && texture < textures.size()) {
+            this->setTexture(range->first_texture + texture, textures[texture]);
+        }
+    }
+
+    model.releaseUploadedData(update.geometry, m_streamer == nullptr ? std::span<const size_t>(update.textures) : std::span<const size_t>{});
+}
+
+void OpenGLResourceManager::unloadModel(const Model& model) {
+    auto it = m_residency.find(&model);
+    if (it == m_residency.end()) {
+        return;
+    }
+
+    auto range = m_ranges.find(it->second);
+    m_residency.erase(it);
+    if (range != m_ranges.end() && --range->second.models == 0) {
+        this->releaseSlots(range->second);
+        m_ranges.erase(range);
+    }
+}
+
+GLuint OpenGLResourceManager::getTexture(const Model& model, int texture_index) const {
+    auto it = m_ranges.find(model.getAsset().get());
+    if (it != m_ranges.end() && !it->second.asset.expired() && texture_index >= 0 && static_cast<size_t>(texture_index) < it->second.texture_count) {
+        const auto& texture = m_textures[it->second.first_texture + texture_index];
+        if (texture != nullptr && texture->index != 0) {
+            return texture->index;
+        }
+    }
+    return m_placeholderTexture.index;
+}
+
+TextureStreamer* OpenGLResourceManager::enableTextureStreaming(const TextureStreamingOptions& options) {
+    if (m_streamer == nullptr) {
+        m_streamer = std::make_unique<TextureStreamer>(*this, options);
+    }
+    else {
+        m_streamer->setOptions(options);
+    }
+    return m_streamer.get();
+}
+
+void OpenGLResourceManager::setResidentLevels(const Texture& texture, unsigned int first_level, unsigned int previous_first_level) {
+    auto it = m_sharedTextures.find(&texture);
+    if (it == m_sharedTextures.end()) {
+        return;
+    }
+    std::shared_ptr<OpenGLTexture> gpu = it->second.gpu.lock();
+    if (gpu == nullptr) {
+        return;
+    }
+
+    // immutable storage cannot grow or shrink : a new texture with the new levels, the slots keep their OpenGLTexture
+    OpenGLTexture resident{};
+    this->createTexture(resident, texture, first_level, gpu->index, previous_first_level);
+    std::swap(resident.index, gpu->index); // the old one is deleted by resident
+}
+
+void OpenGLResourceManager::releaseTexture(const Texture& /*texture*/) {
+    // the slots own the GPU copy, it is already gone or goes with the last of them
+}
+
+OpenGLModelRange* OpenGLResourceManager::findRange(const Model& model) {
+    auto it = m_ranges.find(model.getAsset().get());
+    if (it == m_ranges.end()) {
+        return nullptr;
+    }
+
+    if (it->second.asset.expired()) { // new asset at the address of a released one, its models were never unloaded
+        std::erase_if(m_residency, [&](const auto& residency) { return residency.second == it->first; });
+        this->releaseSlots(it->second);
+        m_ranges.erase(it);
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void OpenGLResourceManager::addResident(const Model& model, OpenGLModelRange& range) {
+    const ModelAsset* asset = model.getAsset().get();
+
+    auto it = m_residency.find(&model);
+    if (it != m_residency.end() && it->second == asset) {
+        return;
+    }
+
+    this->unloadModel(model); // a model loaded again with other data leaves its old range
+    m_residency[&model] = asset;
+    range.models++;
+}
+
+OpenGLModelRange& OpenGLResourceManager::createSlots(const Model& model) {
+    if (m_placeholderTexture.index == 0) {
+        this->createPlaceholderTexture();
+    }
+    this->unloadModel(model); // a model streamed again leaves its old range
+
+    OpenGLModelRange& range = m_ranges[model.getAsset().get()];
+    range                   = OpenGLModelRange{};
+    range.asset             = model.getAsset();
+    for (const auto& mesh : model.getMeshes()) {
+        range.primitive_count += mesh.primitives.size();
+    }
+    range.texture_count = model.getTextures().size();
+
+    // slots released by unloaded models are reused, the deques only grow by what is resident at once
+    range.first_primitive = allocateSlots(m_primitives, m_freePrimitives, range.primitive_count);
+    range.first_texture   = allocateSlots(m_textures, m_freeTextures, range.texture_count);
+
+    size_t slot = range.first_primitive;
+    for (const auto& mesh : model.getMeshes()) {
+        for (const auto& primitive : mesh.primitives) {
+            this->createPlaceholder(m_primitives[slot++], primitive);
+        }
     }
+
+    this->addResident(model, range);
+    return range;
 }
 
-void OpenGLResourceManager::createPrimitive(const Primitive& primitive) {
-    auto& new_primitive = m_primitives.emplace_back();
+void OpenGLResourceManager::releaseSlots(const OpenGLModelRange& range) {
+    // the other ranges keep their indices, the emptied slots go to the free lists for the next createSlots()
+    for (size_t i = 0; i < range.primitive_count; i++) {
+        OpenGLPrimitive& primitive = m_primitives[range.first_primitive + i];
+        std::destroy_at(&primitive);
+        std::construct_at(&primitive);
+    }
 
+    for (size_t i = 0; i < range.texture_count; i++) {
+        m_textures[range.first_texture + i].reset(); // deleted with the last range using it
+    }
+    freeSlots(m_primitives, m_freePrimitives, range.first_primitive, range.primitive_count);
+    freeSlots(m_textures, m_freeTextures, range.first_texture, range.texture_count);
+    this->pruneSharedTextures();
+}
+
+void OpenGLResourceManager::createPlaceholder(OpenGLPrimitive& new_primitive, const Primitive& primitive) {
     new_primitive.material = primitive.material;
 
     new_primitive.enum_mode = primitive.mode;
@@ -47,6 +272,12 @@ void OpenGLResourceManager::createPrimitive(const Primitive& primitive) {
             break;
     }
 
+    new_primitive.bounds_center = primitive.bounds_center;
+    new_primitive.bounds_radius = primitive.bounds_radius;
+}
+
+void OpenGLResourceManager::createPrimitive(OpenGLPrimitive& new_primitive, const Primitive& primitive) {
+    this->createPlaceholder(new_primitive, primitive);
     this->createBuffers(new_primitive, primitive);
 
     new_primitive.enum_index_type = primitive.index_type;
@@ -67,38 +298,197 @@ void OpenGLResourceManager::createPrimitive(const Primitive& primitive) {
 
     new_primitive.index_count  = primitive.index_count;
     new_primitive.index_offset = primitive.index_offset;
+    new_primitive.resident     = true;
 }
 
 void OpenGLResourceManager::createBuffers(OpenGLPrimitive& new_primitive, const Primitive& primitive) {
-    new_primitive.vao.Create();
-    new_primitive.vao.Bind();
+    new_primitive.compact = primitive.compact;
+
+    // one buffer per VertexStream, so a depth-only pass fetches nothing it does not use
+    if (new_primitive.compact) { // decoded by default.vert
+        new_primitive.position_offset = primitive.position_offset;
+        new_primitive.position_scale  = primitive.position_scale;
+
+        const CompactVertices&            vertices = primitive.compact_vertices;
+        std::vector<glm::u16vec4>         positions(vertices.size());
+        std::vector<CompactVertexSkin>    skins(vertices.size());
+        std::vector<CompactVertexShading> shading(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            positions[i]             = vertices[i].position;
+            skins[i].joints          = vertices[i].joints;
+            skins[i].weights         = vertices[i].weights;
+            shading[i].normal        = vertices[i].normal;
+            shading[i].tangent       = vertices[i].tangent;
+            shading[i].texture_coord = vertices[i].texture_coord;
 
-    new_primitive.vbo.Create(primitive.vertices);
-    new_primitive.vbo.Bind();
+            new_primitive.skinned = new_primitive.skinned || vertices[i].weights != glm::u8vec4(0);
+        }
 
-    constexpr GLsizei stride = sizeof(Vertex);
+        new_primitive.position_vbo.Create(positions.data(), positions.size() * sizeof(glm::u16vec4));
+        if (new_primitive.skinned) {
+            new_primitive.skin_vbo.Create(skins.data(), skins.size() * sizeof(CompactVertexSkin));
+        }
+        new_primitive.shading_vbo.Create(shading.data(), shading.size() * sizeof(CompactVertexShading));
+    }
+    else {
+        const Vertices&            vertices = primitive.vertices;
+        std::vector<glm::vec3>     positions(vertices.size());
+        std::vector<VertexSkin>    skins(vertices.size());
+        std::vector<VertexShading> shading(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            positions[i]             = vertices[i].position;
+            skins[i].joints          = vertices[i].joints;
+            skins[i].weights         = vertices[i].weights;
+            shading[i].normal        = vertices[i].normal;
+            shading[i].texture_coord = vertices[i].texture_coord;
+            shading[i].tangent       = vertices[i].tangent;
+
+            new_primitive.skinned = new_primitive.skinned || vertices[i].weights != glm::vec4(0.0F);
+        }
 
-    VAO::LinkAttrib(new_primitive.vbo, 0, 3, GL_FLOAT, stride, (void*) offsetof(Vertex, position));
-    VAO::LinkAttrib(new_primitive.vbo, 1, 3, GL_FLOAT, stride, (void*) offsetof(Vertex, normal));
-    VAO::LinkAttrib(new_primitive.vbo, 2, 2, GL_FLOAT, stride, (void*) offsetof(Vertex, texture_coord));
+        new_primitive.position_vbo.Create(positions.data(), positions.size() * sizeof(glm::vec3));
+        if (new_primitive.skinned) {
+            new_primitive.skin_vbo.Create(skins.data(), skins.size() * sizeof(VertexSkin));
+        }
+        new_primitive.shading_vbo.Create(shading.data(), shading.size() * sizeof(VertexShading));
+    }
+    VBO::Unbind();
 
-    new_primitive.vbo.Bind();
-    glVertexAttribIPointer(3, 4, GL_UNSIGNED_SHORT, stride, (void*) offsetof(Vertex, joints));
-    glEnableVertexAttribArray(3);
+    new_primitive.vao.Create();
+    new_primitive.vao.Bind();
+    this->linkAttributes(new_primitive, false);
 
-    VAO::LinkAttrib(new_primitive.vbo, 4, 4, GL_FLOAT, stride, (void*) offsetof(Vertex, weights));
-    VAO::LinkAttrib(new_primitive.vbo, 5, 4, GL_FLOAT, stride, (void*) offsetof(Vertex, tangent));
+    if (primitive.lods.empty()) {
+        new_primitive.ebo.Create(primitive.indices);
+    }
+    else { // one element buffer for every level, LODs only move the draw offset
+        Indices indices = primitive.indices;
+        std::visit([&](auto& all_indices) {
+            using IndexVector = std::decay_t<decltype(all_indices)>;
+            using Index       = typename IndexVector::value_type;
+            for (const PrimitiveLod& lod : primitive.lods) {
+                const auto& lod_indices = std::get<IndexVector>(lod.indices); // PrimitiveOptimizer keeps every level in the same index type
 
-    new_primitive.ebo.Create(primitive.indices);
+                OpenGLPrimitiveLod& new_lod = new_primitive.lods.emplace_back();
+                new_lod.index_count         = lod_indices.size();
+                new_lod.index_offset        = all_indices.size() * sizeof(Index);
+                new_lod.error               = lod.error;
+                all_indices.insert(all_indices.end(), lod_indices.begin(), lod_indices.end());
+            }
+        },
+                   indices);
+        new_primitive.ebo.Create(indices);
+    }
     new_primitive.ebo.Bind();
 
-    VBO::Unbind();
+    new_primitive.depth_vao.Create();
+    new_primitive.depth_vao.Bind();
+    this->linkAttributes(new_primitive, true);
+    new_primitive.ebo.Bind(); // the element buffer binding is VAO state
+
     VAO::Unbind();
     EBO::Unbind();
 }
 
-void OpenGLResourceManager::createTexture(const Texture& texture) {
-    auto& new_texture = m_textures.emplace_back();
+void OpenGLResourceManager::linkAttributes(OpenGLPrimitive& new_primitive, bool depth_only) {
+    if (new_primitive.compact) {
+        VAO::LinkAttrib(new_primitive.position_vbo, 0, 4, GL_UNSIGNED_SHORT, sizeof(glm::u16vec4), nullptr, GL_TRUE);
+
+        if (new_primitive.skinned) {
+            constexpr GLsizei stride = sizeof(CompactVertexSkin);
+
+            new_primitive.skin_vbo.Bind();
+            glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, stride, (void*) offsetof(CompactVertexSkin, joints));
+            glEnableVertexAttribArray(3);
+
+            VAO::LinkAttrib(new_primitive.skin_vbo, 4, 4, GL_UNSIGNED_BYTE, stride, (void*) offsetof(CompactVertexSkin, weights), GL_TRUE);
+        }
+
+        if (!depth_only) {
+            constexpr GLsizei stride = sizeof(CompactVertexShading);
+
+            VAO::LinkAttrib(new_primitive.shading_vbo, 1, 2, GL_SHORT, stride, (void*) offsetof(CompactVertexShading, normal), GL_TRUE);
+            VAO::LinkAttrib(new_primitive.shading_vbo, 2, 2, GL_HALF_FLOAT, stride, (void*) offsetof(CompactVertexShading, texture_coord));
+            VAO::LinkAttrib(new_primitive.shading_vbo, 5, 2, GL_SHORT, stride, (void*) offsetof(CompactVertexShading, tangent), GL_TRUE);
+        }
+    }
+    else {
+        VAO::LinkAttrib(new_primitive.position_vbo, 0, 3, GL_FLOAT, sizeof(glm::vec3), nullptr);
+
+        if (new_primitive.skinned) {
+            constexpr GLsizei stride = sizeof(VertexSkin);
+
+            new_primitive.skin_vbo.Bind();
+            glVertexAttribIPointer(3, 4, GL_UNSIGNED_SHORT, stride, (void*) offsetof(VertexSkin, joints));
+            glEnableVertexAttribArray(3);
+
+            VAO::LinkAttrib(new_primitive.skin_vbo, 4, 4, GL_FLOAT, stride, (void*) offsetof(VertexSkin, weights));
+        }
+
+        if (!depth_only) {
+            constexpr GLsizei stride = sizeof(VertexShading);
+
+            VAO::LinkAttrib(new_primitive.shading_vbo, 1, 3, GL_FLOAT, stride, (void*) offsetof(VertexShading, normal));
+            VAO::LinkAttrib(new_primitive.shading_vbo, 2, 2, GL_FLOAT, stride, (void*) offsetof(VertexShading, texture_coord));
+            VAO::LinkAttrib(new_primitive.shading_vbo, 5, 4, GL_FLOAT, stride, (void*) offsetof(VertexShading, tangent));
+        }
+    }
+
+    VBO::Unbind();
+}
+
+void OpenGLResourceManager::setTexture(size_t slot, const std::shared_ptr<Texture>& texture) {
+    m_textures[slot].reset(); // a low resolution one is replaced in place
+    if (texture == nullptr) {
+        return;
+    }
+
+    auto it = m_sharedTextures.find(texture.get());
+    if (it != m_sharedTextures.end() && it->second.texture.lock() == texture) {
+        if (std::shared_ptr<OpenGLTexture> gpu = it->second.gpu.lock()) { // uploaded for another slot, another model or the same image again
+            m_textures[slot] = std::move(gpu);
+            return;
+        }
+    }
+
+    if (texture->getBytes() == nullptr) {
+        return; // not decoded yet, the placeholder stands in
+    }
+
+    auto gpu = std::make_shared<OpenGLTexture>();
+    if (m_streamer == nullptr) {
+        this->createTexture(*gpu, *texture);
+    }
+
+    this->pruneSharedTextures();
+    OpenGLSharedTexture& shared = m_sharedTextures[texture.get()];
+    shared.texture              = texture;
+    shared.gpu                  = gpu;
+    m_textures[slot]            = std::move(gpu);
+
+    if (m_streamer != nullptr) {
+        m_streamer->addTexture(texture); // uploads the tail through setResidentLevels()
+    }
+}
+
+void OpenGLResourceManager::pruneSharedTextures() {
+    std::erase_if(m_sharedTextures, [&](const auto& shared) {
+        if (!shared.second.gpu.expired()) {
+            return false;
+        }
+        if (m_streamer != nullptr) {
+            m_streamer->removeTexture(*shared.first); // still alive, the streamer holds it
+        }
+        return true;
+    });
+}
+
+void OpenGLResourceManager::createTexture(OpenGLTexture& new_texture, const Texture& texture, unsigned int first_level, GLuint resident, unsigned int resident_first_level) {
+    glDeleteTextures(1, &new_texture.index); // a low resolution one is replaced in place
+    new_texture.index = 0;
+    if (texture.getBytes() == nullptr) {
+        return; // not decoded yet, the placeholder stands in
+    }
 
     int min_filter{};
     int mag_filter{};
@@ -194,6 +584,30 @@ void OpenGLResourceManager::createTexture(const Texture& texture) {
         case Texture::TextureInternalFormat::SRGB8:
             internal_format = GL_SRGB8;
             break;
+        case Texture::TextureInternalFormat::BC1:
+            internal_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            break;
+        case Texture::TextureInternalFormat::BC1_SRGB:
+            internal_format = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+            break;
+        case Texture::TextureInternalFormat::BC3:
+            internal_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            break;
+        case Texture::TextureInternalFormat::BC3_SRGB:
+            internal_format = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+            break;
+        case Texture::TextureInternalFormat::BC4:
+            internal_format = GL_COMPRESSED_RED_RGTC1;
+            break;
+        case Texture::TextureInternalFormat::BC5:
+            internal_format = GL_COMPRESSED_RG_RGTC2;
+            break;
+        case Texture::TextureInternalFormat::BC7:
+            internal_format = GL_COMPRESSED_RGBA_BPTC_UNORM;
+            break;
+        case Texture::TextureInternalFormat::BC7_SRGB:
+            internal_format = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+            break;
         default:
             assert(false);
             break;
@@ -226,8 +640,82 @@ void OpenGLResourceManager::createTexture(const Texture& texture) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_t);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, texture.getWidth(), texture.getHeight(), 0, data_format, GL_UNSIGNED_BYTE, texture.getBytes());
+    // levels first_level .. copy_first_level are uploaded, the rest is already on the GPU
+    first_level                   = std::min(first_level, texture.getMipLevels() - 1);
+    unsigned int copy_first_level = resident == 0 ? texture.getMipLevels() : std::max(resident_first_level, first_level);
+    GLsizei      storage_levels   = static_cast<GLsizei>(texture.getMipLevels() - first_level);
+    GLsizei      storage_width    = static_cast<GLsizei>(texture.getMipWidth(first_level));
+    GLsizei      storage_height   = static_cast<GLsizei>(texture.getMipHeight(first_level));
+    auto         copy_resident    = [&]() {
+        for (unsigned int level = copy_first_level; level < texture.getMipLevels(); level++) {
+            glCopyImageSubData(resident,
+                               GL_TEXTURE_2D,
+                               static_cast<GLint>(level - resident_first_level),
+                               0,
+                               0,
+                               0,
+                               new_texture.index,
+                               GL_TEXTURE_2D,
+                               static_cast<GLint>(level - first_level),
+                               0,
+                               0,
+                               0,
+                               static_cast<GLsizei>(texture.getMipWidth(level)),
+                               static_cast<GLsizei>(texture.getMipHeight(level)),
+                               1);
+        }
+    };
+
+    if (texture.isCompressed()) { // TextureCompressor blocks, the levels are already there
+        glTextureStorage2D(new_texture.index, storage_levels, internal_format, storage_width, storage_height);
+        for (unsigned int level = first_level; level < copy_first_level; level++) {
+            glCompressedTextureSubImage2D(new_texture.index,
+                                          static_cast<GLint>(level - first_level),
+                                          0,
+                                          0,
+                                          texture.getMipWidth(level),
+                                          texture.getMipHeight(level),
+                                          internal_format,
+                                          static_cast<GLsizei>(texture.getMipSize(level)),
+                                          texture.getMipData(level));
+        }
+        copy_resident();
+    }
+    else if (texture.getMipLevels() > 1) { // chain from MipGenerator : immutable storage, every level uploaded as is
+        glTextureStorage2D(new_texture.index, storage_levels, internal_format, storage_width, storage_height);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows of the small RGB levels are not 4-byte aligned
+        for (unsigned int level = first_level; level < copy_first_level; level++) {
+            glTextureSubImage2D(new_texture.index,
+                                static_cast<GLint>(level - first_level),
+                                0,
+                                0,
+                                texture.getMipWidth(level),
+                                texture.getMipHeight(level),
+                                data_format,
+                                GL_UNSIGNED_BYTE,
+                                texture.getMipData(level));
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        copy_resident();
+    }
+    else {
+        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, texture.getWidth(), texture.getHeight(), 0, data_format, GL_UNSIGNED_BYTE, texture.getBytes());
+
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void OpenGLResourceManager::createPlaceholderTexture() {
+    const unsigned char white[4] = { 255, 255, 255, 255 };
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_placeholderTexture.index);
+    glBindTexture(GL_TEXTURE_2D, m_placeholderTexture.index);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
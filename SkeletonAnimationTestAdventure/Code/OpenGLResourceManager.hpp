@@ -1,6 +1,12 @@
 #pragma once
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include <glad/glad.h>
 #include "Model.hpp"
+#include "ModelStream.hpp"
+#include "TextureStreamer.hpp"
 
 struct OpenGLTexture {
     GLuint index{ 0 };
@@ -11,41 +17,135 @@ struct OpenGLTexture {
     }
 };
 
+// GPU copy of a Texture, for every slot using that Texture
+struct OpenGLSharedTexture {
+    std::weak_ptr<const Texture> texture; // expired - the texture is gone and its address may be reused
+    std::weak_ptr<OpenGLTexture> gpu;
+
+    OpenGLSharedTexture()  = default;
+    ~OpenGLSharedTexture() = default;
+};
+
+// PrimitiveLod inside the primitive's ebo, after the full detail indices
+struct OpenGLPrimitiveLod {
+    size_t index_count{};
+    size_t index_offset{}; // bytes
+    float  error{ 0.0F };  // PrimitiveLod::error, for LodSelection::getErrorScale
+
+    OpenGLPrimitiveLod()  = default;
+    ~OpenGLPrimitiveLod() = default;
+};
+
 struct OpenGLPrimitive {
-    int material{ -1 };
+    int  material{ -1 };
+    bool resident{ false }; // buffers created, a placeholder ( bounds only ) until then
 
     RenderMode enum_mode{};
     GLenum     mode{ GL_TRIANGLES }; // triangles by default
 
-    VAO vao{};
-    VBO vbo{};
+    VAO vao{};       // every attribute
+    VAO depth_vao{}; // position ( + skin ) streams only, for depth pre-pass and shadow passes
+
+    VBO position_vbo{}; // POSITION_STREAM
+    VBO skin_vbo{};     // SKIN_STREAM, not created for meshes without skinning
+    VBO shading_vbo{};  // SHADING_STREAM
     EBO ebo{};
 
+    bool skinned{ false };
+
     RenderIndexType enum_index_type{};
     GLenum          index_type{};
 
     size_t index_count{};
     size_t index_offset{};
 
+    std::vector<OpenGLPrimitiveLod> lods;                   // coarser levels, lods[0] is LOD 1
+    glm::vec3                       bounds_center{ 0.0F }; // Primitive bounding sphere, for LodSelection
+    float                           bounds_radius{ 0.0F };
+
+    // CompactVertex layout ( Primitive::compact ). ModelInstance::drawPrimitive() sets u_compactVertices and the position dequantization uniforms from it
+    bool      compact{ false };
+    glm::vec3 position_offset{ 0.0F }; // u_positionOffset
+    glm::vec3 position_scale{ 1.0F };  // u_positionScale
+
     OpenGLPrimitive()  = default;
     ~OpenGLPrimitive() = default;
 };
 
-class OpenGLResourceManager {
+// slots of one ModelAsset in m_primitives / m_textures, in Model::getMeshes() / getTextures() order
+// every model drawing that asset uses the same slots
+struct OpenGLModelRange {
+    std::weak_ptr<const ModelAsset> asset;          // expired - the asset is gone and its address may be reused, the slots are stale
+    size_t                          models{ 0 };    // models resident with this range
+
+    size_t first_primitive{ 0 };
+    size_t primitive_count{ 0 };
+    size_t first_texture{ 0 };
+    size_t texture_count{ 0 };
+
+    OpenGLModelRange()  = default;
+    ~OpenGLModelRange() = default;
+};
+
+// run of released slots in m_primitives or m_textures, createSlots() reuses it for the next model
+struct OpenGLFreeSlots {
+    size_t first{ 0 };
+    size_t count{ 0 };
+
+    OpenGLFreeSlots()  = default;
+    ~OpenGLFreeSlots() = default;
+};
+
+class OpenGLResourceManager : public ITextureStreamBackend {
 public:
     OpenGLResourceManager()  = default;
     ~OpenGLResourceManager() = default;
 
-    void loadModel(const Model& model);
+    // uploads the model's asset, unless another model did already. The model draws from the same slots then
+    void loadModel(Model& model);
+    void updateModel(Model& model, const ModelStreamUpdate& update);
+    // the model stops using its slots, they are released with the last model using them
+    void unloadModel(const Model& model);
+
+    // the model's texture, a 1x1 white one while it is not uploaded yet
+    GLuint getTexture(const Model& model, int texture_index) const;
+
+    // textures uploaded from now on start with their tail levels, the streamer brings the finer ones on request
+    // their CPU texels stay for that, an evicted level is uploaded again from them
+    TextureStreamer* enableTextureStreaming(const TextureStreamingOptions& options);
 
-    inline const std::vector<OpenGLPrimitive>& getPrimitives() const noexcept { return m_primitives; }
+    // ITextureStreamBackend : new immutable storage for the resident levels, the ones kept are copied on the GPU
+    void setResidentLevels(const Texture& texture, unsigned int first_level, unsigned int previous_first_level) override;
+    void releaseTexture(const Texture& texture) override;
+
+    inline const std::deque<OpenGLPrimitive>& getPrimitives() const noexcept { return m_primitives; }
 
 private:
-    void createPrimitive(const Primitive& primitive);
-    void createBuffers(OpenGLPrimitive& new_primitive, const Primitive& primitive);
-    void createTexture(const Texture& texture);
+    OpenGLModelRange* findRange(const Model& model);
+    void              addResident(const Model& model, OpenGLModelRange& range);
+    OpenGLModelRange& createSlots(const Model& model);
+    void              releaseSlots(const OpenGLModelRange& range);
+    void              createPlaceholder(OpenGLPrimitive& new_primitive, const Primitive& primitive);
+    void              createPrimitive(OpenGLPrimitive& new_primitive, const Primitive& primitive);
+    void              createBuffers(OpenGLPrimitive& new_primitive, const Primitive& primitive);
+    void              linkAttributes(OpenGLPrimitive& new_primitive, bool depth_only);
+    void              setTexture(size_t slot, const std::shared_ptr<Texture>& texture); // the GPU copy of the texture, shared if it exists
+    void              pruneSharedTextures(); // forgets the textures no slot uses anymore
+    // first_level - the texture's level stored as level 0, the coarser ones follow
+    // resident - texture holding the levels from resident_first_level on, the ones both need are copied instead of uploaded
+    void              createTexture(OpenGLTexture& new_texture, const Texture& texture, unsigned int first_level = 0, GLuint resident = 0, unsigned int resident_first_level = 0);
+    void              createPlaceholderTexture();
 
 private:
-    std::vector<OpenGLTexture>   m_textures;
-    std::vector<OpenGLPrimitive> m_primitives;
+    // deques, the GL objects are released by their destructors and must never be moved by a reallocation
+    std::deque<std::shared_ptr<OpenGLTexture>> m_textures; // slots of the same Texture share its GPU copy ( TextureRegistry )
+    std::deque<OpenGLPrimitive>                m_primitives;
+    std::vector<OpenGLFreeSlots>               m_freeTextures;   // released slots, sorted and merged, none at the end of the deque
+    std::vector<OpenGLFreeSlots>               m_freePrimitives;
+
+    std::unordered_map<const ModelAsset*, OpenGLModelRange> m_ranges;    // GPU copy of every uploaded ModelAsset
+    std::unordered_map<const Model*, const ModelAsset*>     m_residency; // per model : the range it draws from
+    std::unordered_map<const Texture*, OpenGLSharedTexture> m_sharedTextures;
+    OpenGLTexture                                           m_placeholderTexture;
+    std::unique_ptr<TextureStreamer>                        m_streamer; // nullptr - every texture is resident as a whole
 };
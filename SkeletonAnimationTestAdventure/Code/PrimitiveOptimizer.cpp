@@ -0,0 +1,834 @@
+#include "PrimitiveOptimizer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <numeric>
+
+#include <glm/gtc/packing.hpp>
+
+#include "Hash.hpp"
+#include "MeshSimplifier.hpp"
+
+static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+// FIFO post-transform cache. A vertex is cached if fewer than cache_size misses happened since it was inserted
+class VertexCacheSimulator {
+public:
+    VertexCacheSimulator(size_t vertices_count, size_t cache_size)
+        : m_insertTime(vertices_count, 0), m_cacheSize(static_cast<uint32_t>(cache_size)), m_time(m_cacheSize + 1) {}
+    ~VertexCacheSimulator() = default;
+
+    inline bool isCached(uint32_t vertex) const noexcept { return m_time - m_insertTime[vertex] <= m_cacheSize; }
+
+    // true on a miss
+    inline bool access(uint32_t vertex) noexcept {
+        if (this->isCached(vertex)) {
+            return false;
+        }
+        m_insertTime[vertex] = m_time++;
+        return true;
+    }
+
+    // how long ago the vertex entered the cache, in misses
+    inline uint32_t getAge(uint32_t vertex) const noexcept { return m_time - m_insertTime[vertex]; }
+
+    inline void flush() noexcept { m_time += m_cacheSize + 1; }
+
+private:
+    std::vector<uint32_t> m_insertTime;
+    uint32_t              m_cacheSize;
+    uint32_t              m_time;
+};
+
+// octahedral mapping of a unit vector, the same decode is in default.vert
+static glm::i16vec2 encodeOctahedral(glm::vec3 vector) {
+    float length = std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+    if (length == 0.0F) {
+        return { 0, 0 };
+    }
+    vector /= length;
+
+    glm::vec2 octahedral{ vector.x, vector.y };
+    if (vector.z < 0.0F) { // fold the lower hemisphere over the diagonals
+        octahedral = (1.0F - glm::abs(glm::vec2{ vector.y, vector.x })) * glm::vec2{ vector.x >= 0.0F ? 1.0F : -1.0F, vector.y >= 0.0F ? 1.0F : -1.0F };
+    }
+    return glm::i16vec2(glm::round(glm::clamp(octahedral, -1.0F, 1.0F) * 32767.0F));
+}
+
+static glm::vec3 decodeOctahedral(glm::i16vec2 encoded) {
+    glm::vec2 octahedral = glm::max(glm::vec2(encoded) / 32767.0F, -1.0F);
+    glm::vec3 vector{ octahedral.x, octahedral.y, 1.0F - std::abs(octahedral.x) - std::abs(octahedral.y) };
+    float     fold = std::max(-vector.z, 0.0F);
+    vector.x += vector.x >= 0.0F ? -fold : fold;
+    vector.y += vector.y >= 0.0F ? -fold : fold;
+    return glm::normalize(vector);
+}
+
+// unorm8 weights that still sum to exactly 1.0 after quantization
+static glm::u8vec4 encodeWeights(glm::vec4 weights) {
+    float sum = weights.x + weights.y + weights.z + weights.w;
+    if (sum <= 0.0F) {
+        return { 0, 0, 0, 0 };
+    }
+
+    glm::ivec4 quantized = glm::ivec4(glm::round(weights / sum * 255.0F));
+    int        largest   = 0;
+    for (int i = 1; i < 4; i++) {
+        if (quantized[i] > quantized[largest]) {
+            largest = i;
+        }
+    }
+    quantized[largest] += 255 - (quantized.x + quantized.y + quantized.z + quantized.w);
+    return glm::u8vec4(glm::clamp(quantized, 0, 255));
+}
+
+static std::vector<uint32_t> readIndices(const Indices& indices, size_t vertices_count) {
+    std::vector<uint32_t> values{};
+    std::visit([&](const auto& typed) {
+        values.assign(typed.begin(), typed.end());
+    },
+               indices);
+
+    for (uint32_t index : values) {
+        if (index >= vertices_count) {
+            throw std::runtime_error("Index is out of the vertex range");
+        }
+    }
+    return values;
+}
+
+static std::vector<uint32_t> readIndices(const Primitive& primitive) {
+    return readIndices(primitive.indices, primitive.vertices.size());
+}
+
+// keeps the index type, values must fit into it
+static void writeIndices(Indices& indices, const std::vector<uint32_t>& values) {
+    std::visit([&](auto& typed) {
+        using Index = typename std::decay_t<decltype(typed)>::value_type;
+        typed.resize(values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+            typed[i] = static_cast<Index>(values[i]);
+        }
+    },
+               indices);
+}
+
+static void writeIndices(Primitive& primitive, const std::vector<uint32_t>& values) {
+    writeIndices(primitive.indices, values);
+}
+
+// Sander, Nehab, Barczak - "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007
+// returns the new triangle order. clusters - first triangle ( in the new order ) after every jump out of the cache
+static std::vector<uint32_t> tipsify(const std::vector<uint32_t>& indices, size_t vertices_count, size_t cache_size, std::vector<size_t>* clusters) {
+    size_t triangles_count = indices.size() / 3;
+
+    // vertex -> triangles adjacency
+    std::vector<uint32_t> offsets(vertices_count + 1, 0);
+    for (size_t i = 0; i < triangles_count * 3; i++) {
+        offsets[indices[i] + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<uint32_t> adjacency(triangles_count * 3);
+    std::vector<uint32_t> live(vertices_count); // triangles not emitted yet, per vertex
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangles_count * 3; i++) {
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+        for (size_t v = 0; v < vertices_count; v++) {
+            live[v] = offsets[v + 1] - offsets[v];
+        }
+    }
+
+    VertexCacheSimulator  cache(vertices_count, cache_size);
+    std::vector<bool>     emitted(triangles_count, false);
+    std::vector<uint32_t> dead_end{}; // recently used vertices, the fallback when fanning runs out of candidates
+    std::vector<uint32_t> candidates{};
+    std::vector<uint32_t> order{};
+    order.reserve(triangles_count);
+
+    uint32_t fanning     = 0;
+    size_t   cursor      = 0;
+    bool     new_cluster = true;
+
+    while (true) {
+        candidates.clear();
+
+        for (uint32_t k = offsets[fanning]; k < offsets[fanning + 1]; k++) {
+            uint32_t triangle = adjacency[k];
+            if (emitted[triangle]) {
+                continue;
+            }
+            if (new_cluster && clusters != nullptr) {
+                clusters->push_back(order.size());
+            }
+            new_cluster = false;
+
+            for (size_t c = 0; c < 3; c++) {
+                uint32_t vertex = indices[(triangle * 3) + c];
+                dead_end.push_back(vertex);
+                candidates.push_back(vertex);
+                live[vertex]--;
+                cache.access(vertex);
+            }
+            emitted[triangle] = true;
+            order.push_back(triangle);
+        }
+
+        // the oldest candidate that stays in the cache while its remaining triangles are emitted, else any live one
+        uint32_t next          = EMPTY_SLOT;
+        int64_t  best_priority = -1;
+        for (uint32_t vertex : candidates) {
+            if (live[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            if (cache.getAge(vertex) + (2 * live[vertex]) <= cache_size) {
+                priority = cache.getAge(vertex);
+            }
+            if (priority > best_priority) {
+                best_priority = priority;
+                next          = vertex;
+            }
+        }
+
+        if (next == EMPTY_SLOT) { // dead end : the most recent vertex with triangles left, then the input order
+            while (!dead_end.empty() && next == EMPTY_SLOT) {
+                uint32_t vertex = dead_end.back();
+                dead_end.pop_back();
+                if (live[vertex] > 0) {
+                    next = vertex;
+                }
+            }
+            while (next == EMPTY_SLOT && cursor < vertices_count) {
+                if (live[cursor] > 0) {
+                    next = static_cast<uint32_t>(cursor);
+                }
+                cursor++;
+            }
+            if (next == EMPTY_SLOT) {
+                break;
+            }
+            new_cluster = !cache.isCached(next);
+        }
+
+        fanning = next;
+    }
+
+    return order;
+}
+
+static void optimizeIndicesVertexCache(Indices& indices, size_t vertices_count, size_t cache_size) {
+    std::vector<uint32_t> values = readIndices(indices, vertices_count);
+    std::vector<uint32_t> order  = tipsify(values, vertices_count, cache_size, nullptr);
+
+    std::vector<uint32_t> reordered(values.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        memcpy(&reordered[i * 3], &values[order[i] * 3], 3 * sizeof(uint32_t));
+    }
+    writeIndices(indices, reordered);
+}
+
+size_t PrimitiveOptimizer::weldVertices(Primitive& primitive) {
+    const Vertices& vertices = primitive.vertices;
+    if (vertices.empty()) {
+        return 0;
+    }
+
+    // open addressing over the welded vertices, at most half full
+    size_t                table_size = std::bit_ceil(vertices.size() * 2);
+    size_t                mask       = table_size - 1;
+    std::vector<uint32_t> table(table_size, EMPTY_SLOT);
+
+    std::vector<uint32_t> remap(vertices.size(), EMPTY_SLOT);
+    std::vector<uint32_t> welded_indices{};
+    Vertices              welded{};
+    welded.reserve(vertices.size());
+
+    std::visit([&](const auto& indices) {
+        welded_indices.reserve(indices.size());
+
+        for (auto index : indices) {
+            if (static_cast<size_t>(index) >= vertices.size()) {
+                throw std::runtime_error("Index is out of the vertex range");
+            }
+
+            uint32_t& new_index = remap[index];
+            if (new_index == EMPTY_SLOT) {
+                const Vertex& vertex = vertices[index];
+
+                size_t slot = hashBytes(&vertex, sizeof(Vertex)) & mask;
+                while (table[slot] != EMPTY_SLOT && memcmp(&welded[table[slot]], &vertex, sizeof(Vertex)) != 0) {
+                    slot = (slot + 1) & mask;
+                }
+
+                if (table[slot] == EMPTY_SLOT) {
+                    table[slot] = static_cast<uint32_t>(welded.size());
+                    welded.push_back(vertex);
+                }
+                new_index = table[slot];
+            }
+
+            welded_indices.push_back(new_index);
+        }
+    },
+               primitive.indices);
+
+    // LOD levels only use vertices the full level uses
+    for (PrimitiveLod& lod : primitive.lods) {
+        std::vector<uint32_t> lod_indices = readIndices(lod.indices, vertices.size());
+        for (uint32_t& index : lod_indices) {
+            if (remap[index] == EMPTY_SLOT) {
+                throw std::runtime_error("LOD index is not used by the primitive");
+            }
+            index = remap[index];
+        }
+        lod.indices = std::move(lod_indices);
+    }
+
+    size_t removed = vertices.size() - welded.size();
+
+    primitive.vertices = std::move(welded);
+    primitive.indices  = std::move(welded_indices);
+    PrimitiveOptimizer::compactIndices(primitive);
+
+    return removed;
+}
+
+void PrimitiveOptimizer::compactIndices(Primitive& primitive) {
+    size_t vertices_count = primitive.vertices.size();
+
+    // u8 stays u8 if it already was and still fits, it is never chosen otherwise : many GPUs widen u8 indices on the fly
+    RenderIndexType index_type = RenderIndexType::UNSIGNED_INT;
+    if (primitive.index_type == RenderIndexType::UNSIGNED_BYTE && vertices_count <= PrimitiveOptimizer::getMaxIndex(RenderIndexType::UNSIGNED_BYTE) + 1) {
+        index_type = RenderIndexType::UNSIGNED_BYTE;
+    }
+    else if (vertices_count <= PrimitiveOptimizer::getMaxIndex(RenderIndexType::UNSIGNED_SHORT) + 1) {
+        index_type = RenderIndexType::UNSIGNED_SHORT;
+    }
+
+    auto convert = [&]<typename T>(Indices& indices, T /*type tag*/) {
+        if (std::holds_alternative<std::vector<T>>(indices)) {
+            return;
+        }
+
+        std::vector<T> converted{};
+        std::visit([&](const auto& typed) {
+            converted.resize(typed.size());
+            for (size_t i = 0; i < typed.size(); i++) {
+                converted[i] = static_cast<T>(typed[i]);
+            }
+        },
+                   indices);
+        indices = std::move(converted);
+    };
+
+    auto convert_all = [&]<typename T>(T type_tag) {
+        convert(primitive.indices, type_tag);
+        for (PrimitiveLod& lod : primitive.lods) {
+            convert(lod.indices, type_tag);
+        }
+    };
+
+    switch (index_type) {
+        case RenderIndexType::UNSIGNED_BYTE:
+            convert_all(uint8_t{});
+            break;
+        case RenderIndexType::UNSIGNED_SHORT:
+            convert_all(uint16_t{});
+            break;
+        case RenderIndexType::UNSIGNED_INT:
+            convert_all(uint32_t{});
+            break;
+    }
+
+    primitive.index_type   = index_type;
+    primitive.index_count  = std::visit([](const auto& indices) { return indices.size(); }, primitive.indices);
+    primitive.index_offset = 0;
+}
+
+
+void PrimitiveOptimizer::optimizeVertexCache(Primitive& primitive, size_t cache_size) {
+    if (primitive.mode != RenderMode::TRIANGLES) {
+        return;
+    }
+
+    optimizeIndicesVertexCache(primitive.indices, primitive.vertices.size(), cache_size);
+    for (PrimitiveLod& lod : primitive.lods) {
+        optimizeIndicesVertexCache(lod.indices, primitive.vertices.size(), cache_size);
+    }
+}
+
+void PrimitiveOptimizer::optimizeOverdraw(Primitive& primitive, float threshold, size_t cache_size) {
+    if (primitive.mode != RenderMode::TRIANGLES) {
+        return;
+    }
+
+    const Vertices&       vertices        = primitive.vertices;
+    std::vector<uint32_t> indices         = readIndices(primitive);
+    size_t                triangles_count = indices.size() / 3;
+    if (triangles_count == 0) {
+        return;
+    }
+
+    std::vector<size_t>   hard_clusters{};
+    std::vector<uint32_t> order = tipsify(indices, vertices.size(), cache_size, &hard_clusters);
+    hard_clusters.push_back(triangles_count);
+
+    auto triangle_misses = [&](VertexCacheSimulator& cache, uint32_t triangle) {
+        size_t misses = 0;
+        for (size_t c = 0; c < 3; c++) {
+            misses += cache.access(indices[(triangle * 3) + c]) ? 1 : 0;
+        }
+        return misses;
+    };
+
+    size_t tipsify_misses = 0;
+    {
+        VertexCacheSimulator cache(vertices.size(), cache_size);
+        for (uint32_t triangle : order) {
+            tipsify_misses += triangle_misses(cache, triangle);
+        }
+    }
+    float acmr_limit = threshold * static_cast<float>(tipsify_misses) / static_cast<float>(triangles_count);
+
+    // hard clusters are split further wherever the cluster so far is already cheaper than the limit,
+    // every cluster starts with a cold cache, so drawing them in any order keeps the ACMR under the limit
+    std::vector<size_t> clusters{};
+    {
+        VertexCacheSimulator cache(vertices.size(), cache_size);
+        for (size_t h = 0; h + 1 < hard_clusters.size(); h++) {
+            size_t start  = hard_clusters[h];
+            size_t end    = hard_clusters[h + 1];
+            size_t misses = 0;
+            cache.flush();
+            clusters.push_back(start);
+
+            for (size_t i = start; i < end; i++) {
+                misses += triangle_misses(cache, order[i]);
+
+                if (i + 1 < end && static_cast<float>(misses) <= acmr_limit * static_cast<float>(i + 1 - start)) {
+                    start  = i + 1;
+                    misses = 0;
+                    cache.flush();
+                    clusters.push_back(start);
+                }
+            }
+
+            // a tail that never got cheap enough goes back to the cluster before it
+            if (start != hard_clusters[h] && static_cast<float>(misses) > acmr_limit * static_cast<float>(end - start)) {
+                clusters.pop_back();
+            }
+        }
+    }
+    clusters.push_back(triangles_count);
+
+    // view-independent occlusion potential : clusters far out along their own normal are likely to hide the rest
+    glm::vec3              mesh_centroid{ 0.0F };
+    float                  mesh_area = 0.0F;
+    std::vector<float>     cluster_keys(clusters.size() - 1);
+    std::vector<glm::vec3> cluster_centroids(clusters.size() - 1, glm::vec3{ 0.0F });
+    std::vector<glm::vec3> cluster_normals(clusters.size() - 1, glm::vec3{ 0.0F });
+
+    for (size_t c = 0; c + 1 < clusters.size(); c++) {
+        float cluster_area = 0.0F;
+        for (size_t i = clusters[c]; i < clusters[c + 1]; i++) {
+            const uint32_t* triangle = &indices[order[i] * 3];
+            glm::vec3       p0       = vertices[triangle[0]].position;
+            glm::vec3       p1       = vertices[triangle[1]].position;
+            glm::vec3       p2       = vertices[triangle[2]].position;
+
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0); // length is twice the area
+            float     area   = glm::length(normal) * 0.5F;
+
+            cluster_centroids[c] += (p0 + p1 + p2) * (area / 3.0F);
+            cluster_normals[c] += normal;
+            cluster_area += area;
+        }
+
+        mesh_centroid += cluster_centroids[c];
+        mesh_area += cluster_area;
+        if (cluster_area > 0.0F) {
+            cluster_centroids[c] /= cluster_area;
+        }
+    }
+    if (mesh_area > 0.0F) {
+        mesh_centroid /= mesh_area;
+    }
+
+    for (size_t c = 0; c < cluster_keys.size(); c++) {
+        float length    = glm::length(cluster_normals[c]);
+        cluster_keys[c] = length > 0.0F ? glm::dot(cluster_centroids[c] - mesh_centroid, cluster_normals[c] / length) : 0.0F;
+    }
+
+    std::vector<size_t> cluster_order(cluster_keys.size());
+    std::iota(cluster_order.begin(), cluster_order.end(), 0);
+    std::stable_sort(cluster_order.begin(), cluster_order.end(), [&](size_t a, size_t b) { return cluster_keys[a] > cluster_keys[b]; });
+
+    std::vector<uint32_t> reordered{};
+    reordered.reserve(indices.size());
+    for (size_t c : cluster_order) {
+        for (size_t i = clusters[c]; i < clusters[c + 1]; i++) {
+            const uint32_t* triangle = &indices[order[i] * 3];
+            reordered.insert(reordered.end(), triangle, triangle + 3);
+        }
+    }
+    writeIndices(primitive, reordered);
+
+    // distant levels do not get the overdraw order, plain Tipsify
+    for (PrimitiveLod& lod : primitive.lods) {
+        optimizeIndicesVertexCache(lod.indices, vertices.size(), cache_size);
+    }
+}
+
+void PrimitiveOptimizer::optimizeVertexFetch(Primitive& primitive) {
+    const Vertices& vertices = primitive.vertices;
+
+    std::vector<uint32_t> remap(vertices.size(), EMPTY_SLOT);
+    Vertices              reordered{};
+    reordered.reserve(vertices.size());
+
+    std::visit([&](auto& indices) {
+        using Index = typename std::decay_t<decltype(indices)>::value_type;
+        for (auto& index : indices) {
+            if (static_cast<size_t>(index) >= vertices.size()) {
+                throw std::runtime_error("Index is out of the vertex range");
+            }
+
+            uint32_t& new_index = remap[index];
+            if (new_index == EMPTY_SLOT) {
+                new_index = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = static_cast<Index>(new_index); // never larger than the old one, fits the same type
+        }
+    },
+               primitive.indices);
+
+    // LOD levels only use vertices the full level uses, all of them are renumbered already
+    for (PrimitiveLod& lod : primitive.lods) {
+        std::visit([&](auto& indices) {
+            using Index = typename std::decay_t<decltype(indices)>::value_type;
+            for (auto& index : indices) {
+                if (static_cast<size_t>(index) >= vertices.size() || remap[index] == EMPTY_SLOT) {
+                    throw std::runtime_error("LOD index is not used by the primitive");
+                }
+                index = static_cast<Index>(remap[index]);
+            }
+        },
+                   lod.indices);
+    }
+
+    primitive.vertices = std::move(reordered);
+}
+
+void PrimitiveOptimizer::computeBounds(Primitive& primitive) {
+    const Vertices& vertices = primitive.vertices;
+    if (vertices.empty()) {
+        return;
+    }
+
+    glm::vec3 minimum = vertices[0].position;
+    glm::vec3 maximum = vertices[0].position;
+    for (const Vertex& vertex : vertices) {
+        minimum = glm::min(minimum, vertex.position);
+        maximum = glm::max(maximum, vertex.position);
+    }
+
+    glm::vec3 center = (minimum + maximum) * 0.5F;
+    float     radius = 0.0F;
+    for (const Vertex& vertex : vertices) {
+        radius = std::max(radius, glm::dot(vertex.position - center, vertex.position - center));
+    }
+
+    primitive.bounds_center = center;
+    primitive.bounds_radius = std::sqrt(radius);
+}
+
+size_t PrimitiveOptimizer::generateLods(Primitive& primitive, const std::vector<float>& ratios, float max_error) {
+    primitive.lods.clear();
+    if (primitive.mode != RenderMode::TRIANGLES || primitive.vertices.empty()) {
+        return 0;
+    }
+
+    std::vector<uint32_t> indices        = readIndices(primitive);
+    float                 target_error   = max_error * primitive.bounds_radius;
+    size_t                previous_count = indices.size();
+    float                 previous_error = 0.0F;
+
+    // every level is simplified from the full one, errors do not pile up along the chain
+    for (float ratio : ratios) {
+        size_t target_count = static_cast<size_t>(static_cast<float>(indices.size() / 3) * ratio) * 3;
+        float  error        = 0.0F;
+
+        std::vector<uint32_t> lod_indices = MeshSimplifier::simplify(primitive.vertices, indices, target_count, target_error, &error);
+
+        // a level close to the one before it only costs memory : the error limit or the locked seams stopped the simplifier
+        if (lod_indices.empty() || static_cast<double>(lod_indices.size()) > 0.9 * static_cast<double>(previous_count)) {
+            break;
+        }
+
+        PrimitiveLod& lod = primitive.lods.emplace_back();
+        lod.indices       = std::visit([](const auto& typed) { return Indices{ std::decay_t<decltype(typed)>{} }; }, primitive.indices);
+        lod.error         = std::max(error, previous_error);
+        writeIndices(lod.indices, lod_indices);
+
+        previous_count = lod_indices.size();
+        previous_error = lod.error;
+    }
+
+    return primitive.lods.size();
+}
+
+// Ritter's bounding sphere : the span between two far apart points, grown until every point is inside
+static void computeMeshletSphere(Meshlet& meshlet, const Vertices& vertices, const uint32_t* meshlet_vertices) {
+    auto farthest_from = [&](const glm::vec3& point) {
+        glm::vec3 result   = point;
+        float     distance = -1.0F;
+        for (uint32_t i = 0; i < meshlet.vertex_count; i++) {
+            const glm::vec3& position = vertices[meshlet_vertices[i]].position;
+            float            d        = glm::dot(position - point, position - point);
+            if (d > distance) {
+                distance = d;
+                result   = position;
+            }
+        }
+        return result;
+    };
+
+    glm::vec3 a      = farthest_from(vertices[meshlet_vertices[0]].position);
+    glm::vec3 b      = farthest_from(a);
+    glm::vec3 center = (a + b) * 0.5F;
+    float     radius = glm::length(b - a) * 0.5F;
+
+    for (uint32_t i = 0; i < meshlet.vertex_count; i++) {
+        const glm::vec3& position = vertices[meshlet_vertices[i]].position;
+        float            distance = glm::length(position - center);
+        if (distance > radius) {
+            float grown = (radius + distance) * 0.5F;
+            center += (position - center) * ((grown - radius) / distance);
+            radius = grown;
+        }
+    }
+
+    meshlet.center = center;
+    meshlet.radius = radius;
+}
+
+// normal cone, the same construction as meshoptimizer's meshopt_computeClusterBounds
+static void computeMeshletCone(Meshlet& meshlet, const Vertices& vertices, const uint32_t* meshlet_vertices, const uint8_t* meshlet_triangles) {
+    std::vector<glm::vec3> normals(meshlet.triangle_count);
+    glm::vec3              axis{ 0.0F };
+
+    for (uint32_t t = 0; t < meshlet.triangle_count; t++) {
+        glm::vec3 p0 = vertices[meshlet_vertices[meshlet_triangles[(t * 3) + 0]]].position;
+        glm::vec3 p1 = vertices[meshlet_vertices[meshlet_triangles[(t * 3) + 1]]].position;
+        glm::vec3 p2 = vertices[meshlet_vertices[meshlet_triangles[(t * 3) + 2]]].position;
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float     length = glm::length(normal);
+        normals[t]       = length > 0.0F ? normal / length : glm::vec3(0.0F); // degenerate triangles do not constrain the cone
+        axis += normals[t];
+    }
+
+    meshlet.cone_apex   = meshlet.center;
+    meshlet.cone_axis   = glm::vec3(0.0F, 0.0F, 1.0F);
+    meshlet.cone_cutoff = 1.0F;
+
+    float axis_length = glm::length(axis);
+    if (axis_length == 0.0F) {
+        return;
+    }
+    axis /= axis_length;
+
+    float min_dot = 1.0F;
+    for (const glm::vec3& normal : normals) {
+        if (normal != glm::vec3(0.0F)) {
+            min_dot = std::min(min_dot, glm::dot(normal, axis));
+        }
+    }
+    meshlet.cone_axis = axis;
+
+    if (min_dot <= 0.1F) { // the cone spans ( almost ) a hemisphere, some triangle always faces the camera
+        return;
+    }
+
+    // the apex goes back along the axis until every triangle plane is in front of it
+    float max_t = 0.0F;
+    for (uint32_t t = 0; t < meshlet.triangle_count; t++) {
+        if (normals[t] == glm::vec3(0.0F)) {
+            continue;
+        }
+        glm::vec3 p0 = vertices[meshlet_vertices[meshlet_triangles[t * 3]]].position;
+        float     dc = glm::dot(meshlet.center - p0, normals[t]);
+        float     dn = glm::dot(axis, normals[t]);
+        max_t        = std::max(max_t, dc / dn); // dn >= min_dot > 0
+    }
+
+    meshlet.cone_apex   = meshlet.center - (axis * max_t);
+    meshlet.cone_cutoff = std::sqrt(1.0F - (min_dot * min_dot));
+}
+
+size_t PrimitiveOptimizer::buildMeshlets(Primitive& primitive) {
+    primitive.meshlets.clear();
+    primitive.meshlet_vertices.clear();
+    primitive.meshlet_triangles.clear();
+
+    if (primitive.mode != RenderMode::TRIANGLES || primitive.vertices.empty()) {
+        return 0;
+    }
+
+    std::vector<uint32_t> indices = readIndices(primitive);
+    std::vector<uint8_t>  local(primitive.vertices.size(), UINT8_MAX); // meshlet-local index of a vertex in the open meshlet
+    Meshlet               meshlet{};
+
+    auto finish = [&]() {
+        if (meshlet.triangle_count == 0) {
+            return;
+        }
+        for (uint32_t i = 0; i < meshlet.vertex_count; i++) {
+            local[primitive.meshlet_vertices[meshlet.vertex_offset + i]] = UINT8_MAX;
+        }
+
+        const uint32_t* meshlet_vertices  = &primitive.meshlet_vertices[meshlet.vertex_offset];
+        const uint8_t*  meshlet_triangles = &primitive.meshlet_triangles[static_cast<size_t>(meshlet.triangle_offset) * 3];
+        computeMeshletSphere(meshlet, primitive.vertices, meshlet_vertices);
+        computeMeshletCone(meshlet, primitive.vertices, meshlet_vertices, meshlet_triangles);
+
+        primitive.meshlets.push_back(meshlet);
+
+        meshlet                 = Meshlet{};
+        meshlet.vertex_offset   = static_cast<uint32_t>(primitive.meshlet_vertices.size());
+        meshlet.triangle_offset = static_cast<uint32_t>(primitive.meshlet_triangles.size() / 3);
+    };
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const uint32_t* triangle = &indices[i];
+
+        uint32_t new_vertices = (local[triangle[0]] == UINT8_MAX ? 1 : 0) +
+                                (local[triangle[1]] == UINT8_MAX && triangle[1] != triangle[0] ? 1 : 0) +
+                                (local[triangle[2]] == UINT8_MAX && triangle[2] != triangle[0] && triangle[2] != triangle[1] ? 1 : 0);
+
+        if (meshlet.vertex_count + new_vertices > Meshlet::MAX_VERTICES || meshlet.triangle_count + 1 > Meshlet::MAX_TRIANGLES) {
+            finish();
+        }
+
+        for (size_t c = 0; c < 3; c++) {
+            uint8_t& local_index = local[triangle[c]];
+            if (local_index == UINT8_MAX) {
+                local_index = static_cast<uint8_t>(meshlet.vertex_count++);
+                primitive.meshlet_vertices.push_back(triangle[c]);
+            }
+            primitive.meshlet_triangles.push_back(local_index);
+        }
+        meshlet.triangle_count++;
+    }
+    finish();
+
+    return primitive.meshlets.size();
+}
+
+bool PrimitiveOptimizer::compactVertices(Primitive& primitive) {
+    const Vertices& vertices = primitive.vertices;
+    if (vertices.empty()) {
+        return false;
+    }
+
+    glm::vec3 minimum = vertices[0].position;
+    glm::vec3 maximum = vertices[0].position;
+    for (const Vertex& vertex : vertices) {
+        if (glm::any(glm::greaterThan(vertex.joints, glm::u16vec4(UINT8_MAX)))) {
+            return false;
+        }
+        minimum = glm::min(minimum, vertex.position);
+        maximum = glm::max(maximum, vertex.position);
+    }
+
+    glm::vec3 scale   = maximum - minimum;
+    glm::vec3 inverse = glm::vec3(0.0F); // flat axes quantize to 0
+    for (int axis = 0; axis < 3; axis++) {
+        if (scale[axis] > 0.0F) {
+            inverse[axis] = static_cast<float>(UINT16_MAX) / scale[axis];
+        }
+    }
+
+    CompactVertices compact(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const Vertex&  vertex = vertices[i];
+        CompactVertex& out    = compact[i];
+
+        glm::vec3 position = glm::clamp(glm::round((vertex.position - minimum) * inverse), 0.0F, static_cast<float>(UINT16_MAX));
+        out.position       = glm::u16vec4(glm::u16vec3(position), vertex.tangent.w < 0.0F ? 0 : UINT16_MAX);
+        out.normal         = encodeOctahedral(vertex.normal);
+        out.tangent        = encodeOctahedral(glm::vec3(vertex.tangent));
+        out.texture_coord  = { glm::packHalf1x16(vertex.texture_coord.x), glm::packHalf1x16(vertex.texture_coord.y) };
+        out.joints         = glm::u8vec4(vertex.joints);
+        out.weights        = encodeWeights(vertex.weights);
+    }
+
+    primitive.compact_vertices = std::move(compact);
+    primitive.position_offset  = minimum;
+    primitive.position_scale   = scale;
+    primitive.compact          = true;
+    primitive.vertices         = Vertices{}; // frees the memory, clear() would keep it
+
+    return true;
+}
+
+Vertex PrimitiveOptimizer::decodeCompactVertex(const CompactVertex& vertex, const glm::vec3& position_offset, const glm::vec3& position_scale) {
+    Vertex out{};
+    out.position      = position_offset + (glm::vec3(glm::u16vec3(vertex.position)) / static_cast<float>(UINT16_MAX) * position_scale);
+    out.normal        = decodeOctahedral(vertex.normal);
+    out.texture_coord = { glm::unpackHalf1x16(vertex.texture_coord.x), glm::unpackHalf1x16(vertex.texture_coord.y) };
+    out.joints        = glm::u16vec4(vertex.joints);
+    out.weights       = glm::vec4(vertex.weights) / 255.0F;
+    out.tangent       = glm::vec4(decodeOctahedral(vertex.tangent), vertex.position.w == 0 ? -1.0F : 1.0F);
+    return out;
+}
+
+VertexCacheStatistics PrimitiveOptimizer::analyzeVertexCache(const Primitive& primitive, size_t cache_size) {
+    VertexCacheStatistics statistics{};
+    if (primitive.mode != RenderMode::TRIANGLES) {
+        return statistics;
+    }
+
+    VertexCacheSimulator cache(primitive.vertices.size(), cache_size);
+    std::vector<bool>    used(primitive.vertices.size(), false);
+
+    std::visit([&](const auto& indices) {
+        statistics.triangles = indices.size() / 3;
+        for (size_t i = 0; i < statistics.triangles * 3; i++) {
+            uint32_t index = indices[i];
+            if (index >= used.size()) {
+                throw std::runtime_error("Index is out of the vertex range");
+            }
+            statistics.vertices_transformed += cache.access(index) ? 1 : 0;
+            if (!used[index]) {
+                used[index] = true;
+                statistics.vertices++;
+            }
+        }
+    },
+               primitive.indices);
+
+    if (statistics.triangles > 0) {
+        statistics.acmr = static_cast<float>(statistics.vertices_transformed) / static_cast<float>(statistics.triangles);
+        statistics.atvr = static_cast<float>(statistics.vertices_transformed) / static_cast<float>(statistics.vertices);
+    }
+    return statistics;
+}
+
+size_t PrimitiveOptimizer::getMaxIndex(RenderIndexType index_type) {
+    // the all-ones value is kept free for primitive restart
+    switch (index_type) {
+        case RenderIndexType::UNSIGNED_BYTE:
+            return UINT8_MAX - 1;
+        case RenderIndexType::UNSIGNED_SHORT:
+            return UINT16_MAX - 1;
+        case RenderIndexType::UNSIGNED_INT:
+        default:
+            return UINT32_MAX - 1;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Model.hpp"
+
+// post-load passes over a loaded Primitive ( vertices + indices ), none of them changes what is drawn
+class PrimitiveOptimizer {
+public:
+    static constexpr size_t VERTEX_CACHE_SIZE  = 16;    // FIFO entries, conservative for current GPUs
+    static constexpr float  OVERDRAW_THRESHOLD = 1.05F; // ACMR a cluster may lose to overdraw ordering
+
+public:
+    // merges bit-identical vertices and remaps the indices. Vertices end up in first-use order,
+    // vertices no index refers to are dropped. Returns how many vertices were removed
+    static size_t weldVertices(Primitive& primitive);
+
+    // re-chooses the narrowest index type for the vertex count ( u32 -> u16 ... ) and converts the indices
+    static void compactIndices(Primitive& primitive);
+
+    // reorders the triangles for the post-transform vertex cache ( Tipsify ), LOD levels included. Triangle lists only
+    static void optimizeVertexCache(Primitive& primitive, size_t cache_size = VERTEX_CACHE_SIZE);
+
+    // Tipsify, then the clusters it produces are sorted front to back in a view-independent way
+    // threshold - how much worse than plain Tipsify the ACMR may get. Triangle lists only
+    static void optimizeOverdraw(Primitive& primitive, float threshold = OVERDRAW_THRESHOLD, size_t cache_size = VERTEX_CACHE_SIZE);
+
+    // renumbers the vertices in first-use order, so vertex fetch walks memory forward. Drops unreferenced vertices
+    static void optimizeVertexFetch(Primitive& primitive);
+
+    // bounding sphere of the vertices ( bounds_center / bounds_radius ), LOD selection measures against it
+    static void computeBounds(Primitive& primitive);
+
+    // fills lods with one MeshSimplifier level per ratio ( index count relative to the full level ), stops early once
+    // a level would exceed max_error ( relative to bounds_radius ) or barely differs from the one before. Triangle lists only
+    static size_t generateLods(Primitive& primitive, const std::vector<float>& ratios, float max_error);
+
+    // splits a triangle list into meshlets in index buffer order ( run the vertex cache pass first for tighter clusters )
+    // and computes their bounding spheres and normal cones. Returns the meshlet count
+    static size_t buildMeshlets(Primitive& primitive);
+
+    // moves the vertices into compact_vertices, positions are quantized against the primitive bounds
+    // false if the primitive does not fit CompactVertex ( a joint index above 255 ), it is left untouched then
+    static bool compactVertices(Primitive& primitive);
+
+    // back to the full format, for CPU-side users of a compact primitive
+    static Vertex decodeCompactVertex(const CompactVertex& vertex, const glm::vec3& position_offset, const glm::vec3& position_scale);
+
+    static VertexCacheStatistics analyzeVertexCache(const Primitive& primitive, size_t cache_size = VERTEX_CACHE_SIZE);
+
+    // largest vertex index index_type can address
+    static size_t getMaxIndex(RenderIndexType index_type);
+};
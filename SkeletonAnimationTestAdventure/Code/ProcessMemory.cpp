@@ -0,0 +1,65 @@
+#include "ProcessMemory.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <cstdio>
+#include <cstring>
+#endif
+
+#ifndef _WIN32
+// VmRSS / VmHWM line of /proc/self/status, in bytes
+static size_t readStatusBytes(const char* key) {
+    FILE* file = std::fopen("/proc/self/status", "r");
+    if (file == nullptr) {
+        return 0;
+    }
+
+    size_t result   = 0;
+    size_t key_size = std::strlen(key);
+    char   line[256];
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        if (std::strncmp(line, key, key_size) == 0 && line[key_size] == ':') {
+            unsigned long long kilobytes = 0;
+            if (std::sscanf(line + key_size + 1, "%llu", &kilobytes) == 1) {
+                result = static_cast<size_t>(kilobytes) * 1024;
+            }
+            break;
+        }
+    }
+    std::fclose(file);
+    return result;
+}
+#endif
+
+size_t ProcessMemory::getResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0) {
+        return 0;
+    }
+    return counters.WorkingSetSize;
+#else
+    return readStatusBytes("VmRSS");
+#endif
+}
+
+size_t ProcessMemory::getPeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    return readStatusBytes("VmHWM");
+#endif
+}
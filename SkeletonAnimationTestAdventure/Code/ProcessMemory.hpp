@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+
+// resident set size of this process ( working set on Windows ), in bytes. 0 where it cannot be read
+class ProcessMemory {
+public:
+    static size_t getResidentBytes();
+    static size_t getPeakResidentBytes(); // highest since the process started, never goes down
+};
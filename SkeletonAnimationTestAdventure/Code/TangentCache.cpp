@@ -0,0 +1,133 @@
+#include "TangentCache.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <print>
+#include <sstream>
+#include <thread>
+
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+
+static constexpr char TANGENT_CACHE_MAGIC[8] = { 'S', 'K', 'M', 'T', 'A', 'N', 'G', 'T' };
+
+// position, normal and texture_coord are the first 32 bytes of a Vertex, hashed as one block per vertex
+static constexpr size_t TANGENT_INPUT_SIZE = offsetof(Vertex, joints);
+static_assert(offsetof(Vertex, position) == 0 && offsetof(Vertex, normal) == 12 && offsetof(Vertex, texture_coord) == 24 && TANGENT_INPUT_SIZE == 32);
+
+struct TangentCacheHeader {
+    char     magic[8]{};
+    uint32_t format_version{};
+    uint32_t reserved{};
+    uint64_t key{};
+    uint64_t vertices_count{};
+    double   generation_ms{};
+};
+
+uint64_t TangentCache::computeKey(const Vertices& vertices, const Indices& indices) {
+    uint64_t hash = hashCombine(HASH_SEED, FORMAT_VERSION);
+
+    for (const Vertex& vertex : vertices) {
+        hash = hashBytes(&vertex, TANGENT_INPUT_SIZE, hash);
+    }
+
+    std::visit([&](const auto& values) {
+        using Index = typename std::decay_t<decltype(values)>::value_type;
+        hash        = hashCombine(hash, sizeof(Index));
+        hash        = hashCombine(hash, hashBytes(values.data(), values.size() * sizeof(Index)));
+    },
+               indices);
+
+    return hash;
+}
+
+std::filesystem::path TangentCache::getDefaultDirectory() {
+    std::error_code error{};
+    auto            temp = std::filesystem::temp_directory_path(error);
+    if (error) {
+        temp = std::filesystem::current_path();
+    }
+    return temp / "SkeletonAnimationTestAdventure" / "TangentCache";
+}
+
+std::filesystem::path TangentCache::getCachePath(uint64_t key) const {
+    char name[17]{};
+    std::to_chars(name, name + 16, key, 16);
+    return m_directory / (std::string(name) + ".skmtan");
+}
+
+bool TangentCache::Load(uint64_t key, Vertices& vertices, double& generation_ms) const {
+    MappedFile file{};
+    if (!file.Initialize(this->getCachePath(key))) {
+        return false;
+    }
+
+    TangentCacheHeader header{};
+    if (file.size() < sizeof(TangentCacheHeader)) {
+        return false;
+    }
+    memcpy(&header, file.data(), sizeof(TangentCacheHeader));
+
+    if (memcmp(header.magic, TANGENT_CACHE_MAGIC, sizeof(TANGENT_CACHE_MAGIC)) != 0 ||
+        header.format_version != FORMAT_VERSION ||
+        header.key != key ||
+        header.vertices_count != vertices.size() ||
+        file.size() != sizeof(TangentCacheHeader) + (vertices.size() * sizeof(glm::vec4))) {
+        return false;
+    }
+
+    const uint8_t* tangents = file.data() + sizeof(TangentCacheHeader);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        memcpy(&vertices[i].tangent, tangents + (i * sizeof(glm::vec4)), sizeof(glm::vec4));
+    }
+
+    generation_ms = header.generation_ms;
+    return true;
+}
+
+void TangentCache::Save(uint64_t key, const Vertices& vertices, double generation_ms) const {
+    TangentCacheHeader header{};
+    memcpy(header.magic, TANGENT_CACHE_MAGIC, sizeof(TANGENT_CACHE_MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.key            = key;
+    header.vertices_count = vertices.size();
+    header.generation_ms  = generation_ms;
+
+    std::vector<glm::vec4> tangents(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        tangents[i] = vertices[i].tangent;
+    }
+
+    std::filesystem::path path = this->getCachePath(key);
+
+    // primitives with the same geometry may be saved by several loader threads at once, each one writes its own temp file
+    std::ostringstream thread_id{};
+    thread_id << std::this_thread::get_id();
+    std::filesystem::path temp_path = path;
+    temp_path += "." + thread_id.str() + ".tmp";
+
+    try {
+        std::filesystem::create_directories(m_directory);
+
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Failed to open " + temp_path.string());
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(TangentCacheHeader));
+            file.write(reinterpret_cast<const char*>(tangents.data()), static_cast<std::streamsize>(tangents.size() * sizeof(glm::vec4)));
+            if (!file) {
+                throw std::runtime_error("Failed to write " + temp_path.string());
+            }
+        }
+
+        std::filesystem::rename(temp_path, path);
+    }
+    catch (const std::exception& e) {
+        std::println("WARNING : Failed to save tangent cache : {}", e.what());
+
+        std::error_code error{};
+        std::filesystem::remove(temp_path, error);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <filesystem>
+
+#include "VertexBuffers.hpp"
+
+// MikkTSpace output stored on disk per primitive
+// the key covers everything tangent generation reads : positions, normals, UVs and the indices,
+// so an entry can never be applied to different geometry
+class TangentCache {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1; // bump when the file layout or the generator changes
+
+public:
+    TangentCache() = default;
+    explicit TangentCache(std::filesystem::path directory) : m_directory(std::move(directory)) {}
+    ~TangentCache() = default;
+
+    static uint64_t computeKey(const Vertices& vertices, const Indices& indices);
+
+    // writes the cached tangents into vertices. generation_ms - what generating them cost when they were saved
+    bool Load(uint64_t key, Vertices& vertices, double& generation_ms) const;
+    void Save(uint64_t key, const Vertices& vertices, double generation_ms) const;
+
+    static std::filesystem::path getDefaultDirectory();
+
+    [[nodiscard]] std::filesystem::path getCachePath(uint64_t key) const;
+
+private:
+    std::filesystem::path m_directory{ TangentCache::getDefaultDirectory() };
+};
@@ -1,5 +1,10 @@
 #include "Texture.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <print>
+#include <utility>
+
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -63,19 +68,56 @@ void Texture::Create(const std::filesystem::path& path) {
     m_internalFormat = internal_format;
     m_dataFormat     = data_format;
 
-    size_t buffer_size = width * height * components;
-    m_bytes            = std::make_unique<unsigned char[]>(buffer_size);
-
-    // bytes are already checked that it is not nullptr
-    std::copy(bytes, bytes + buffer_size, m_bytes.get());
+    m_bytes = TextureBytes(bytes); // bytes are already checked that it is not nullptr
 }
 
 void Texture::Create(const tinygltf::Image& image, const tinygltf::Sampler& sampler, TextureColorSpace texture_color_space) {
-    int                  width      = image.width;
-    int                  height     = image.height;
-    int                  components = image.component; // number of color channels
-    const unsigned char* bytes      = image.image.data();
+    int          width      = image.width;
+    int          height     = image.height;
+    int          components = image.component; // number of color channels
+    TextureBytes bytes{};
+
+    if (image.as_is) { // still encoded, see storeEncodedImage()
+        bytes.reset(stbi_load_from_memory(image.image.data(), static_cast<int>(image.image.size()), &width, &height, &components, 4));
+        if (bytes == nullptr) {
+            std::println("ERROR : Failed to decode image : {}", image.name.empty() ? image.uri : image.name);
+            assert(false);
+            return;
+        }
+        components = 4; // same as the default tinygltf loader
+    }
+    else {
+        size_t buffer_size = static_cast<size_t>(width) * height * components;
+        if (image.image.empty() || buffer_size != image.image.size()) {
+            assert(false);
+            return;
+        }
+        bytes = Texture::allocateBytes(buffer_size);
+        std::copy(image.image.begin(), image.image.end(), bytes.get());
+    }
 
+    this->setPixels(width, height, components, std::move(bytes), sampler, texture_color_space);
+}
+
+void Texture::Create(tinygltf::Image&& image, const tinygltf::Sampler& sampler, TextureColorSpace texture_color_space) {
+    size_t buffer_size = static_cast<size_t>(image.width) * image.height * image.component;
+    if (!image.as_is && !image.image.empty() && buffer_size == image.image.size()) {
+        // already decoded : the texture takes the vector over instead of copying it
+        auto*        pixels = new std::vector<unsigned char>(std::move(image.image));
+        TextureBytes bytes(pixels->data(), TextureBytesDeleter{ pixels });
+        this->setPixels(image.width, image.height, image.component, std::move(bytes), sampler, texture_color_space);
+    }
+    else {
+        this->Create(std::as_const(image), sampler, texture_color_space);
+    }
+    std::vector<unsigned char>().swap(image.image); // encoded bytes are not needed after the decoding
+}
+
+void Texture::Create(unsigned int width, unsigned int height, unsigned int components, TextureBytes bytes, const tinygltf::Sampler& sampler, TextureColorSpace texture_color_space) {
+    this->setPixels(static_cast<int>(width), static_cast<int>(height), static_cast<int>(components), std::move(bytes), sampler, texture_color_space);
+}
+
+void Texture::setPixels(int width, int height, int components, TextureBytes bytes, const tinygltf::Sampler& sampler, TextureColorSpace texture_color_space) {
     int min_filter = sampler.minFilter;
     int mag_filter = sampler.magFilter;
 
@@ -196,14 +238,224 @@ void Texture::Create(const tinygltf::Image& image, const tinygltf::Sampler& samp
     m_components     = components;
     m_internalFormat = internal_format;
     m_dataFormat     = data_format;
+    m_bytes          = std::move(bytes);
+}
 
-    size_t buffer_size = image.width * image.height * image.component;
-    m_bytes            = std::make_unique<unsigned char[]>(buffer_size);
+void Texture::Create(unsigned int          width,
+                     unsigned int          height,
+                     unsigned int          components,
+                     TextureBytes          bytes,
+                     TextureInternalFormat internal_format,
+                     TextureDataFormat     data_format,
+                     TextureMinFilter      min_filter,
+                     TextureMagFilter      mag_filter,
+                     TextureWrap           wrap_s,
+                     TextureWrap           wrap_t,
+                     unsigned int          mip_levels) {
+    m_width          = width;
+    m_height         = height;
+    m_components     = components;
+    m_mipLevels      = mip_levels;
+    m_bytes          = std::move(bytes);
+    m_internalFormat = internal_format;
+    m_dataFormat     = data_format;
+    m_minFilter      = min_filter;
+    m_magFilter      = mag_filter;
+    m_wrapS          = wrap_s;
+    m_wrapT          = wrap_t;
+}
 
-    if (!image.image.empty() && buffer_size == image.image.size()) {
-        std::copy(image.image.begin(), image.image.end(), m_bytes.get());
+void Texture::generateMipmaps(const MipOptions& options) {
+    if (m_bytes == nullptr || m_mipLevels > 1 || this->isCompressed()) {
+        return;
     }
-    else {
-        assert(false);
+
+    unsigned int levels = MipGenerator::getLevelCount(m_width, m_height);
+    TextureBytes chain  = Texture::allocateBytes(MipGenerator::getChainSize(m_width, m_height, m_components, levels));
+    std::copy_n(m_bytes.get(), this->getMipSize(0), chain.get());
+    MipGenerator::generate(chain.get(), m_width, m_height, m_components, levels, options);
+
+    m_bytes     = std::move(chain);
+    m_mipLevels = levels;
+}
+
+TextureCompressionReport Texture::compress(BlockFormat format, bool parallel, bool psnr) {
+    TextureCompressionReport report{};
+    if (m_bytes == nullptr || this->isCompressed()) {
+        return report;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    size_t size = 0;
+    for (unsigned int level = 0; level < m_mipLevels; level++) {
+        size += TextureCompressor::getLevelSize(format, this->getMipWidth(level), this->getMipHeight(level));
+    }
+    TextureBytes blocks = Texture::allocateBytes(size);
+
+    size_t offset = 0;
+    for (unsigned int level = 0; level < m_mipLevels; level++) {
+        TextureCompressor::compress(blocks.get() + offset, this->getMipData(level), this->getMipWidth(level), this->getMipHeight(level), m_components, format, parallel);
+        offset += TextureCompressor::getLevelSize(format, this->getMipWidth(level), this->getMipHeight(level));
+    }
+
+    report.format           = format;
+    report.width            = m_width;
+    report.height           = m_height;
+    report.levels           = m_mipLevels;
+    report.source_bytes     = this->getByteSize();
+    report.compressed_bytes = size;
+    report.encode_ms        = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (psnr) {
+        report.psnr = TextureCompressor::getPsnr(m_bytes.get(), m_width, m_height, m_components, blocks.get(), format);
     }
+
+    bool srgb = m_internalFormat == TextureInternalFormat::SRGB8_ALPHA8 || m_internalFormat == TextureInternalFormat::SRGB8;
+    switch (format) {
+        case BlockFormat::BC1:
+            m_internalFormat = srgb ? TextureInternalFormat::BC1_SRGB : TextureInternalFormat::BC1;
+            break;
+        case BlockFormat::BC3:
+            m_internalFormat = srgb ? TextureInternalFormat::BC3_SRGB : TextureInternalFormat::BC3;
+            break;
+        case BlockFormat::BC4:
+            m_internalFormat = TextureInternalFormat::BC4;
+            break;
+        case BlockFormat::BC5:
+            m_internalFormat = TextureInternalFormat::BC5;
+            break;
+        case BlockFormat::BC7:
+            m_internalFormat = srgb ? TextureInternalFormat::BC7_SRGB : TextureInternalFormat::BC7;
+            break;
+    }
+    m_bytes = std::move(blocks);
+    return report;
+}
+
+std::optional<BlockFormat> Texture::getBlockFormat() const noexcept {
+    switch (m_internalFormat) {
+        case TextureInternalFormat::BC1:
+        case TextureInternalFormat::BC1_SRGB:
+            return BlockFormat::BC1;
+        case TextureInternalFormat::BC3:
+        case TextureInternalFormat::BC3_SRGB:
+            return BlockFormat::BC3;
+        case TextureInternalFormat::BC4:
+            return BlockFormat::BC4;
+        case TextureInternalFormat::BC5:
+            return BlockFormat::BC5;
+        case TextureInternalFormat::BC7:
+        case TextureInternalFormat::BC7_SRGB:
+            return BlockFormat::BC7;
+        default:
+            return std::nullopt;
+    }
+}
+
+size_t Texture::getMipSize(unsigned int level) const noexcept {
+    if (auto format = this->getBlockFormat()) {
+        return TextureCompressor::getLevelSize(*format, this->getMipWidth(level), this->getMipHeight(level));
+    }
+    return static_cast<size_t>(this->getMipWidth(level)) * this->getMipHeight(level) * m_components;
+}
+
+size_t Texture::getByteSize() const noexcept {
+    size_t size = 0;
+    for (unsigned int level = 0; level < m_mipLevels; level++) {
+        size += this->getMipSize(level);
+    }
+    return size;
+}
+
+const unsigned char* Texture::getMipData(unsigned int level) const noexcept {
+    if (m_bytes == nullptr) {
+        return nullptr;
+    }
+    size_t offset = 0;
+    for (unsigned int i = 0; i < level; i++) {
+        offset += this->getMipSize(i);
+    }
+    return m_bytes.get() + offset;
+}
+
+Texture Texture::createReduced(unsigned int max_size) const {
+    if (this->isCompressed()) {
+        return {}; // no texels to average, the placeholder stands in
+    }
+
+    unsigned int width      = m_width;
+    unsigned int height     = m_height;
+    size_t       components = m_components;
+    TextureBytes bytes      = Texture::allocateBytes(static_cast<size_t>(width) * height * components);
+    if (m_bytes != nullptr) {
+        std::copy_n(m_bytes.get(), static_cast<size_t>(width) * height * components, bytes.get());
+    }
+
+    // halve until it fits, an odd last row / column is averaged with itself
+    max_size = std::max(max_size, 1U);
+    while (m_bytes != nullptr && (width > max_size || height > max_size)) {
+        unsigned int half_width  = std::max(width / 2, 1U);
+        unsigned int half_height = std::max(height / 2, 1U);
+        TextureBytes half        = Texture::allocateBytes(static_cast<size_t>(half_width) * half_height * components);
+
+        for (unsigned int y = 0; y < half_height; y++) {
+            unsigned int y0 = std::min(y * 2, height - 1);
+            unsigned int y1 = std::min((y * 2) + 1, height - 1);
+            for (unsigned int x = 0; x < half_width; x++) {
+                unsigned int x0 = std::min(x * 2, width - 1);
+                unsigned int x1 = std::min((x * 2) + 1, width - 1);
+                for (size_t c = 0; c < components; c++) {
+                    unsigned int sum = bytes[((static_cast<size_t>(y0) * width + x0) * components) + c] +
+                                       bytes[((static_cast<size_t>(y0) * width + x1) * components) + c] +
+                                       bytes[((static_cast<size_t>(y1) * width + x0) * components) + c] +
+                                       bytes[((static_cast<size_t>(y1) * width + x1) * components) + c];
+                    half[((static_cast<size_t>(y) * half_width + x) * components) + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+
+        width  = half_width;
+        height = half_height;
+        bytes  = std::move(half);
+    }
+
+    Texture reduced{};
+    reduced.Create(width, height, m_components, std::move(bytes), m_internalFormat, m_dataFormat, m_minFilter, m_magFilter, m_wrapS, m_wrapT);
+    return reduced;
+}
+
+bool Texture::storeEncodedImage(tinygltf::Image*     image,
+                                int                  image_index,
+                                std::string*         error,
+                                std::string*         warning,
+                                int                  required_width,
+                                int                  required_height,
+                                const unsigned char* bytes,
+                                int                  size,
+                                void* /*unused*/) {
+    int width      = 0;
+    int height     = 0;
+    int components = 0;
+
+    // only the header is read here, it is cheap and catches broken images while parsing
+    if (stbi_info_from_memory(bytes, size, &width, &height, &components) == 0) {
+        *error += "Unknown image format for image[" + std::to_string(image_index) + "] name = \"" + image->name + "\"\n";
+        return false;
+    }
+    if ((required_width > 0 && required_width != width) || (required_height > 0 && required_height != height)) {
+        *error += "Image size mismatch for image[" + std::to_string(image_index) + "] name = \"" + image->name + "\"\n";
+        return false;
+    }
+    if (stbi_is_16_bit_from_memory(bytes, size) != 0 && warning != nullptr) {
+        *warning += "16-bit image[" + std::to_string(image_index) + "] is reduced to 8 bits per channel\n";
+    }
+
+    image->width      = width;
+    image->height     = height;
+    image->component  = 4; // what Create() decodes to
+    image->bits       = 8;
+    image->pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+    image->as_is      = true;
+    image->image.assign(bytes, bytes + size);
+    return true;
 }
@@ -1,11 +1,33 @@
 #pragma once
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <vector>
 
+#include "MipGenerator.hpp"
+#include "TextureCompressor.hpp"
 #include "stb_image.h"
 #include "tiny_gltf.h"
 #include <glad/glad.h>
 
+// pixels come straight from stb_image, so they are released the way stb allocated them ( malloc )
+// unless they are still owned by the vector they were moved out of ( Texture::Create with a tinygltf::Image&& )
+struct TextureBytesDeleter {
+    std::vector<unsigned char>* owner{ nullptr };
+
+    void operator()(unsigned char* bytes) const noexcept {
+        if (owner != nullptr) {
+            delete owner;
+        }
+        else {
+            stbi_image_free(bytes);
+        }
+    }
+};
+using TextureBytes = std::unique_ptr<unsigned char[], TextureBytesDeleter>;
+
 class Texture {
 public:
     enum class TextureColorSpace {
@@ -19,7 +41,15 @@ public:
         RG8,
         R8,
         SRGB8_ALPHA8,
-        SRGB8
+        SRGB8,
+        BC1, // block compressed ( TextureCompressor ), the data format is the one they were compressed from
+        BC1_SRGB,
+        BC3,
+        BC3_SRGB,
+        BC4,
+        BC5,
+        BC7,
+        BC7_SRGB
     };
 
     enum class TextureDataFormat {
@@ -54,18 +84,74 @@ public:
     ~Texture();
 
     void Create(const std::filesystem::path& path);
+    // decodes the image here if it was stored encoded by storeEncodedImage(), safe to call from worker threads
     void Create(const tinygltf::Image& image, const tinygltf::Sampler& sampler, TextureColorSpace texture_color_space);
+    // same, and frees the image's bytes : encoded ones once decoded, decoded ones are moved into the texture instead of copied
+    void Create(tinygltf::Image&& image, const tinygltf::Sampler& sampler, TextureColorSpace texture_color_space);
+    // takes decoded pixels with the sampler and formats of a glTF texture ( TexturePacker )
+    void Create(unsigned int width, unsigned int height, unsigned int components, TextureBytes bytes, const tinygltf::Sampler& sampler, TextureColorSpace texture_color_space);
+    // takes already decoded pixels ( model cache ), a whole mip chain when mip_levels > 1
+    void Create(unsigned int          width,
+                unsigned int          height,
+                unsigned int          components,
+                TextureBytes          bytes,
+                TextureInternalFormat internal_format,
+                TextureDataFormat     data_format,
+                TextureMinFilter      min_filter,
+                TextureMagFilter      mag_filter,
+                TextureWrap           wrap_s,
+                TextureWrap           wrap_t,
+                unsigned int          mip_levels = 1);
+
+    // tinygltf image loader callback : keeps the encoded bytes in image->image and marks the image as_is,
+    // so decoding can be moved out of the parser and run in parallel by Create()
+    static bool storeEncodedImage(tinygltf::Image*     image,
+                                  int                  image_index,
+                                  std::string*         error,
+                                  std::string*         warning,
+                                  int                  required_width,
+                                  int                  required_height,
+                                  const unsigned char* bytes,
+                                  int                  size,
+                                  void*                user_data);
+
+    static TextureBytes allocateBytes(size_t size) { return TextureBytes(static_cast<unsigned char*>(std::malloc(size))); }
+
+    // box-filtered copy whose longest side is at most max_size, same formats and sampler settings
+    // the texels are averaged as stored ( sRGB ones too ), good enough for a stand-in until the full texture arrives, empty for compressed textures
+    Texture createReduced(unsigned int max_size) const;
+
+    // replaces the pixels by the full mip chain, level 0 unchanged ( ModelLoadOptions::generate_mipmaps )
+    void generateMipmaps(const MipOptions& options);
+
+    // replaces every mip level by blocks of format, sRGB stays sRGB. psnr - measure level 0 against the pixels before the compression
+    TextureCompressionReport compress(BlockFormat format, bool parallel, bool psnr);
+
+    // drops the texels once the renderer uploaded them ( ModelLoadOptions::release_cpu_data ), the size and formats stay
+    void releaseBytes() noexcept { m_bytes.reset(); }
+
+    // set by TextureRegistry::Publish, the key is baked into the model cache so a cache hit finds the shared texture too
+    void setRegistryKey(uint64_t key) noexcept { m_registryKey = key; }
 
     inline unsigned int          getWidth() const noexcept { return m_width; }
     inline unsigned int          getHeight() const noexcept { return m_height; }
     inline unsigned int          getComponents() const noexcept { return m_components; }
     inline const unsigned char*  getBytes() const noexcept { return m_bytes.get(); }
+    inline unsigned int          getMipLevels() const noexcept { return m_mipLevels; } // 1 - only level 0, the renderer builds the rest
+    inline unsigned int          getMipWidth(unsigned int level) const noexcept { return MipGenerator::getLevelSize(m_width, level); }
+    inline unsigned int          getMipHeight(unsigned int level) const noexcept { return MipGenerator::getLevelSize(m_height, level); }
+    size_t                       getMipSize(unsigned int level) const noexcept; // bytes, blocks for the compressed formats
+    size_t                       getByteSize() const noexcept;                  // all levels
+    const unsigned char*         getMipData(unsigned int level) const noexcept;
+    std::optional<BlockFormat>   getBlockFormat() const noexcept; // empty - uncompressed
+    inline bool                  isCompressed() const noexcept { return this->getBlockFormat().has_value(); }
     inline TextureMinFilter      getMinFilter() const noexcept { return m_minFilter; }
     inline TextureMagFilter      getMagFilter() const noexcept { return m_magFilter; }
     inline TextureWrap           getWrapS() const noexcept { return m_wrapS; }
     inline TextureWrap           getWrapT() const noexcept { return m_wrapT; }
     inline TextureInternalFormat getInternalFormat() const noexcept { return m_internalFormat; }
     inline TextureDataFormat     getDataFormat() const noexcept { return m_dataFormat; }
+    inline uint64_t              getRegistryKey() const noexcept { return m_registryKey; } // 0 - not in the TextureRegistry
 
     Texture(const Texture&)            = delete;
     Texture& operator=(const Texture&) = delete;
@@ -74,10 +160,15 @@ public:
     Texture& operator=(Texture&&) noexcept = default;
 
 private:
-    unsigned int                     m_width{ 0 };
-    unsigned int                     m_height{ 0 };
-    unsigned int                     m_components{ 0 };
-    std::unique_ptr<unsigned char[]> m_bytes{};
+    void setPixels(int width, int height, int components, TextureBytes bytes, const tinygltf::Sampler& sampler, TextureColorSpace texture_color_space);
+
+private:
+    unsigned int m_width{ 0 };
+    unsigned int m_height{ 0 };
+    unsigned int m_components{ 0 };
+    unsigned int m_mipLevels{ 1 };
+    TextureBytes m_bytes{};
+    uint64_t     m_registryKey{ 0 };
 
     TextureMinFilter m_minFilter{ TextureMinFilter::LINEAR_MIPMAP_LINEAR };
     TextureMagFilter m_magFilter{ TextureMagFilter::LINEAR };
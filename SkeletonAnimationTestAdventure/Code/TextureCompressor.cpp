@@ -0,0 +1,709 @@
+#include "TextureCompressor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <vector>
+
+#include "MipGenerator.hpp"
+#include "ThreadPool.hpp"
+
+static constexpr size_t BLOCK_ROWS_PER_TASK = 8;
+
+// BC7 4-bit index weights, out of 64
+static constexpr std::array<int, 16> BC7_WEIGHTS = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+using Block = std::array<std::array<uint8_t, 4>, 16>; // 4x4 RGBA texels, row by row
+
+// little endian bit stream of a 128-bit block, bit 0 first
+class BlockBits {
+public:
+    explicit BlockBits(uint8_t* bytes)
+        : m_bytes(bytes) {}
+
+    void write(uint32_t value, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++, m_bit++) {
+            m_bytes[m_bit >> 3] |= static_cast<uint8_t>(((value >> i) & 1U) << (m_bit & 7U));
+        }
+    }
+    uint32_t read(uint32_t count) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < count; i++, m_bit++) {
+            value |= ((static_cast<uint32_t>(m_bytes[m_bit >> 3]) >> (m_bit & 7U)) & 1U) << i;
+        }
+        return value;
+    }
+
+private:
+    uint8_t* m_bytes{ nullptr };
+    uint32_t m_bit{ 0 };
+};
+
+static Block loadBlock(const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int components, unsigned int block_x, unsigned int block_y) {
+    Block block{};
+    for (unsigned int y = 0; y < 4; y++) {
+        unsigned int source_y = std::min((block_y * 4) + y, height - 1); // edge texels repeat past the border
+        for (unsigned int x = 0; x < 4; x++) {
+            unsigned int         source_x = std::min((block_x * 4) + x, width - 1);
+            const unsigned char* texel    = pixels + ((static_cast<size_t>(source_y) * width + source_x) * components);
+            auto&                target   = block[(y * 4) + x];
+
+            target[0] = texel[0];
+            target[1] = components >= 2 ? texel[1] : 0;
+            target[2] = components >= 3 ? texel[2] : 0;
+            target[3] = components == 4 ? texel[3] : 255;
+        }
+    }
+    return block;
+}
+
+// largest eigenvector of the covariance of the texels over the first channels, by power iteration
+template <size_t N>
+static std::array<float, N> getPrincipalAxis(const Block& block, const std::array<float, N>& mean) {
+    std::array<float, N * N> covariance{};
+    for (const auto& texel : block) {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                covariance[(i * N) + j] += (static_cast<float>(texel[i]) - mean[i]) * (static_cast<float>(texel[j]) - mean[j]);
+            }
+        }
+    }
+
+    std::array<float, N> axis{};
+    axis.fill(1.0F);
+    for (int iteration = 0; iteration < 8; iteration++) {
+        std::array<float, N> next{};
+        float                length = 0.0F;
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                next[i] += covariance[(i * N) + j] * axis[j];
+            }
+            length += next[i] * next[i];
+        }
+        if (length < 1e-12F) {
+            break; // flat block, any axis does
+        }
+        length = std::sqrt(length);
+        for (size_t i = 0; i < N; i++) {
+            axis[i] = next[i] / length;
+        }
+    }
+    return axis;
+}
+
+// the extreme texels of the block along its principal axis
+template <size_t N>
+static void getEndpoints(const Block& block, std::array<float, N>& low, std::array<float, N>& high) {
+    std::array<float, N> mean{};
+    for (const auto& texel : block) {
+        for (size_t i = 0; i < N; i++) {
+            mean[i] += static_cast<float>(texel[i]) / 16.0F;
+        }
+    }
+    std::array<float, N> axis = getPrincipalAxis<N>(block, mean);
+
+    float min_t = std::numeric_limits<float>::max();
+    float max_t = std::numeric_limits<float>::lowest();
+    for (const auto& texel : block) {
+        float t = 0.0F;
+        for (size_t i = 0; i < N; i++) {
+            t += (static_cast<float>(texel[i]) - mean[i]) * axis[i];
+        }
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+    for (size_t i = 0; i < N; i++) {
+        low[i]  = std::clamp(mean[i] + (axis[i] * min_t), 0.0F, 255.0F);
+        high[i] = std::clamp(mean[i] + (axis[i] * max_t), 0.0F, 255.0F);
+    }
+}
+
+// least squares endpoints for the given weights ( share of the high endpoint per texel ), false if they do not define a line
+template <size_t N>
+static bool solveEndpoints(const Block& block, const std::array<float, 16>& weights, std::array<float, N>& low, std::array<float, N>& high) {
+    float                aa = 0.0F;
+    float                bb = 0.0F;
+    float                ab = 0.0F;
+    std::array<float, N> ax{};
+    std::array<float, N> bx{};
+    for (size_t k = 0; k < 16; k++) {
+        float a = 1.0F - weights[k];
+        float b = weights[k];
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (size_t i = 0; i < N; i++) {
+            ax[i] += a * static_cast<float>(block[k][i]);
+            bx[i] += b * static_cast<float>(block[k][i]);
+        }
+    }
+
+    float determinant = (aa * bb) - (ab * ab);
+    if (std::abs(determinant) < 1e-6F) {
+        return false;
+    }
+    for (size_t i = 0; i < N; i++) {
+        low[i]  = std::clamp(((ax[i] * bb) - (bx[i] * ab)) / determinant, 0.0F, 255.0F);
+        high[i] = std::clamp(((bx[i] * aa) - (ax[i] * ab)) / determinant, 0.0F, 255.0F);
+    }
+    return true;
+}
+
+//
+// BC1 color
+//
+
+static uint16_t packColor565(const std::array<float, 3>& color) {
+    auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0F / 255.0F));
+    auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0F / 255.0F));
+    auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0F / 255.0F));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static std::array<int, 3> unpackColor565(uint16_t color) {
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+}
+
+// the 4-color palette, indices 2 and 3 a third and two thirds of the way to color1
+static std::array<std::array<int, 3>, 4> getColorPalette(uint16_t color0, uint16_t color1, bool four_colors) {
+    std::array<int, 3>                c0 = unpackColor565(color0);
+    std::array<int, 3>                c1 = unpackColor565(color1);
+    std::array<std::array<int, 3>, 4> palette{ c0, c1 };
+    for (size_t i = 0; i < 3; i++) {
+        palette[2][i] = four_colors ? ((2 * c0[i]) + c1[i]) / 3 : (c0[i] + c1[i]) / 2;
+        palette[3][i] = four_colors ? (c0[i] + (2 * c1[i])) / 3 : 0;
+    }
+    return palette;
+}
+
+static uint32_t fitColorIndices(const Block& block, uint16_t color0, uint16_t color1, std::array<uint8_t, 16>& indices) {
+    auto     palette = getColorPalette(color0, color1, true);
+    uint32_t error   = 0;
+    for (size_t k = 0; k < 16; k++) {
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        for (uint8_t i = 0; i < 4; i++) {
+            uint32_t distance = 0;
+            for (size_t c = 0; c < 3; c++) {
+                int d = static_cast<int>(block[k][c]) - palette[i][c];
+                distance += static_cast<uint32_t>(d * d);
+            }
+            if (distance < best) {
+                best       = distance;
+                indices[k] = i;
+            }
+        }
+        error += best;
+    }
+    return error;
+}
+
+// always 4-color mode ( color0 > color1 ), also the color half of BC3
+static void encodeColorBlock(uint8_t* out, const Block& block) {
+    static constexpr std::array<float, 4> INDEX_WEIGHTS = { 0.0F, 1.0F, 1.0F / 3.0F, 2.0F / 3.0F };
+
+    std::array<float, 3> low{};
+    std::array<float, 3> high{};
+    getEndpoints<3>(block, low, high);
+
+    uint16_t                color0 = packColor565(high);
+    uint16_t                color1 = packColor565(low);
+    std::array<uint8_t, 16> indices{};
+    uint32_t                error = fitColorIndices(block, color0, color1, indices);
+
+    for (int iteration = 0; iteration < 2 && error > 0; iteration++) {
+        std::array<float, 16> weights{};
+        for (size_t k = 0; k < 16; k++) {
+            weights[k] = INDEX_WEIGHTS[indices[k]];
+        }
+        if (!solveEndpoints<3>(block, weights, high, low)) {
+            break;
+        }
+
+        uint16_t                refined0 = packColor565(high);
+        uint16_t                refined1 = packColor565(low);
+        std::array<uint8_t, 16> refined_indices{};
+        uint32_t                refined_error = fitColorIndices(block, refined0, refined1, refined_indices);
+        if (refined_error >= error) {
+            break;
+        }
+        color0  = refined0;
+        color1  = refined1;
+        indices = refined_indices;
+        error   = refined_error;
+    }
+
+    if (color0 < color1) { // keep the 4-color mode : swapped endpoints, index 0 <-> 1 and 2 <-> 3
+        std::swap(color0, color1);
+        for (auto& index : indices) {
+            index ^= 1U;
+        }
+    }
+    if (color0 == color1) {
+        indices.fill(0);
+    }
+
+    uint32_t bits = 0;
+    for (size_t k = 0; k < 16; k++) {
+        bits |= static_cast<uint32_t>(indices[k]) << (k * 2);
+    }
+    std::memcpy(out, &color0, 2);
+    std::memcpy(out + 2, &color1, 2);
+    std::memcpy(out + 4, &bits, 4);
+}
+
+static void decodeColorBlock(Block& block, const uint8_t* in, bool always_four_colors) {
+    uint16_t color0 = 0;
+    uint16_t color1 = 0;
+    uint32_t bits   = 0;
+    std::memcpy(&color0, in, 2);
+    std::memcpy(&color1, in + 2, 2);
+    std::memcpy(&bits, in + 4, 4);
+
+    bool four_colors = always_four_colors || color0 > color1;
+    auto palette     = getColorPalette(color0, color1, four_colors);
+    for (size_t k = 0; k < 16; k++) {
+        uint32_t index = (bits >> (k * 2)) & 3U;
+        for (size_t c = 0; c < 3; c++) {
+            block[k][c] = static_cast<uint8_t>(palette[index][c]);
+        }
+        block[k][3] = !four_colors && index == 3 ? 0 : 255;
+    }
+}
+
+//
+// BC4 single channel, also the alpha of BC3 and both halves of BC5
+//
+
+static std::array<int, 8> getValuePalette(int value0, int value1) {
+    std::array<int, 8> palette{ value0, value1 };
+    if (value0 > value1) { // 8 values
+        for (int i = 1; i < 7; i++) {
+            palette[i + 1] = (((7 - i) * value0) + (i * value1) + 3) / 7;
+        }
+    }
+    else { // 6 values, then 0 and 255
+        for (int i = 1; i < 5; i++) {
+            palette[i + 1] = (((5 - i) * value0) + (i * value1) + 2) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    return palette;
+}
+
+static uint32_t fitValueIndices(const std::array<uint8_t, 16>& values, int value0, int value1, std::array<uint8_t, 16>& indices) {
+    auto     palette = getValuePalette(value0, value1);
+    uint32_t error   = 0;
+    for (size_t k = 0; k < 16; k++) {
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        for (uint8_t i = 0; i < 8; i++) {
+            int      d        = static_cast<int>(values[k]) - palette[i];
+            uint32_t distance = static_cast<uint32_t>(d * d);
+            if (distance < best) {
+                best       = distance;
+                indices[k] = i;
+            }
+        }
+        error += best;
+    }
+    return error;
+}
+
+static void encodeValueBlock(uint8_t* out, const Block& block, size_t channel) {
+    std::array<uint8_t, 16> values{};
+    for (size_t k = 0; k < 16; k++) {
+        values[k] = block[k][channel];
+    }
+    auto [min_value, max_value] = std::ranges::minmax(values);
+
+    // 8 values between the extremes, or 6 between the extremes other than 0 and 255, which come for free
+    int inner_min = 255;
+    int inner_max = 0;
+    for (uint8_t value : values) {
+        if (value != 0 && value != 255) {
+            inner_min = std::min<int>(inner_min, value);
+            inner_max = std::max<int>(inner_max, value);
+        }
+    }
+    inner_min = std::min(inner_min, inner_max);
+
+    std::array<uint8_t, 16> indices{};
+    std::array<uint8_t, 16> inner_indices{};
+    int                     value0 = max_value;
+    int                     value1 = min_value;
+    uint32_t                error  = fitValueIndices(values, value0, value1, indices);
+    if (error > 0 && fitValueIndices(values, inner_min, inner_max, inner_indices) < error) {
+        value0  = inner_min;
+        value1  = inner_max;
+        indices = inner_indices;
+    }
+
+    uint64_t bits = 0;
+    for (size_t k = 0; k < 16; k++) {
+        bits |= static_cast<uint64_t>(indices[k]) << (k * 3);
+    }
+    out[0] = static_cast<uint8_t>(value0);
+    out[1] = static_cast<uint8_t>(value1);
+    std::memcpy(out + 2, &bits, 6); // little endian
+}
+
+static void decodeValueBlock(Block& block, const uint8_t* in, size_t channel) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, in + 2, 6);
+
+    auto palette = getValuePalette(in[0], in[1]);
+    for (size_t k = 0; k < 16; k++) {
+        block[k][channel] = static_cast<uint8_t>(palette[(bits >> (k * 3)) & 7U]);
+    }
+}
+
+//
+// BC7 mode 6 : RGBA 7.7.7.7 endpoints with a p-bit each, 4-bit indices
+//
+
+// 7 bits per channel and a shared lowest bit, picked for the smaller error
+static void quantizeBc7Endpoint(const std::array<float, 4>& endpoint, std::array<uint32_t, 4>& quantized, uint32_t& p_bit) {
+    float best_error = std::numeric_limits<float>::max();
+    for (uint32_t p = 0; p < 2; p++) {
+        std::array<uint32_t, 4> candidate{};
+        float                   error = 0.0F;
+        for (size_t c = 0; c < 4; c++) {
+            candidate[c] = static_cast<uint32_t>(std::clamp<long>(std::lround((endpoint[c] - static_cast<float>(p)) / 2.0F), 0, 127));
+            float d      = static_cast<float>((candidate[c] << 1) | p) - endpoint[c];
+            error += d * d;
+        }
+        if (error < best_error) {
+            best_error = error;
+            quantized  = candidate;
+            p_bit      = p;
+        }
+    }
+}
+
+static uint32_t fitBc7Indices(const Block& block, const std::array<int, 4>& endpoint0, const std::array<int, 4>& endpoint1, std::array<uint8_t, 16>& indices) {
+    std::array<float, 4> direction{};
+    float                length = 0.0F;
+    for (size_t c = 0; c < 4; c++) {
+        direction[c] = static_cast<float>(endpoint1[c] - endpoint0[c]);
+        length += direction[c] * direction[c];
+    }
+
+    uint32_t error = 0;
+    for (size_t k = 0; k < 16; k++) {
+        // the projection on the endpoint line gives the index, its neighbours catch the rounding of the weights
+        float t = 0.0F;
+        if (length > 0.0F) {
+            for (size_t c = 0; c < 4; c++) {
+                t += (static_cast<float>(block[k][c]) - static_cast<float>(endpoint0[c])) * direction[c];
+            }
+            t /= length;
+        }
+        int guess = std::clamp(static_cast<int>(std::lround(t * 15.0F)), 0, 15);
+
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        for (int i = std::max(guess - 1, 0); i <= std::min(guess + 1, 15); i++) {
+            uint32_t distance = 0;
+            for (size_t c = 0; c < 4; c++) {
+                int value = (((64 - BC7_WEIGHTS[i]) * endpoint0[c]) + (BC7_WEIGHTS[i] * endpoint1[c]) + 32) >> 6;
+                int d     = static_cast<int>(block[k][c]) - value;
+                distance += static_cast<uint32_t>(d * d);
+            }
+            if (distance < best) {
+                best       = distance;
+                indices[k] = static_cast<uint8_t>(i);
+            }
+        }
+        error += best;
+    }
+    return error;
+}
+
+static void encodeBc7Block(uint8_t* out, const Block& block) {
+    std::array<float, 4> low{};
+    std::array<float, 4> high{};
+    getEndpoints<4>(block, low, high);
+
+    std::array<uint32_t, 4> best_quantized0{};
+    std::array<uint32_t, 4> best_quantized1{};
+    uint32_t                best_p0 = 0;
+    uint32_t                best_p1 = 0;
+    std::array<uint8_t, 16> best_indices{};
+    uint32_t                best_error = std::numeric_limits<uint32_t>::max();
+
+    for (int iteration = 0; iteration < 3; iteration++) {
+        std::array<uint32_t, 4> quantized0{};
+        std::array<uint32_t, 4> quantized1{};
+        uint32_t                p0 = 0;
+        uint32_t                p1 = 0;
+        quantizeBc7Endpoint(low, quantized0, p0);
+        quantizeBc7Endpoint(high, quantized1, p1);
+
+        std::array<int, 4> endpoint0{};
+        std::array<int, 4> endpoint1{};
+        for (size_t c = 0; c < 4; c++) {
+            endpoint0[c] = static_cast<int>((quantized0[c] << 1) | p0);
+            endpoint1[c] = static_cast<int>((quantized1[c] << 1) | p1);
+        }
+
+        std::array<uint8_t, 16> indices{};
+        uint32_t                error = fitBc7Indices(block, endpoint0, endpoint1, indices);
+        if (error >= best_error) {
+            break;
+        }
+        best_quantized0 = quantized0;
+        best_quantized1 = quantized1;
+        best_p0         = p0;
+        best_p1         = p1;
+        best_indices    = indices;
+        best_error      = error;
+
+        std::array<float, 16> weights{};
+        for (size_t k = 0; k < 16; k++) {
+            weights[k] = static_cast<float>(BC7_WEIGHTS[indices[k]]) / 64.0F;
+        }
+        if (error == 0 || !solveEndpoints<4>(block, weights, low, high)) {
+            break;
+        }
+    }
+
+    if (best_indices[0] >= 8) { // the top bit of the first index is implied 0 : swap the endpoints and mirror the indices
+        std::swap(best_quantized0, best_quantized1);
+        std::swap(best_p0, best_p1);
+        for (auto& index : best_indices) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    std::memset(out, 0, 16);
+    BlockBits bits(out);
+    bits.write(1U << 6, 7); // mode 6
+    for (size_t c = 0; c < 4; c++) {
+        bits.write(best_quantized0[c], 7);
+        bits.write(best_quantized1[c], 7);
+    }
+    bits.write(best_p0, 1);
+    bits.write(best_p1, 1);
+    for (size_t k = 0; k < 16; k++) {
+        bits.write(best_indices[k], k == 0 ? 3 : 4);
+    }
+}
+
+// other modes are not written by encodeBc7Block and decode to magenta
+static void decodeBc7Block(Block& block, const uint8_t* in) {
+    std::array<uint8_t, 16> bytes{};
+    std::memcpy(bytes.data(), in, 16);
+    BlockBits bits(bytes.data());
+
+    if (bits.read(7) != 1U << 6) {
+        for (auto& texel : block) {
+            texel = { 255, 0, 255, 255 };
+        }
+        return;
+    }
+
+    std::array<int, 4> endpoint0{};
+    std::array<int, 4> endpoint1{};
+    for (size_t c = 0; c < 4; c++) {
+        endpoint0[c] = static_cast<int>(bits.read(7) << 1);
+        endpoint1[c] = static_cast<int>(bits.read(7) << 1);
+    }
+    uint32_t p0 = bits.read(1);
+    uint32_t p1 = bits.read(1);
+    for (size_t c = 0; c < 4; c++) {
+        endpoint0[c] |= static_cast<int>(p0);
+        endpoint1[c] |= static_cast<int>(p1);
+    }
+
+    for (size_t k = 0; k < 16; k++) {
+        uint32_t index = bits.read(k == 0 ? 3 : 4);
+        for (size_t c = 0; c < 4; c++) {
+            block[k][c] = static_cast<uint8_t>((((64 - BC7_WEIGHTS[index]) * endpoint0[c]) + (BC7_WEIGHTS[index] * endpoint1[c]) + 32) >> 6);
+        }
+    }
+}
+
+size_t TextureCompressor::getBlockBytes(BlockFormat format) noexcept {
+    return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+}
+
+size_t TextureCompressor::getLevelSize(BlockFormat format, unsigned int width, unsigned int height) noexcept {
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * TextureCompressor::getBlockBytes(format);
+}
+
+const char* TextureCompressor::getName(BlockFormat format) noexcept {
+    switch (format) {
+        case BlockFormat::BC1:
+            return "BC1";
+        case BlockFormat::BC3:
+            return "BC3";
+        case BlockFormat::BC4:
+            return "BC4";
+        case BlockFormat::BC5:
+            return "BC5";
+        case BlockFormat::BC7:
+            return "BC7";
+    }
+    return "?";
+}
+
+void TextureCompressor::compress(unsigned char* blocks, const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int components, BlockFormat format, bool parallel) {
+    unsigned int blocks_x    = (width + 3) / 4;
+    unsigned int blocks_y    = (height + 3) / 4;
+    size_t       block_bytes = TextureCompressor::getBlockBytes(format);
+
+    auto rows_task = [&](size_t task) {
+        size_t first_row = task * BLOCK_ROWS_PER_TASK;
+        size_t last_row  = std::min<size_t>(first_row + BLOCK_ROWS_PER_TASK, blocks_y);
+        for (size_t y = first_row; y < last_row; y++) {
+            for (unsigned int x = 0; x < blocks_x; x++) {
+                Block    block = loadBlock(pixels, width, height, components, x, static_cast<unsigned int>(y));
+                uint8_t* out   = blocks + (((y * blocks_x) + x) * block_bytes);
+
+                switch (format) {
+                    case BlockFormat::BC1:
+                        encodeColorBlock(out, block);
+                        break;
+                    case BlockFormat::BC3:
+                        encodeValueBlock(out, block, 3);
+                        encodeColorBlock(out + 8, block);
+                        break;
+                    case BlockFormat::BC4:
+                        encodeValueBlock(out, block, 0);
+                        break;
+                    case BlockFormat::BC5:
+                        encodeValueBlock(out, block, 0);
+                        encodeValueBlock(out + 8, block, 1);
+                        break;
+                    case BlockFormat::BC7:
+                        encodeBc7Block(out, block);
+                        break;
+                }
+            }
+        }
+    };
+
+    size_t tasks = (blocks_y + BLOCK_ROWS_PER_TASK - 1) / BLOCK_ROWS_PER_TASK;
+    if (parallel && tasks > 1) {
+        ThreadPool::getGlobal().parallelFor(tasks, rows_task);
+    }
+    else {
+        for (size_t task = 0; task < tasks; task++) {
+            rows_task(task);
+        }
+    }
+}
+
+void TextureCompressor::decompress(unsigned char* pixels, const unsigned char* blocks, unsigned int width, unsigned int height, BlockFormat format) {
+    unsigned int blocks_x    = (width + 3) / 4;
+    unsigned int blocks_y    = (height + 3) / 4;
+    size_t       block_bytes = TextureCompressor::getBlockBytes(format);
+
+    for (unsigned int by = 0; by < blocks_y; by++) {
+        for (unsigned int bx = 0; bx < blocks_x; bx++) {
+            const uint8_t* in = blocks + ((static_cast<size_t>(by) * blocks_x + bx) * block_bytes);
+
+            Block block{};
+            for (auto& texel : block) {
+                texel = { 0, 0, 0, 255 };
+            }
+            switch (format) {
+                case BlockFormat::BC1:
+                    decodeColorBlock(block, in, false);
+                    break;
+                case BlockFormat::BC3:
+                    decodeColorBlock(block, in + 8, true);
+                    decodeValueBlock(block, in, 3);
+                    break;
+                case BlockFormat::BC4:
+                    decodeValueBlock(block, in, 0);
+                    break;
+                case BlockFormat::BC5:
+                    decodeValueBlock(block, in, 0);
+                    decodeValueBlock(block, in + 8, 1);
+                    break;
+                case BlockFormat::BC7:
+                    decodeBc7Block(block, in);
+                    break;
+            }
+
+            for (unsigned int y = 0; y < 4 && (by * 4) + y < height; y++) {
+                for (unsigned int x = 0; x < 4 && (bx * 4) + x < width; x++) {
+                    std::memcpy(pixels + ((static_cast<size_t>((by * 4) + y) * width + (bx * 4) + x) * 4), block[(y * 4) + x].data(), 4);
+                }
+            }
+        }
+    }
+}
+
+double TextureCompressor::getPsnr(const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int components, const unsigned char* blocks, BlockFormat format) {
+    std::vector<unsigned char> decoded(static_cast<size_t>(width) * height * 4);
+    TextureCompressor::decompress(decoded.data(), blocks, width, height, format);
+
+    size_t channels = 4;
+    switch (format) {
+        case BlockFormat::BC1:
+            channels = 3;
+            break;
+        case BlockFormat::BC4:
+            channels = 1;
+            break;
+        case BlockFormat::BC5:
+            channels = 2;
+            break;
+        default:
+            break;
+    }
+
+    double squared = 0.0;
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        const unsigned char* texel = pixels + (i * components);
+        for (size_t c = 0; c < channels; c++) {
+            int    source = c < components ? texel[c] : (c == 3 ? 255 : 0);
+            double d      = static_cast<double>(source - decoded[(i * 4) + c]);
+            squared += d * d;
+        }
+    }
+
+    double mse = squared / static_cast<double>(static_cast<size_t>(width) * height * channels);
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : std::numeric_limits<double>::infinity();
+}
+
+std::string TextureCompressor::getSummary(std::span<const TextureCompressionReport> reports) {
+    std::string summary = std::format("{:>7} {:>6} {:>11} {:>6} {:>9} {:>9} {:>10} {:>9} {:>8}\n", "texture", "format", "size", "levels", "MB in", "MB out", "ms", "Mtexel/s", "PSNR dB");
+
+    size_t source_bytes     = 0;
+    size_t compressed_bytes = 0;
+    double encode_ms        = 0.0;
+    for (const auto& report : reports) {
+        auto texels = static_cast<double>(MipGenerator::getChainSize(report.width, report.height, 1, report.levels));
+        summary += std::format("{:>7} {:>6} {:>11} {:>6} {:>9.2f} {:>9.2f} {:>10.2f} {:>9.2f} {:>8}\n",
+                               report.texture,
+                               TextureCompressor::getName(report.format),
+                               std::format("{}x{}", report.width, report.height),
+                               report.levels,
+                               static_cast<double>(report.source_bytes) / (1024.0 * 1024.0),
+                               static_cast<double>(report.compressed_bytes) / (1024.0 * 1024.0),
+                               report.encode_ms,
+                               texels / std::max(report.encode_ms * 1000.0, 1e-3),
+                               report.psnr > 0.0 ? std::format("{:.2f}", report.psnr) : std::string("-"));
+        source_bytes += report.source_bytes;
+        compressed_bytes += report.compressed_bytes;
+        encode_ms += report.encode_ms;
+    }
+    summary += std::format("{:>7} {:>6} {:>11} {:>6} {:>9.2f} {:>9.2f} {:>10.2f}\n",
+                           "total",
+                           "",
+                           "",
+                           "",
+                           static_cast<double>(source_bytes) / (1024.0 * 1024.0),
+                           static_cast<double>(compressed_bytes) / (1024.0 * 1024.0),
+                           encode_ms);
+    return summary;
+}
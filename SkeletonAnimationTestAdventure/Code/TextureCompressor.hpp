@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <string>
+
+// 4x4 texel blocks, all of them sampled directly by the GPU
+enum class BlockFormat {
+    BC1, // RGB, 8 bytes per block
+    BC3, // RGBA : BC4 alpha + BC1 color, 16 bytes
+    BC4, // R, 8 bytes ( occlusion, roughness )
+    BC5, // RG : two BC4, 16 bytes ( normal maps, z is rebuilt in the shader )
+    BC7, // RGBA, 16 bytes. Mode 6 only : one endpoint pair with 16 weights per block
+};
+
+// ModelLoadOptions::texture_compression, normal maps become BC5 and occlusion-only textures BC4 either way
+enum class TextureCompression {
+    NONE,
+    FAST,    // color as BC1, BC3 when a material blends or masks with its alpha
+    QUALITY, // color as BC7
+};
+
+// one compressed texture, for the load statistics and the summary table
+struct TextureCompressionReport {
+    size_t       texture{ 0 }; // index in the model
+    BlockFormat  format{ BlockFormat::BC7 };
+    unsigned int width{ 0 };
+    unsigned int height{ 0 };
+    unsigned int levels{ 0 };
+
+    size_t source_bytes{ 0 };     // every level, uncompressed
+    size_t compressed_bytes{ 0 }; // every level, compressed
+    double encode_ms{ 0 };
+    double psnr{ 0 }; // dB of level 0 over the channels the format keeps, infinite if lossless. 0 - not measured
+
+    TextureCompressionReport()  = default;
+    ~TextureCompressionReport() = default;
+};
+
+// CPU block compression encoder ( and a decoder for the quality numbers )
+class TextureCompressor {
+public:
+    static size_t      getBlockBytes(BlockFormat format) noexcept;
+    static size_t      getLevelSize(BlockFormat format, unsigned int width, unsigned int height) noexcept; // bytes of a width x height level
+    static const char* getName(BlockFormat format) noexcept;
+
+    // pixels : width x height texels of components ( 1 - 4 ) bytes, read the way GL samples RED / RG / RGB textures ( missing color 0, alpha 1 )
+    // blocks : getLevelSize() bytes. Rows of blocks on ThreadPool::getGlobal() when parallel
+    static void compress(unsigned char* blocks, const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int components, BlockFormat format, bool parallel);
+    // back to RGBA8, width x height x 4 bytes
+    static void decompress(unsigned char* pixels, const unsigned char* blocks, unsigned int width, unsigned int height, BlockFormat format);
+
+    // peak signal to noise ratio of the blocks against the pixels they were compressed from
+    static double getPsnr(const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int components, const unsigned char* blocks, BlockFormat format);
+
+    // one line per texture : format, size, MB before / after, encode time, Mtexel/s, PSNR
+    static std::string getSummary(std::span<const TextureCompressionReport> reports);
+};
@@ -0,0 +1,157 @@
+#include "TexturePacker.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+static constexpr std::string_view CHANNEL_SUFFIX = "@channels=";
+static constexpr std::string_view CHANNEL_NAMES  = "RGBA";
+
+bool TexturePacker::parseChannelSuffix(std::string_view uri, std::string& base, uint8_t& channels) {
+    size_t position = uri.rfind(CHANNEL_SUFFIX);
+    if (position == std::string_view::npos) {
+        return false;
+    }
+
+    std::string_view letters = uri.substr(position + CHANNEL_SUFFIX.size());
+    letters                  = letters.substr(0, letters.find('.')); // before the extension
+
+    channels = 0;
+    for (char letter : letters) {
+        size_t channel = CHANNEL_NAMES.find(letter);
+        if (channel == std::string_view::npos || (channels & (1U << channel)) != 0) {
+            return false;
+        }
+        channels |= static_cast<uint8_t>(1U << channel);
+    }
+    base = uri.substr(0, position);
+    return channels != 0;
+}
+
+TexturePackingPlan TexturePacker::createIdentityPlan(size_t texture_count) {
+    TexturePackingPlan plan{};
+    plan.texture_remap.resize(texture_count);
+    plan.sources.resize(texture_count);
+    for (size_t i = 0; i < texture_count; i++) {
+        PackedTextureSource source{};
+        source.texture        = static_cast<int>(i);
+        plan.texture_remap[i] = i;
+        plan.sources[i].push_back(source);
+    }
+    return plan;
+}
+
+TexturePackingPlan TexturePacker::createPlan(const tinygltf::Model& model) {
+    // sRGB color is never packed with linear data
+    std::vector<bool> color(model.textures.size(), false);
+    for (const auto& material : model.materials) {
+        for (int index : { material.pbrMetallicRoughness.baseColorTexture.index, material.emissiveTexture.index }) {
+            if (index >= 0 && static_cast<size_t>(index) < color.size()) {
+                color[index] = true;
+            }
+        }
+    }
+
+    struct Group {
+        size_t texture{ 0 }; // model texture
+        int    width{ 0 };
+        int    height{ 0 };
+        int    sampler{ -1 };
+    };
+
+    TexturePackingPlan                     plan{};
+    std::unordered_map<std::string, Group> groups{};
+    plan.texture_remap.resize(model.textures.size());
+
+    for (size_t i = 0; i < model.textures.size(); i++) {
+        const tinygltf::Texture& texture = model.textures[i];
+
+        std::string base{};
+        uint8_t     channels = 0;
+        bool        split    = false;
+        if (!color[i] && texture.source >= 0 && static_cast<size_t>(texture.source) < model.images.size()) {
+            const tinygltf::Image& image = model.images[texture.source];
+
+            std::string name{};
+            tinygltf::URIDecode(image.uri.empty() ? image.name : image.uri, &name, nullptr);
+            split = TexturePacker::parseChannelSuffix(name, base, channels);
+        }
+
+        auto group = split ? groups.find(base) : groups.end();
+        if (group != groups.end()) {
+            const tinygltf::Image& image   = model.images[texture.source];
+            auto&                  sources = plan.sources[group->second.texture];
+
+            // the same image again shares its slot, a different one has to fit the free channels and the size
+            auto same = std::ranges::find_if(sources, [&](const PackedTextureSource& source) { return model.textures[source.texture].source == texture.source; });
+            if (same != sources.end()) {
+                plan.texture_remap[i] = group->second.texture;
+                plan.merged++;
+                continue;
+            }
+
+            uint8_t used = 0;
+            for (const auto& source : sources) {
+                used |= source.channels;
+            }
+            if ((used & channels) == 0 && image.width == group->second.width && image.height == group->second.height && texture.sampler == group->second.sampler) {
+                sources.push_back({});
+                sources.back().texture  = static_cast<int>(i);
+                sources.back().channels = channels;
+                plan.texture_remap[i]   = group->second.texture;
+                plan.merged++;
+                continue;
+            }
+            split = false; // kept on its own
+        }
+
+        plan.texture_remap[i] = plan.sources.size();
+        auto& source          = plan.sources.emplace_back().emplace_back();
+        source.texture        = static_cast<int>(i);
+        if (split) {
+            const tinygltf::Image& image = model.images[texture.source];
+
+            source.channels = channels;
+            groups[base]    = Group{ plan.sources.size() - 1, image.width, image.height, texture.sampler };
+        }
+    }
+
+    // a lone part stays as it is
+    for (auto& sources : plan.sources) {
+        if (sources.size() == 1) {
+            sources[0].channels = 0;
+        }
+        std::ranges::sort(sources, {}, [](const PackedTextureSource& source) { return std::countr_zero(source.channels); });
+    }
+    return plan;
+}
+
+void TexturePacker::remapMaterials(std::vector<Material>& materials, const TexturePackingPlan& plan) {
+    auto remap = [&](int& index) {
+        if (index >= 0 && static_cast<size_t>(index) < plan.texture_remap.size()) {
+            index = static_cast<int>(plan.texture_remap[index]);
+        }
+    };
+
+    for (auto& material : materials) {
+        remap(material.pbr_metallic_roughness.base_color_texture.index);
+        remap(material.pbr_metallic_roughness.metallic_roughness_texture.index);
+        remap(material.normal_texture.index);
+        remap(material.occlusion_texture.index);
+        remap(material.emissive_texture.index);
+    }
+}
+
+void TexturePacker::pack(unsigned char* target, size_t texels, const unsigned char* source, unsigned int components, uint8_t channels) {
+    bool single = std::popcount(channels) == 1;
+    for (unsigned int channel = 0; channel < 4; channel++) {
+        if ((channels & (1U << channel)) == 0) {
+            continue;
+        }
+
+        unsigned int from = single || channel >= components ? 0 : channel;
+        for (size_t i = 0; i < texels; i++) {
+            target[(i * 4) + channel] = source[(i * components) + from];
+        }
+    }
+}
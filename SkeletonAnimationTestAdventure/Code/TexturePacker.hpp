@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Material.hpp"
+#include "tiny_gltf.h"
+
+// one glTF texture a model texture is made of
+struct PackedTextureSource {
+    int     texture{ -1 }; // glTF texture
+    uint8_t channels{ 0 }; // bit 0 - R ... bit 3 - A : the channels it fills. 0 - the texture as is, not packed
+
+    PackedTextureSource()  = default;
+    ~PackedTextureSource() = default;
+};
+
+// which glTF textures end up in which model texture ( ModelLoadOptions::pack_channels )
+struct TexturePackingPlan {
+    std::vector<size_t>                           texture_remap; // glTF texture -> model texture
+    std::vector<std::vector<PackedTextureSource>> sources;       // model texture -> its glTF textures, in channel order for the packed ones
+    size_t                                        merged{ 0 };   // glTF textures that no longer have their own model texture
+
+    TexturePackingPlan()  = default;
+    ~TexturePackingPlan() = default;
+};
+
+// channel-split exports ( "name_orm@channels=R.png", "name_orm@channels=G.png", ... ) are one ORM texture cut into
+// single-channel files. Packing them back gives one texture, one binding and a quarter of the texels per file
+class TexturePacker {
+public:
+    // base - uri before "@channels=", channels - the mask of the letters after it. False without a valid suffix
+    static bool parseChannelSuffix(std::string_view uri, std::string& base, uint8_t& channels);
+
+    // every glTF texture as is
+    static TexturePackingPlan createIdentityPlan(size_t texture_count);
+    // glTF textures whose images share a base and size are merged, the ones a material uses as color are left alone
+    static TexturePackingPlan createPlan(const tinygltf::Model& model);
+
+    // material texture indices from glTF to model textures
+    static void remapMaterials(std::vector<Material>& materials, const TexturePackingPlan& plan);
+
+    // RGBA8 texel rows of the packed texture. Single letter sources give their first channel, others their same-named ones,
+    // channels nobody fills are 255 ( a neutral factor for occlusion, roughness and metallic )
+    static void pack(unsigned char* target, size_t texels, const unsigned char* source, unsigned int components, uint8_t channels);
+};
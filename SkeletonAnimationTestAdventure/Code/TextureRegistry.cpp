@@ -0,0 +1,58 @@
+#include "TextureRegistry.hpp"
+
+std::shared_ptr<Texture> TextureRegistry::Find(uint64_t key) {
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Texture> texture = it->second.lock();
+    if (texture == nullptr) { // every asset using it is gone
+        m_entries.erase(it);
+        return nullptr;
+    }
+    m_hits++;
+    return texture;
+}
+
+std::shared_ptr<Texture> TextureRegistry::Publish(uint64_t key, std::shared_ptr<Texture> texture) {
+    std::lock_guard lock(m_mutex);
+
+    std::erase_if(m_entries, [](const auto& entry) { return entry.second.expired(); });
+    m_loads++;
+
+    std::weak_ptr<Texture>& entry = m_entries[key];
+    if (std::shared_ptr<Texture> published = entry.lock()) { // same content, decoded twice at the same time
+        return published;
+    }
+    texture->setRegistryKey(key);
+    entry = texture;
+    return texture;
+}
+
+void TextureRegistry::Clear() {
+    std::lock_guard lock(m_mutex);
+    m_entries.clear();
+}
+
+TextureRegistryStatistics TextureRegistry::getStatistics() const {
+    std::lock_guard lock(m_mutex);
+
+    TextureRegistryStatistics statistics{};
+    statistics.hits  = m_hits;
+    statistics.loads = m_loads;
+    for (const auto& [key, entry] : m_entries) {
+        if (std::shared_ptr<Texture> texture = entry.lock()) {
+            statistics.entries++;
+            statistics.bytes += texture->getBytes() != nullptr ? texture->getByteSize() : 0;
+        }
+    }
+    return statistics;
+}
+
+TextureRegistry& TextureRegistry::getGlobal() {
+    static TextureRegistry registry{};
+    return registry;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Texture.hpp"
+
+struct TextureRegistryStatistics {
+    size_t hits{ 0 };    // textures served from an entry, nothing decoded
+    size_t loads{ 0 };   // textures decoded and published
+    size_t entries{ 0 }; // entries whose texture is still in use
+    size_t bytes{ 0 };   // texels of those textures still on the CPU
+
+    TextureRegistryStatistics()  = default;
+    ~TextureRegistryStatistics() = default;
+};
+
+// Process-wide table of the textures loaded with ModelLoadOptions::share_textures, so every material and every model
+// pointing at the same image bytes shares one Texture, and the renderers one GPU copy of it
+// Entries are keyed by a hash of the image content, the sampler, the material roles and the options that change the texels.
+// The texture is held weakly, like AssetCache : it lives as long as an asset uses it
+class TextureRegistry {
+public:
+    TextureRegistry()  = default;
+    ~TextureRegistry() = default;
+
+    // nullptr if there is no live entry for the key. The texels of a published texture are never released ( Model::releaseUploadedData ),
+    // a loader may read them at any time, so Find() and ModelCache::Save() never race with the release
+    std::shared_ptr<Texture> Find(uint64_t key);
+    // makes the freshly loaded texture the entry of its key and returns it
+    // if another thread published the same key in the meantime, that entry's texture is returned and the given one dropped
+    std::shared_ptr<Texture> Publish(uint64_t key, std::shared_ptr<Texture> texture);
+
+    void Clear(); // forgets every entry, the assets keep their textures
+
+    [[nodiscard]] TextureRegistryStatistics getStatistics() const;
+
+    // process-wide registry, Model::loadTextures and ModelCache::Load use it
+    static TextureRegistry& getGlobal();
+
+    TextureRegistry(const TextureRegistry&)            = delete;
+    TextureRegistry& operator=(const TextureRegistry&) = delete;
+
+private:
+    mutable std::mutex                                   m_mutex;
+    std::unordered_map<uint64_t, std::weak_ptr<Texture>> m_entries;
+    size_t                                               m_hits{ 0 };
+    size_t                                               m_loads{ 0 };
+};
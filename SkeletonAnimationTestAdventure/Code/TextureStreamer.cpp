@@ -0,0 +1,208 @@
+#include "TextureStreamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void HeadlessTextureStreamBackend::setResidentLevels(const Texture& texture, unsigned int first_level, unsigned int previous_first_level) {
+    m_residentBytes += TextureStreamer::getLevelBytes(texture, first_level);
+    m_residentBytes -= TextureStreamer::getLevelBytes(texture, previous_first_level);
+    m_firstLevels[&texture] = first_level;
+    m_calls++;
+}
+
+void HeadlessTextureStreamBackend::releaseTexture(const Texture& texture) {
+    auto it = m_firstLevels.find(&texture);
+    if (it != m_firstLevels.end()) {
+        m_residentBytes -= TextureStreamer::getLevelBytes(texture, it->second);
+        m_firstLevels.erase(it);
+    }
+}
+
+unsigned int HeadlessTextureStreamBackend::getFirstLevel(const Texture& texture) const {
+    auto it = m_firstLevels.find(&texture);
+    return it != m_firstLevels.end() ? it->second : texture.getMipLevels();
+}
+
+TextureStreamer::TextureStreamer(ITextureStreamBackend& backend, const TextureStreamingOptions& options) : m_backend(backend), m_options(options) {
+}
+
+void TextureStreamer::addTexture(std::shared_ptr<const Texture> texture) {
+    if (texture == nullptr || m_entries.contains(texture.get())) {
+        return;
+    }
+
+    Entry& entry       = m_entries[texture.get()];
+    entry.texture      = std::move(texture);
+    entry.first_level  = entry.texture->getMipLevels();
+    entry.tail_level   = TextureStreamer::getTailLevel(*entry.texture, m_options.resident_size);
+    entry.wanted_level = entry.tail_level;
+    entry.last_used    = 0;
+
+    // the tail is tiny and drawn right away, it is neither limited per frame nor evicted
+    size_t bytes = TextureStreamer::getLevelBytes(*entry.texture, entry.tail_level);
+    m_backend.setResidentLevels(*entry.texture, entry.tail_level, entry.first_level);
+    entry.first_level = entry.tail_level;
+    m_residentBytes += bytes;
+    m_statistics.uploaded_bytes += bytes;
+    m_statistics.uploaded_levels += entry.texture->getMipLevels() - entry.tail_level;
+}
+
+void TextureStreamer::removeTexture(const Texture& texture) {
+    auto it = m_entries.find(&texture);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    m_residentBytes -= TextureStreamer::getLevelBytes(texture, it->second.first_level);
+    m_backend.releaseTexture(texture);
+    m_entries.erase(it);
+}
+
+void TextureStreamer::requestTexture(const Texture& texture, float screen_size) {
+    auto it = m_entries.find(&texture);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    Entry&       entry = it->second;
+    unsigned int level = TextureStreamer::getWantedLevel(texture, screen_size, m_options.lod_bias);
+    if (entry.last_used != m_frame) { // first request of the frame
+        entry.wanted_level = level;
+        entry.screen_size  = screen_size;
+        entry.last_used    = m_frame;
+    }
+    else {
+        entry.wanted_level = std::min(entry.wanted_level, level);
+        entry.screen_size  = std::max(entry.screen_size, screen_size);
+    }
+}
+
+void TextureStreamer::Update() {
+    std::unordered_map<Entry*, unsigned int> changed{}; // first level before this frame, the backend hears of every texture once
+
+    std::vector<Entry*> requested{};
+    std::vector<Entry*> victims{};
+    for (auto& [key, entry] : m_entries) {
+        bool used = entry.last_used == m_frame;
+        if (used && entry.wanted_level < entry.first_level) {
+            requested.push_back(&entry);
+        }
+        if (entry.first_level < (used ? std::min(entry.wanted_level, entry.tail_level) : entry.tail_level)) {
+            victims.push_back(&entry);
+        }
+    }
+
+    // the largest on screen are streamed first, the least recently used ( then the smallest ) are evicted first
+    std::ranges::sort(requested, [](const Entry* a, const Entry* b) { return a->screen_size > b->screen_size; });
+    std::ranges::sort(victims, [](const Entry* a, const Entry* b) { return a->last_used != b->last_used ? a->last_used < b->last_used : a->screen_size < b->screen_size; });
+
+    size_t victim = 0;
+    auto   evict  = [&](size_t bytes) {
+        while (m_residentBytes + bytes > m_options.budget_bytes && victim < victims.size()) {
+            Entry&       entry = *victims[victim];
+            unsigned int floor = entry.last_used == m_frame ? std::min(entry.wanted_level, entry.tail_level) : entry.tail_level;
+            if (entry.first_level >= floor) {
+                victim++;
+                continue;
+            }
+
+            changed.try_emplace(&entry, entry.first_level);
+            size_t level_bytes = entry.texture->getMipSize(entry.first_level);
+            m_residentBytes -= level_bytes;
+            m_statistics.evicted_bytes += level_bytes;
+            m_statistics.evicted_levels++;
+            entry.first_level++;
+        }
+        return m_residentBytes + bytes <= m_options.budget_bytes;
+    };
+
+    // one level per texture and pass : every requested texture gets sharper before any one gets its finest level
+    size_t uploaded = 0;
+    bool   full     = false; // the frame's upload limit is reached
+    bool   progress = true;
+    while (progress && !full) {
+        progress = false;
+        for (Entry* entry : requested) {
+            if (entry->first_level <= entry->wanted_level) {
+                continue;
+            }
+
+            unsigned int level = entry->first_level - 1;
+            size_t       bytes = entry->texture->getMipSize(level);
+            if (uploaded > 0 && uploaded + bytes > m_options.upload_bytes_per_frame) { // a level over the limit alone still goes, in a frame of its own
+                full = true;
+                break;
+            }
+            if (!evict(bytes)) {
+                continue; // the budget is full of what this frame draws, coarser levels of the others may still fit
+            }
+
+            changed.try_emplace(entry, entry->first_level);
+            entry->first_level = level;
+            m_residentBytes += bytes;
+            uploaded += bytes;
+            m_statistics.uploaded_levels++;
+            progress = true;
+        }
+    }
+
+    for (auto& [entry, previous] : changed) {
+        if (entry->first_level != previous) {
+            m_backend.setResidentLevels(*entry->texture, entry->first_level, previous);
+        }
+    }
+
+    m_statistics.frame_upload_bytes = uploaded;
+    m_statistics.peak_upload_bytes  = std::max(m_statistics.peak_upload_bytes, uploaded);
+    m_statistics.uploaded_bytes += uploaded;
+    m_statistics.frame = m_frame;
+    m_frame++;
+}
+
+unsigned int TextureStreamer::getFirstLevel(const Texture& texture) const {
+    auto it = m_entries.find(&texture);
+    return it != m_entries.end() ? it->second.first_level : texture.getMipLevels();
+}
+
+TextureResidencyStatistics TextureStreamer::getStatistics() const {
+    TextureResidencyStatistics statistics = m_statistics;
+    statistics.textures                   = m_entries.size();
+    statistics.resident_bytes             = m_residentBytes;
+    statistics.budget_bytes               = m_options.budget_bytes;
+
+    for (const auto& [key, entry] : m_entries) {
+        bool         used   = entry.last_used == m_statistics.frame;
+        unsigned int wanted = used ? std::min(entry.wanted_level, entry.tail_level) : entry.tail_level;
+
+        statistics.full_textures += entry.first_level == 0 ? 1 : 0;
+        statistics.wanted_textures += used && entry.first_level > entry.wanted_level ? 1 : 0;
+        statistics.tail_bytes += TextureStreamer::getLevelBytes(*entry.texture, entry.tail_level);
+        statistics.wanted_bytes += TextureStreamer::getLevelBytes(*entry.texture, wanted);
+    }
+    return statistics;
+}
+
+unsigned int TextureStreamer::getWantedLevel(const Texture& texture, float screen_size, float lod_bias) {
+    unsigned int size  = std::max(texture.getWidth(), texture.getHeight());
+    float        level = std::log2(static_cast<float>(size) / std::max(screen_size, 1.0F)) + lod_bias;
+    if (!(level > 0.0F)) { // NaN too
+        return 0;
+    }
+    return std::min(static_cast<unsigned int>(level), texture.getMipLevels() - 1);
+}
+
+unsigned int TextureStreamer::getTailLevel(const Texture& texture, unsigned int resident_size) {
+    unsigned int level = 0;
+    while (level + 1 < texture.getMipLevels() && std::max(texture.getMipWidth(level), texture.getMipHeight(level)) > resident_size) {
+        level++;
+    }
+    return level;
+}
+
+size_t TextureStreamer::getLevelBytes(const Texture& texture, unsigned int first_level) {
+    size_t bytes = 0;
+    for (unsigned int level = first_level; level < texture.getMipLevels(); level++) {
+        bytes += texture.getMipSize(level);
+    }
+    return bytes;
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.hpp"
+
+struct TextureStreamingOptions {
+    size_t       budget_bytes{ 512ULL * 1024 * 1024 };         // GPU bytes of the resident levels, the tails count but are never evicted
+    size_t       upload_bytes_per_frame{ 16ULL * 1024 * 1024 }; // a frame never uploads more, the finer levels arrive over the next frames
+    unsigned int resident_size{ 64 };                           // levels whose longest side is at most this are uploaded on registration and always stay
+    float        lod_bias{ 0.0F };                              // added to the wanted level : > 0 blurrier and cheaper, < 0 sharper
+
+    TextureStreamingOptions()  = default;
+    ~TextureStreamingOptions() = default;
+};
+
+struct TextureResidencyStatistics {
+    size_t frame{ 0 };
+    size_t textures{ 0 };        // registered
+    size_t full_textures{ 0 };   // with level 0 resident
+    size_t wanted_textures{ 0 }; // requested in the last frame and not resident at their wanted level yet
+
+    size_t resident_bytes{ 0 }; // every resident level
+    size_t tail_bytes{ 0 };     // of them, the levels that always stay
+    size_t wanted_bytes{ 0 };   // what the last frame's requests need, over budget_bytes the finest levels of the least recently used go first
+    size_t budget_bytes{ 0 };
+
+    size_t frame_upload_bytes{ 0 }; // uploaded by the last Update()
+    size_t peak_upload_bytes{ 0 };  // largest frame_upload_bytes so far
+    size_t uploaded_bytes{ 0 };     // since the streamer was created, the tails included
+    size_t evicted_bytes{ 0 };
+    size_t uploaded_levels{ 0 };
+    size_t evicted_levels{ 0 };
+
+    TextureResidencyStatistics()  = default;
+    ~TextureResidencyStatistics() = default;
+};
+
+// where the streamer puts the levels : the renderer, or a headless one that only keeps the numbers
+class ITextureStreamBackend {
+public:
+    virtual ~ITextureStreamBackend() = default;
+
+    // levels first_level .. the last one are to be resident, previous_first_level .. the last one are now
+    // previous_first_level == Texture::getMipLevels() - nothing is resident yet
+    virtual void setResidentLevels(const Texture& texture, unsigned int first_level, unsigned int previous_first_level) = 0;
+    // the texture is unregistered, its GPU copy goes away with its last user
+    virtual void releaseTexture(const Texture& texture) = 0;
+};
+
+// no GPU : counts what a renderer would upload, to run the decisions of big scenes without a window
+class HeadlessTextureStreamBackend : public ITextureStreamBackend {
+public:
+    HeadlessTextureStreamBackend()  = default;
+    ~HeadlessTextureStreamBackend() = default;
+
+    void setResidentLevels(const Texture& texture, unsigned int first_level, unsigned int previous_first_level) override;
+    void releaseTexture(const Texture& texture) override;
+
+    [[nodiscard]] unsigned int getFirstLevel(const Texture& texture) const; // Texture::getMipLevels() if nothing is resident
+    [[nodiscard]] size_t       getResidentBytes() const noexcept { return m_residentBytes; }
+    [[nodiscard]] size_t       getCalls() const noexcept { return m_calls; }
+
+private:
+    std::unordered_map<const Texture*, unsigned int> m_firstLevels;
+    size_t                                           m_residentBytes{ 0 };
+    size_t                                           m_calls{ 0 };
+};
+
+// mip residency of the registered textures, decided once per frame from the screen size they are drawn at
+// Registration uploads the small tail levels, Update() streams finer levels in for the textures requested since the
+// last frame, a few megabytes per frame, and evicts the finest levels of the least recently used ones to stay in budget
+// Only the CPU mip chains of ModelLoadOptions::generate_mipmaps can be streamed, a texture without one is resident as a whole
+//
+//  TextureStreamer streamer(backend, options);
+//  on upload : streamer.addTexture(texture);
+//  every frame : instance.requestTextures(streamer, lod_view); streamer.Update();
+class TextureStreamer {
+public:
+    explicit TextureStreamer(ITextureStreamBackend& backend, const TextureStreamingOptions& options = {});
+    ~TextureStreamer() = default;
+
+    // the streamer keeps the texture alive, its CPU levels are uploaded again after an eviction
+    void addTexture(std::shared_ptr<const Texture> texture);
+    void removeTexture(const Texture& texture);
+
+    // screen_size - pixels the texture is drawn across, the largest request of a frame wins
+    void requestTexture(const Texture& texture, float screen_size);
+    // evictions and uploads, once per frame after the requests
+    void Update();
+
+    void setOptions(const TextureStreamingOptions& options) noexcept { m_options = options; }
+
+    [[nodiscard]] bool                       isRegistered(const Texture& texture) const { return m_entries.contains(&texture); }
+    [[nodiscard]] unsigned int               getFirstLevel(const Texture& texture) const; // finest resident level, Texture::getMipLevels() if unknown
+    [[nodiscard]] TextureResidencyStatistics getStatistics() const;
+
+    inline const TextureStreamingOptions& getOptions() const noexcept { return m_options; }
+
+    // finest level worth sampling for a texture drawn across screen_size pixels : one texel per pixel, plus the bias
+    static unsigned int getWantedLevel(const Texture& texture, float screen_size, float lod_bias);
+    // first level whose longest side is at most resident_size, the last one if none is that small
+    static unsigned int getTailLevel(const Texture& texture, unsigned int resident_size);
+    // GPU bytes of the levels first_level .. the last one
+    static size_t getLevelBytes(const Texture& texture, unsigned int first_level);
+
+    TextureStreamer(const TextureStreamer&)            = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+private:
+    struct Entry {
+        std::shared_ptr<const Texture> texture;
+        unsigned int                   first_level{ 0 };  // finest resident level
+        unsigned int                   tail_level{ 0 };   // never evicted past it
+        unsigned int                   wanted_level{ 0 }; // finest level the requests of the frame asked for
+        float                          screen_size{ 0.0F };
+        size_t                         last_used{ 0 }; // frame of the last request
+
+        Entry()  = default;
+        ~Entry() = default;
+    };
+
+private:
+    ITextureStreamBackend&                    m_backend;
+    TextureStreamingOptions                   m_options;
+    std::unordered_map<const Texture*, Entry> m_entries;
+
+    size_t                     m_frame{ 1 };
+    size_t                     m_residentBytes{ 0 };
+    TextureResidencyStatistics m_statistics{};
+};
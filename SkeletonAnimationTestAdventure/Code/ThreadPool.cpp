@@ -0,0 +1,156 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <print>
+#include <stdexcept>
+
+void ThreadPool::Release() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+    m_tasks.clear();
+    m_stop = false;
+}
+
+void ThreadPool::Initialize(size_t thread_count) {
+    this->Release();
+
+    if (thread_count == 0) {
+        size_t hardware = std::thread::hardware_concurrency();
+        thread_count    = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    m_threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        m_threads.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    if (m_threads.empty()) { // not initialized, run inline
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.emplace_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& func) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || m_threads.empty()) {
+        for (size_t i = 0; i < count; i++) {
+            func(i);
+        }
+        return;
+    }
+
+    // helpers that start after the caller has drained the range just leave,
+    // so a parallelFor nested in a worker never waits for a queued helper that can't run
+    struct State {
+        std::atomic<size_t>     next{ 0 };
+        std::mutex              mutex;
+        std::condition_variable condition;
+        size_t                  active{ 0 };
+        bool                    closed{ false };
+        std::exception_ptr      exception;
+    };
+    auto state = std::make_shared<State>();
+
+    auto run = [state, count, &func]() {
+        size_t i{};
+        while ((i = state->next.fetch_add(1, std::memory_order_relaxed)) < count) {
+            try {
+                func(i);
+            }
+            catch (...) {
+                std::lock_guard lock(state->mutex);
+                if (!state->exception) {
+                    state->exception = std::current_exception();
+                }
+                state->next = count; // stop handing out work
+            }
+        }
+    };
+
+    size_t helpers = std::min(m_threads.size(), count - 1);
+    for (size_t h = 0; h < helpers; h++) {
+        this->Submit([state, run]() {
+            {
+                std::lock_guard lock(state->mutex);
+                if (state->closed) {
+                    return;
+                }
+                state->active++;
+            }
+
+            run();
+
+            {
+                std::lock_guard lock(state->mutex);
+                state->active--;
+            }
+            state->condition.notify_all();
+        });
+    }
+
+    run();
+
+    std::unique_lock lock(state->mutex);
+    state->closed = true;
+    state->condition.wait(lock, [&]() { return state->active == 0; });
+
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+}
+
+ThreadPool& ThreadPool::getGlobal() {
+    static ThreadPool     pool{};
+    static std::once_flag once{};
+    std::call_once(once, []() { pool.Initialize(); });
+    return pool;
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task{};
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+            if (m_stop && m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        // an exception leaving a thread's function terminates the process, the worker keeps serving the queue instead
+        try {
+            task();
+        }
+        catch (const std::exception& exception) {
+            std::println("ERROR : Thread pool task failed : {}", exception.what());
+        }
+        catch (...) {
+            std::println("ERROR : Thread pool task failed with an unknown exception");
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads fed from one FIFO queue
+class ThreadPool {
+public:
+    ThreadPool() = default;
+    ~ThreadPool() { this->Release(); }
+
+    void Release();
+    void Initialize(size_t thread_count = 0); // 0 - one worker per hardware thread minus the caller
+
+    // the task runs on a worker. It should handle its own errors, an exception it lets out is printed and dropped
+    void Submit(std::function<void()> task);
+
+    // runs func(0) .. func(count - 1) on the workers and the calling thread, returns when all are done
+    // the first exception thrown by func is rethrown here. Safe to call from inside a worker task
+    void parallelFor(size_t count, const std::function<void(size_t)>& func);
+
+    inline size_t getThreadCount() const noexcept { return m_threads.size(); }
+
+    // process-wide pool, initialized on first use
+    static ThreadPool& getGlobal();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    void workerLoop();
+
+private:
+    std::vector<std::thread>          m_threads;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex                        m_mutex;
+    std::condition_variable           m_condition;
+    bool                              m_stop{ false };
+};
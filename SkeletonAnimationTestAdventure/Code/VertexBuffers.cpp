@@ -5,9 +5,17 @@ VBO::~VBO() {
 }
 
 void VBO::Create(const std::vector<Vertex>& vertices) {
+    this->Create(vertices.data(), vertices.size() * sizeof(Vertex));
+}
+
+void VBO::Create(const std::vector<CompactVertex>& vertices) {
+    this->Create(vertices.data(), vertices.size() * sizeof(CompactVertex));
+}
+
+void VBO::Create(const void* data, size_t size) {
     glGenBuffers(1, &m_index);
     glBindBuffer(GL_ARRAY_BUFFER, m_index);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), data, GL_STATIC_DRAW);
 }
 
 void VBO::Bind() const {
@@ -22,9 +30,9 @@ void VAO::Create() {
     glGenVertexArrays(1, &m_index);
 }
 
-void VAO::LinkAttrib(VBO& vbo, GLuint layout, GLuint num_components, GLenum type, GLsizeiptr stride, void* offset) {
+void VAO::LinkAttrib(VBO& vbo, GLuint layout, GLuint num_components, GLenum type, GLsizeiptr stride, void* offset, GLboolean normalized) {
     vbo.Bind();
-    glVertexAttribPointer(layout, num_components, type, GL_FALSE, stride, offset);
+    glVertexAttribPointer(layout, num_components, type, normalized, stride, offset);
     glEnableVertexAttribArray(layout);
     VBO::Unbind();
 }
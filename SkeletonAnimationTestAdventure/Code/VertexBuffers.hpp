@@ -13,8 +13,9 @@
 
 #include "Vertices.hpp"
 
-using Vertices = std::vector<Vertex>;
-using Indices  = std::variant<
+using Vertices        = std::vector<Vertex>;
+using CompactVertices = std::vector<CompactVertex>;
+using Indices         = std::variant<
      std::vector<uint8_t>,
      std::vector<uint16_t>,
      std::vector<uint32_t>>;
@@ -25,12 +26,14 @@ public:
     ~VBO();
 
     void Create(const std::vector<Vertex>& vertices);
+    void Create(const std::vector<CompactVertex>& vertices);
+    void Create(const void* data, size_t size);
 
     void        Bind() const;
     static void Unbind();
 
 private:
-    GLuint m_index;
+    GLuint m_index{ 0 }; // 0 until Create(), deleting it is a no-op
 };
 
 class VAO {
@@ -40,7 +43,7 @@ public:
 
     void Create();
 
-    static void LinkAttrib(VBO& vbo, GLuint layout, GLuint num_components, GLenum type, GLsizeiptr stride, void* offset);
+    static void LinkAttrib(VBO& vbo, GLuint layout, GLuint num_components, GLenum type, GLsizeiptr stride, void* offset, GLboolean normalized = GL_FALSE);
 
     void        Bind() const;
     static void Unbind();
@@ -3,6 +3,66 @@
 #include <Volk/volk.h>
 
 #pragma pack(push, 1)
+// split layout : one buffer per stream, a depth-only pass binds POSITION_STREAM ( + SKIN_STREAM when skinned ) only
+enum VertexStream : uint32_t {
+    POSITION_STREAM = 0, // Vertex::position / CompactVertex::position
+    SKIN_STREAM     = 1, // VertexSkin / CompactVertexSkin
+    SHADING_STREAM  = 2, // VertexShading / CompactVertexShading
+};
+
+struct VertexSkin {
+    glm::u16vec4 joints;
+    glm::vec4    weights;
+
+    VertexSkin()  = default;
+    ~VertexSkin() = default;
+};
+
+struct VertexShading {
+    glm::vec3 normal;
+    glm::vec2 texture_coord;
+    glm::vec4 tangent;
+
+    VertexShading()  = default;
+    ~VertexShading() = default;
+};
+
+struct CompactVertexSkin {
+    glm::u8vec4 joints;
+    glm::u8vec4 weights;
+
+    CompactVertexSkin()  = default;
+    ~CompactVertexSkin() = default;
+};
+
+struct CompactVertexShading {
+    glm::i16vec2 normal;
+    glm::i16vec2 tangent;
+    glm::u16vec2 texture_coord;
+
+    CompactVertexShading()  = default;
+    ~CompactVertexShading() = default;
+};
+
+inline VkVertexInputBindingDescription makeVertexBinding(uint32_t binding, uint32_t stride) {
+    VkVertexInputBindingDescription binding_description{};
+    binding_description.binding   = binding;
+    binding_description.stride    = stride;
+    binding_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return binding_description;
+}
+
+inline VkVertexInputAttributeDescription makeVertexAttribute(uint32_t location, uint32_t binding, VkFormat format, uint32_t offset) {
+    VkVertexInputAttributeDescription attribute_description{};
+    attribute_description.binding  = binding;
+    attribute_description.location = location;
+    attribute_description.format   = format;
+    attribute_description.offset   = offset;
+
+    return attribute_description;
+}
+
 struct Vertex {
     glm::vec3    position;
     glm::vec3    normal;
@@ -56,7 +116,101 @@ struct Vertex {
         return attribute_descriptions;
     }
 
+    // split layout, same locations. A depth-only pipeline takes the first 2 bindings and the first 3 attributes
+    // ( position, joints, weights ), or just the first of each for meshes without skinning
+    static std::array<VkVertexInputBindingDescription, 3> getStreamBindingDescriptions() {
+        return { makeVertexBinding(POSITION_STREAM, sizeof(glm::vec3)),
+                 makeVertexBinding(SKIN_STREAM, sizeof(VertexSkin)),
+                 makeVertexBinding(SHADING_STREAM, sizeof(VertexShading)) };
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 6> getStreamAttributeDescriptions() {
+        return { makeVertexAttribute(0, POSITION_STREAM, VK_FORMAT_R32G32B32_SFLOAT, 0),
+                 makeVertexAttribute(3, SKIN_STREAM, VK_FORMAT_R16G16B16A16_UINT, offsetof(VertexSkin, joints)),
+                 makeVertexAttribute(4, SKIN_STREAM, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(VertexSkin, weights)),
+                 makeVertexAttribute(1, SHADING_STREAM, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexShading, normal)),
+                 makeVertexAttribute(2, SHADING_STREAM, VK_FORMAT_R32G32_SFLOAT, offsetof(VertexShading, texture_coord)),
+                 makeVertexAttribute(5, SHADING_STREAM, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(VertexShading, tangent)) };
+    }
+
     Vertex()  = default;
     ~Vertex() = default;
 };
-#pragma pack(pop)
\ No newline at end of file
+
+// compact form of Vertex, 28 bytes instead of 72. Decoded by the vertex input ( normalized formats ) and default.vert
+// positions are relative to the bounds of their primitive : position = offset + unorm16 * scale
+struct CompactVertex {
+    glm::u16vec4 position;      // unorm16 xyz, w - tangent sign ( 0 : -1, 65535 : +1 )
+    glm::i16vec2 normal;        // snorm16 octahedral
+    glm::i16vec2 tangent;       // snorm16 octahedral
+    glm::u16vec2 texture_coord; // half float
+    glm::u8vec4  joints;
+    glm::u8vec4  weights;       // unorm8, summing to 255
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription binding_description{};
+        binding_description.binding   = 0;
+        binding_description.stride    = sizeof(CompactVertex);
+        binding_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return binding_description;
+    }
+
+    // same locations as Vertex
+    static std::array<VkVertexInputAttributeDescription, 6> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 6> attribute_descriptions{};
+
+        attribute_descriptions[0].binding  = 0;
+        attribute_descriptions[0].location = 0;
+        attribute_descriptions[0].format   = VK_FORMAT_R16G16B16A16_UNORM;
+        attribute_descriptions[0].offset   = offsetof(CompactVertex, position);
+
+        attribute_descriptions[1].binding  = 0;
+        attribute_descriptions[1].location = 1;
+        attribute_descriptions[1].format   = VK_FORMAT_R16G16_SNORM;
+        attribute_descriptions[1].offset   = offsetof(CompactVertex, normal);
+
+        attribute_descriptions[2].binding  = 0;
+        attribute_descriptions[2].location = 2;
+        attribute_descriptions[2].format   = VK_FORMAT_R16G16_SFLOAT;
+        attribute_descriptions[2].offset   = offsetof(CompactVertex, texture_coord);
+
+        attribute_descriptions[3].binding  = 0;
+        attribute_descriptions[3].location = 3;
+        attribute_descriptions[3].format   = VK_FORMAT_R8G8B8A8_UINT;
+        attribute_descriptions[3].offset   = offsetof(CompactVertex, joints);
+
+        attribute_descriptions[4].binding  = 0;
+        attribute_descriptions[4].location = 4;
+        attribute_descriptions[4].format   = VK_FORMAT_R8G8B8A8_UNORM;
+        attribute_descriptions[4].offset   = offsetof(CompactVertex, weights);
+
+        attribute_descriptions[5].binding  = 0;
+        attribute_descriptions[5].location = 5;
+        attribute_descriptions[5].format   = VK_FORMAT_R16G16_SNORM;
+        attribute_descriptions[5].offset   = offsetof(CompactVertex, tangent);
+
+        return attribute_descriptions;
+    }
+
+    // split layout, ordered like Vertex::getStreamAttributeDescriptions
+    static std::array<VkVertexInputBindingDescription, 3> getStreamBindingDescriptions() {
+        return { makeVertexBinding(POSITION_STREAM, sizeof(glm::u16vec4)),
+                 makeVertexBinding(SKIN_STREAM, sizeof(CompactVertexSkin)),
+                 makeVertexBinding(SHADING_STREAM, sizeof(CompactVertexShading)) };
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 6> getStreamAttributeDescriptions() {
+        return { makeVertexAttribute(0, POSITION_STREAM, VK_FORMAT_R16G16B16A16_UNORM, 0),
+                 makeVertexAttribute(3, SKIN_STREAM, VK_FORMAT_R8G8B8A8_UINT, offsetof(CompactVertexSkin, joints)),
+                 makeVertexAttribute(4, SKIN_STREAM, VK_FORMAT_R8G8B8A8_UNORM, offsetof(CompactVertexSkin, weights)),
+                 makeVertexAttribute(1, SHADING_STREAM, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertexShading, normal)),
+                 makeVertexAttribute(2, SHADING_STREAM, VK_FORMAT_R16G16_SFLOAT, offsetof(CompactVertexShading, texture_coord)),
+                 makeVertexAttribute(5, SHADING_STREAM, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertexShading, tangent)) };
+    }
+
+    CompactVertex()  = default;
+    ~CompactVertex() = default;
+};
+static_assert(sizeof(CompactVertex) == 28);
+#pragma pack(pop)
@@ -125,8 +125,13 @@ void VulkanDeviceManager::CreateLogicalDevice() {
         queue_create_infos.push_back(queue_create_info);
     }
 
+    VkPhysicalDeviceFeatures supported_features{};
+    vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supported_features);
+    m_BlockCompression = supported_features.textureCompressionBC != 0U; // optional, the textures stay RGBA8 without it
+
     VkPhysicalDeviceFeatures device_features{};
-    device_features.samplerAnisotropy = VK_TRUE;
+    device_features.samplerAnisotropy    = VK_TRUE;
+    device_features.textureCompressionBC = m_BlockCompression ? VK_TRUE : VK_FALSE;
 
     VkDeviceCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -739,6 +744,14 @@ void VulkanDeviceManager::copyBufferToImage(VkBuffer buffer, VkImage image, uint
     endSingleTimeCommands(command_buffer);
 }
 
+void VulkanDeviceManager::copyBufferToImage(VkBuffer buffer, VkImage image, std::span<const VkBufferImageCopy> regions) {
+    VkCommandBuffer command_buffer = beginSingleTimeCommands();
+
+    vkCmdCopyBufferToImage(command_buffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+    endSingleTimeCommands(command_buffer);
+}
+
 VkResult VulkanDeviceManager::CreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* p_create_info, const VkAllocationCallbacks* p_allocator, VkDebugUtilsMessengerEXT* p_debug_messenger) {
     auto func = (PFN_vkCreateDebugUtilsMessengerEXT) vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
     if (func != nullptr) {
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <optional>
 #include <array>
+#include <span>
 
 #define VK_NO_PROTOTYPES
 
@@ -73,6 +74,7 @@ public:
     VkDevice              getDevice() const noexcept { return m_Device; }
     VkPhysicalDevice      getPhysicalDevice() const noexcept { return m_PhysicalDevice; }
     VkSampleCountFlagBits getMSAASamples() const noexcept { return m_MSAA_Samples; }
+    bool                  hasBlockCompression() const noexcept { return m_BlockCompression; } // textureCompressionBC enabled
 
 public:
     static QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface);
@@ -86,6 +88,7 @@ public:
     void                      createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& buffer_memory);
     void                      transitionImageLayout(VkImage image, VkFormat format, VkImageLayout old_layout, VkImageLayout new_layout, uint32_t mip_levels);
     void                      copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+    void                      copyBufferToImage(VkBuffer buffer, VkImage image, std::span<const VkBufferImageCopy> regions); // one submit, e.g. every mip level
 
 private:
     static std::vector<const char*> getRequiredExtensions();
@@ -120,6 +123,8 @@ private:
 
     VkSampleCountFlagBits m_MSAA_Samples = VK_SAMPLE_COUNT_1_BIT;
 
+    bool m_BlockCompression = false;
+
     VkQueue m_GraphicsQueue{};
     VkQueue m_PresentQueue{};
 
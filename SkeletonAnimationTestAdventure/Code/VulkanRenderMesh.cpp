@@ -5,6 +5,8 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 
 #include "VulkanDeviceManager.hpp"
+#include "MipGenerator.hpp"
+#include "TextureCompressor.hpp"
 #include "PathManager.hpp"
 
 void VulkanRenderMesh::Release() {
@@ -57,161 +59,93 @@ void VulkanRenderMesh::Initialize(VulkanDeviceManager* device_manager) {
 }
 
 void VulkanRenderMesh::createTextureImage() {
-    int          texture_width    = 0;
-    int          texture_height   = 0;
-    int          texture_channels = 0;
-    stbi_uc*     pixels           = stbi_load(m_TexturePath.string().c_str(), &texture_width, &texture_height, &texture_channels, STBI_rgb_alpha);
-    VkDeviceSize image_size       = texture_width * texture_height * 4;
-    m_MipLevels                   = static_cast<uint32_t>(std::floor(std::log2(std::max(texture_width, texture_height)))) + 1;
+    int      texture_width    = 0;
+    int      texture_height   = 0;
+    int      texture_channels = 0;
+    stbi_uc* pixels           = stbi_load(m_TexturePath.string().c_str(), &texture_width, &texture_height, &texture_channels, STBI_rgb_alpha);
 
     if (pixels == nullptr) {
         throw std::runtime_error(std::string("ERROR : Failed to load texture image\nPath : ") + m_TexturePath.string());
     }
 
+    // the whole chain is filtered on the CPU ( gamma-correct ) and copied in one go, no blits on the GPU
+    auto width  = static_cast<unsigned int>(texture_width);
+    auto height = static_cast<unsigned int>(texture_height);
+    m_MipLevels = MipGenerator::getLevelCount(width, height);
+
+    VkDeviceSize               image_size = MipGenerator::getChainSize(width, height, 4, m_MipLevels);
+    std::vector<unsigned char> chain(image_size);
+    memcpy(chain.data(), pixels, static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    MipOptions mip_options{};
+    mip_options.srgb = true; // VK_FORMAT_R8G8B8A8_SRGB
+    MipGenerator::generate(chain.data(), width, height, 4, m_MipLevels, mip_options);
+
+    // BC7 when the device samples it : a quarter of the memory, the levels are compressed one by one
+    std::vector<VkDeviceSize> offsets(m_MipLevels);
+    for (uint32_t level = 0; level < m_MipLevels; level++) {
+        offsets[level] = MipGenerator::getLevelOffset(width, height, 4, level);
+    }
+    if (p_DeviceManager->hasBlockCompression()) {
+        m_TextureFormat = VK_FORMAT_BC7_SRGB_BLOCK;
+
+        std::vector<unsigned char> blocks{};
+        for (uint32_t level = 0; level < m_MipLevels; level++) {
+            unsigned int level_width  = MipGenerator::getLevelSize(width, level);
+            unsigned int level_height = MipGenerator::getLevelSize(height, level);
+
+            offsets[level] = blocks.size();
+            blocks.resize(blocks.size() + TextureCompressor::getLevelSize(BlockFormat::BC7, level_width, level_height));
+            TextureCompressor::compress(blocks.data() + offsets[level], chain.data() + MipGenerator::getLevelOffset(width, height, 4, level), level_width, level_height, 4, BlockFormat::BC7, true);
+        }
+        chain      = std::move(blocks);
+        image_size = chain.size();
+    }
+
     VkBuffer       staging_buffer        = nullptr;
     VkDeviceMemory staging_buffer_memory = nullptr;
     p_DeviceManager->createBuffer(image_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging_buffer, staging_buffer_memory);
 
     void* data = nullptr;
     vkMapMemory(p_DeviceManager->getDevice(), staging_buffer_memory, 0, image_size, 0, &data);
-    memcpy(data, pixels, static_cast<size_t>(image_size));
+    memcpy(data, chain.data(), static_cast<size_t>(image_size));
     vkUnmapMemory(p_DeviceManager->getDevice(), staging_buffer_memory);
 
-    stbi_image_free(pixels);
-
     p_DeviceManager->createImage(
         texture_width,
         texture_height,
         m_MipLevels,
         VK_SAMPLE_COUNT_1_BIT,
-        VK_FORMAT_R8G8B8A8_SRGB,
+        m_TextureFormat,
         VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         m_TextureImage,
         m_TextureImageMemory);
 
-    p_DeviceManager->transitionImageLayout(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
-    p_DeviceManager->copyBufferToImage(staging_buffer, m_TextureImage, static_cast<uint32_t>(texture_width), static_cast<uint32_t>(texture_height));
-    //transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-
-    vkDestroyBuffer(p_DeviceManager->getDevice(), staging_buffer, nullptr);
-    vkFreeMemory(p_DeviceManager->getDevice(), staging_buffer_memory, nullptr);
-
-    generateMipmaps(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, texture_width, texture_height, m_MipLevels);
-}
-
-void VulkanRenderMesh::generateMipmaps(VkImage image, VkFormat image_format, int32_t texture_width, int32_t texture_height, uint32_t mip_levels) {
-    // Check if image format supports linear blitting
-    VkFormatProperties format_properties;
-    vkGetPhysicalDeviceFormatProperties(p_DeviceManager->getPhysicalDevice(), image_format, &format_properties);
-
-    if ((format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) == 0U) {
-        throw std::runtime_error("ERROR : Texture image format does not support linear blitting");
+    std::vector<VkBufferImageCopy> regions(m_MipLevels);
+    for (uint32_t level = 0; level < m_MipLevels; level++) {
+        VkBufferImageCopy& region              = regions[level];
+        region.bufferOffset                    = offsets[level];
+        region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel       = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount     = 1;
+        region.imageOffset                     = { 0, 0, 0 };
+        region.imageExtent                     = { MipGenerator::getLevelSize(width, level), MipGenerator::getLevelSize(height, level), 1 };
     }
 
-    VkCommandBuffer command_buffer = p_DeviceManager->beginSingleTimeCommands();
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.image                           = image;
-    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount     = 1;
-    barrier.subresourceRange.levelCount     = 1;
-
-    int32_t mip_width  = texture_width;
-    int32_t mip_height = texture_height;
-
-    for (uint32_t i = 1; i < mip_levels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout                     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout                     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcAccessMask                 = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask                 = VK_ACCESS_TRANSFER_READ_BIT;
-
-        vkCmdPipelineBarrier(command_buffer,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             0,
-                             0,
-                             nullptr,
-                             0,
-                             nullptr,
-                             1,
-                             &barrier);
-
-        VkImageBlit blit{};
-        blit.srcOffsets[0]                 = { 0, 0, 0 };
-        blit.srcOffsets[1]                 = { mip_width, mip_height, 1 };
-        blit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.srcSubresource.mipLevel       = i - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount     = 1;
-        blit.dstOffsets[0]                 = { 0, 0, 0 };
-        blit.dstOffsets[1]                 = { mip_width > 1 ? mip_width / 2 : 1, mip_height > 1 ? mip_height / 2 : 1, 1 };
-        blit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.dstSubresource.mipLevel       = i;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount     = 1;
-
-        vkCmdBlitImage(command_buffer,
-                       image,
-                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                       image,
-                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                       1,
-                       &blit,
-                       VK_FILTER_LINEAR);
-
-        barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        vkCmdPipelineBarrier(command_buffer,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                             0,
-                             0,
-                             nullptr,
-                             0,
-                             nullptr,
-                             1,
-                             &barrier);
-
-        if (mip_width > 1) {
-            mip_width /= 2;
-        }
-        if (mip_height > 1) {
-            mip_height /= 2;
-        }
-    }
+    p_DeviceManager->transitionImageLayout(m_TextureImage, m_TextureFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
+    p_DeviceManager->copyBufferToImage(staging_buffer, m_TextureImage, regions);
+    p_DeviceManager->transitionImageLayout(m_TextureImage, m_TextureFormat, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_MipLevels);
 
-    barrier.subresourceRange.baseMipLevel = mip_levels - 1;
-    barrier.oldLayout                     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout                     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask                 = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask                 = VK_ACCESS_SHADER_READ_BIT;
-
-    vkCmdPipelineBarrier(command_buffer,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                         0,
-                         0,
-                         nullptr,
-                         0,
-                         nullptr,
-                         1,
-                         &barrier);
-
-    p_DeviceManager->endSingleTimeCommands(command_buffer);
+    vkDestroyBuffer(p_DeviceManager->getDevice(), staging_buffer, nullptr);
+    vkFreeMemory(p_DeviceManager->getDevice(), staging_buffer_memory, nullptr);
 }
 
 void VulkanRenderMesh::createTextureImageView() {
-    m_TextureImageView = p_DeviceManager->createImageView(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, m_MipLevels);
+    m_TextureImageView = p_DeviceManager->createImageView(m_TextureImage, m_TextureFormat, VK_IMAGE_ASPECT_COLOR_BIT, m_MipLevels);
 }
 
 void VulkanRenderMesh::createTextureSampler() {
@@ -39,12 +39,11 @@ private:
     void createIndexBuffer();
     void createUniformBuffers();
 
-    void generateMipmaps(VkImage image, VkFormat image_format, int32_t texture_width, int32_t texture_height, uint32_t mip_levels);
-
 private:
     VulkanDeviceManager* p_DeviceManager = nullptr;
 
-    uint32_t       m_MipLevels = 0;
+    uint32_t       m_MipLevels     = 0;
+    VkFormat       m_TextureFormat = VK_FORMAT_R8G8B8A8_SRGB;
     VkImage        m_TextureImage{};
     VkDeviceMemory m_TextureImageMemory{};
     VkImageView    m_TextureImageView{};
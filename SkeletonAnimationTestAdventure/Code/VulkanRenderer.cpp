@@ -42,7 +42,13 @@ void VulkanRenderer::Initialize(GLFWwindow* p_window) {
     m_deviceManager.CreateSyncObjects();
 }
 
-void VulkanRenderer::loadModel(const Model& model) {
+void VulkanRenderer::loadModel(Model& model) {
+}
+
+void VulkanRenderer::updateModel(Model& model, const ModelStreamUpdate& update) {
+}
+
+void VulkanRenderer::unloadModel(const Model& model) {
 }
 
 void VulkanRenderer::onResize(uint32_t width, uint32_t height) {
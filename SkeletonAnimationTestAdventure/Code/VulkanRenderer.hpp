@@ -19,7 +19,9 @@ public:
     void Release() override;
     void Initialize(GLFWwindow* p_window) override;
 
-    void loadModel(const Model& model) override;
+    void loadModel(Model& model) override;
+    void updateModel(Model& model, const ModelStreamUpdate& update) override;
+    void unloadModel(const Model& model) override;
 
     void onResize(uint32_t width, uint32_t height) override;
 
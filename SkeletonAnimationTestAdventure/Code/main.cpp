@@ -1,4 +1,8 @@
+#include "LodSelection.hpp"
+#include "ModelInstance.hpp"
+#include "ModelStream.hpp"
 #include "OpenGLRenderer.hpp"
+#include "TextureStreamer.hpp"
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -30,10 +34,16 @@ int main() {
     shader.Initialize(L"F:\\Windows\\Desktop\\SkeletonAnimationTestAdventure\\Files\\Shaders\\default");
     shader.Bind();
 
-    Model model{};
-    model.Initialize(L"F:\\Windows\\Desktop\\SkeletonAnimationTestAdventure\\Files\\Models\\rifle-awp-weapon-model-cs2-original\\source\\AWP.glb");
+    // low mips first, the finer ones as the camera gets close
+    TextureStreamer* texture_streamer = renderer->enableTextureStreaming(TextureStreamingOptions{});
 
-    renderer->loadModel(model);
+    // drawn from placeholders while the stream fills it
+    Model            model{};
+    ModelInstance    model_instance{}; // pose and playback, the asset stays in model
+    ModelStream      model_stream{};
+    ModelLoadOptions load_options{};
+    load_options.generate_mipmaps = true; // the streamer uploads the CPU levels
+    model_stream.Initialize(L"F:\\Windows\\Desktop\\SkeletonAnimationTestAdventure\\Files\\Models\\rifle-awp-weapon-model-cs2-original\\source\\AWP.glb", load_options);
 
     RenderCommand render_command{};
     render_command.model = &model;
@@ -41,15 +51,34 @@ int main() {
     RenderView render_view{};
     render_view.camera = &camera;
 
+    double last_frame_time = glfwGetTime();
     while (glfwWindowShouldClose(window) == 0) {
+        ModelStreamUpdate model_update = model_stream.Update(model);
+        if (!model_update.empty()) {
+            renderer->updateModel(model, model_update);
+        }
+        if (model_update.hierarchy) {
+            model_instance.Initialize(model.getAsset());
+            model_instance.playAnimation(0);
+        }
+
+        double frame_time = glfwGetTime();
+        model_instance.Update(static_cast<float>(frame_time - last_frame_time));
+        last_frame_time = frame_time;
+
         camera.Inputs(window);
         camera.UpdateMatrix(70.0F, 0.01F, 1000.0F);
 
+        if (texture_streamer != nullptr) {
+            model_instance.requestTextures(*texture_streamer, LodSelection::makeView(camera));
+            texture_streamer->Update();
+        }
+
         /*shader.setUniformVec3("u_lightDirection", glm::vec3(1, 1, 1));
         shader.setUniformVec3("u_lightColor", glm::vec3(30, 30, 30));
         shader.setUniformVec3("u_cameraPosition", camera.getPosition());
 
-        model.Draw(shader, glfwGetTime());*/
+        model_instance.Draw(shader);*/
 
         shader.Bind();
 